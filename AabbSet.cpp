@@ -0,0 +1,284 @@
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include "AabbSet.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AABB_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define AABB_X86 0
+#endif
+
+// GCC and Clang only emit AVX code inside functions marked for it, which is
+// what lets one binary carry every kernel; MSVC needs no marking
+#if defined(__GNUC__)
+#define AABB_TARGET(isa) __attribute__((target(isa)))
+#else
+#define AABB_TARGET(isa)
+#endif
+
+// ----- BIT HELPERS ----- //
+static inline int lowest_bit(uint32_t bits)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+static inline int count_bits(uint32_t bits)
+{
+#if defined(_MSC_VER)
+    return (int)__popcnt(bits);
+#else
+    return __builtin_popcount(bits);
+#endif
+}
+
+// ----- KERNELS ----- //
+// Each kernel tests the query against boxes [0, padded_count) and either
+// stops at the first overlap or records all of them. padded_count is a
+// multiple of AabbSet::PADDING.
+struct AabbArrays
+{
+    const float* center_x;
+    const float* center_y;
+    const float* width;
+    const float* height;
+    int padded_count;
+};
+
+typedef int (*FindFirstFunction)(const AabbArrays& boxes, float x, float y, float width, float height);
+typedef int (*FindAllFunction)(const AabbArrays& boxes, float x, float y, float width, float height, uint64_t* mask);
+
+// Overlap bits for PADDING boxes starting at first
+static inline uint32_t group_scalar(const AabbArrays& boxes, int first, float x, float y, float width, float height)
+{
+    uint32_t bits = 0;
+    for (int i = 0; i < AabbSet::PADDING; i++)
+    {
+        int box = first + i;
+        float x_distance = fabsf(x - boxes.center_x[box]) - ((width + boxes.width[box]) / 2.0f);
+        float y_distance = fabsf(y - boxes.center_y[box]) - ((height + boxes.height[box]) / 2.0f);
+        if (x_distance < 0.0f && y_distance < 0.0f) bits |= 1u << i;
+    }
+    return bits;
+}
+
+#if AABB_X86
+AABB_TARGET("sse2")
+static inline uint32_t group_sse2(const AabbArrays& boxes, int first, float x, float y, float width, float height)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f), half = _mm_set1_ps(0.5f), zero = _mm_setzero_ps();
+    const __m128 qx = _mm_set1_ps(x), qy = _mm_set1_ps(y), qw = _mm_set1_ps(width), qh = _mm_set1_ps(height);
+
+    uint32_t bits = 0;
+    for (int i = 0; i < AabbSet::PADDING; i += 4)
+    {
+        int box = first + i;
+        __m128 dx = _mm_andnot_ps(sign, _mm_sub_ps(qx, _mm_loadu_ps(boxes.center_x + box)));
+        __m128 dy = _mm_andnot_ps(sign, _mm_sub_ps(qy, _mm_loadu_ps(boxes.center_y + box)));
+        dx = _mm_sub_ps(dx, _mm_mul_ps(_mm_add_ps(qw, _mm_loadu_ps(boxes.width + box)), half));
+        dy = _mm_sub_ps(dy, _mm_mul_ps(_mm_add_ps(qh, _mm_loadu_ps(boxes.height + box)), half));
+        __m128 hit = _mm_and_ps(_mm_cmplt_ps(dx, zero), _mm_cmplt_ps(dy, zero));
+        bits |= (uint32_t)_mm_movemask_ps(hit) << i;
+    }
+    return bits;
+}
+
+AABB_TARGET("avx2")
+static inline uint32_t group_avx2(const AabbArrays& boxes, int first, float x, float y, float width, float height)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f), half = _mm256_set1_ps(0.5f), zero = _mm256_setzero_ps();
+    const __m256 qx = _mm256_set1_ps(x), qy = _mm256_set1_ps(y), qw = _mm256_set1_ps(width), qh = _mm256_set1_ps(height);
+
+    uint32_t bits = 0;
+    for (int i = 0; i < AabbSet::PADDING; i += 8)
+    {
+        int box = first + i;
+        __m256 dx = _mm256_andnot_ps(sign, _mm256_sub_ps(qx, _mm256_loadu_ps(boxes.center_x + box)));
+        __m256 dy = _mm256_andnot_ps(sign, _mm256_sub_ps(qy, _mm256_loadu_ps(boxes.center_y + box)));
+        dx = _mm256_sub_ps(dx, _mm256_mul_ps(_mm256_add_ps(qw, _mm256_loadu_ps(boxes.width + box)), half));
+        dy = _mm256_sub_ps(dy, _mm256_mul_ps(_mm256_add_ps(qh, _mm256_loadu_ps(boxes.height + box)), half));
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(dx, zero, _CMP_LT_OQ), _mm256_cmp_ps(dy, zero, _CMP_LT_OQ));
+        bits |= (uint32_t)_mm256_movemask_ps(hit) << i;
+    }
+    return bits;
+}
+
+AABB_TARGET("avx512f")
+static inline uint32_t group_avx512(const AabbArrays& boxes, int first, float x, float y, float width, float height)
+{
+    const __m512 half = _mm512_set1_ps(0.5f), zero = _mm512_setzero_ps();
+
+    __m512 dx = _mm512_abs_ps(_mm512_sub_ps(_mm512_set1_ps(x), _mm512_loadu_ps(boxes.center_x + first)));
+    __m512 dy = _mm512_abs_ps(_mm512_sub_ps(_mm512_set1_ps(y), _mm512_loadu_ps(boxes.center_y + first)));
+    dx = _mm512_sub_ps(dx, _mm512_mul_ps(_mm512_add_ps(_mm512_set1_ps(width), _mm512_loadu_ps(boxes.width + first)), half));
+    dy = _mm512_sub_ps(dy, _mm512_mul_ps(_mm512_add_ps(_mm512_set1_ps(height), _mm512_loadu_ps(boxes.height + first)), half));
+
+    __mmask16 hit = _mm512_cmp_ps_mask(dx, zero, _CMP_LT_OQ) & _mm512_cmp_ps_mask(dy, zero, _CMP_LT_OQ);
+    return (uint32_t)hit;
+}
+#endif
+
+// The two loops over the groups, compiled once per kernel so the group test
+// is inlined into code built for the same instruction set
+#define AABB_DEFINE_LOOPS(kernel, target)                                                                      \
+    target static int find_first_##kernel(const AabbArrays& boxes, float x, float y, float width, float height)  \
+    {                                                                                                          \
+        for (int first = 0; first < boxes.padded_count; first += AabbSet::PADDING)                             \
+        {                                                                                                      \
+            uint32_t bits = group_##kernel(boxes, first, x, y, width, height);                                 \
+            if (bits) return first + lowest_bit(bits);                                                         \
+        }                                                                                                      \
+        return -1;                                                                                             \
+    }                                                                                                          \
+    target static int find_all_##kernel(const AabbArrays& boxes, float x, float y, float width, float height,    \
+        uint64_t* mask)                                                                                        \
+    {                                                                                                          \
+        int hits = 0;                                                                                          \
+        for (int first = 0; first < boxes.padded_count; first += AabbSet::PADDING)                             \
+        {                                                                                                      \
+            uint32_t bits = group_##kernel(boxes, first, x, y, width, height);                                 \
+            if (!bits) continue;                                                                               \
+            mask[first / 64] |= (uint64_t)bits << (first % 64);                                                \
+            hits += count_bits(bits);                                                                          \
+        }                                                                                                      \
+        return hits;                                                                                           \
+    }
+
+AABB_DEFINE_LOOPS(scalar, )
+#if AABB_X86
+AABB_DEFINE_LOOPS(sse2, AABB_TARGET("sse2"))
+AABB_DEFINE_LOOPS(avx2, AABB_TARGET("avx2"))
+AABB_DEFINE_LOOPS(avx512, AABB_TARGET("avx512f"))
+
+static const FindFirstFunction FIND_FIRST[AABB_KERNEL_COUNT] = { find_first_scalar, find_first_sse2, find_first_avx2, find_first_avx512 };
+static const FindAllFunction FIND_ALL[AABB_KERNEL_COUNT] = { find_all_scalar, find_all_sse2, find_all_avx2, find_all_avx512 };
+#else
+static const FindFirstFunction FIND_FIRST[AABB_KERNEL_COUNT] = { find_first_scalar, find_first_scalar, find_first_scalar, find_first_scalar };
+static const FindAllFunction FIND_ALL[AABB_KERNEL_COUNT] = { find_all_scalar, find_all_scalar, find_all_scalar, find_all_scalar };
+#endif
+
+// ----- DISPATCH ----- //
+static AabbKernel detect_kernel()
+{
+#if AABB_X86 && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return AABB_AVX512;
+    if (__builtin_cpu_supports("avx2")) return AABB_AVX2;
+    if (__builtin_cpu_supports("sse2")) return AABB_SSE2;
+    return AABB_SCALAR;
+#elif AABB_X86 && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    // AVX state has to be enabled by the OS as well as present in the CPU
+    __cpuid(info, 1);
+    bool has_sse2 = (info[3] >> 26) & 1;
+    bool os_saves_avx = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && (_xgetbv(0) & 0x6) == 0x6;
+    if (os_saves_avx && max_leaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        if (((info[1] >> 16) & 1) && (_xgetbv(0) & 0xE6) == 0xE6) return AABB_AVX512;
+        if ((info[1] >> 5) & 1) return AABB_AVX2;
+    }
+    return has_sse2 ? AABB_SSE2 : AABB_SCALAR;
+#else
+    return AABB_SCALAR;
+#endif
+}
+
+AabbKernel get_best_aabb_kernel()
+{
+    static const AabbKernel best = detect_kernel();
+    return best;
+}
+
+static std::atomic<int> g_forced_kernel(-1);
+
+AabbKernel get_aabb_kernel()
+{
+    int forced = g_forced_kernel.load(std::memory_order_relaxed);
+    return forced >= 0 ? (AabbKernel)forced : get_best_aabb_kernel();
+}
+
+bool set_aabb_kernel(AabbKernel kernel)
+{
+    bool supported = kernel >= AABB_SCALAR && kernel <= get_best_aabb_kernel();
+    g_forced_kernel.store(supported ? (int)kernel : -1, std::memory_order_relaxed);
+    return supported;
+}
+
+const char* get_aabb_kernel_name(AabbKernel kernel)
+{
+    static const char* const NAMES[AABB_KERNEL_COUNT] = { "scalar", "sse2", "avx2", "avx512" };
+    return kernel >= AABB_SCALAR && kernel < AABB_KERNEL_COUNT ? NAMES[kernel] : "unknown";
+}
+
+// ----- AABB SET ----- //
+int AabbSet::add(glm::vec3 position, float width, float height)
+{
+    int index = m_count++;
+
+    // Grow by a whole group; padding boxes have a NaN centre, and every
+    // comparison against NaN is false
+    if ((int)m_center_x.size() < m_count)
+    {
+        size_t size = m_center_x.size() + PADDING;
+        m_center_x.resize(size, NAN);
+        m_center_y.resize(size, NAN);
+        m_width.resize(size, 0.0f);
+        m_height.resize(size, 0.0f);
+    }
+
+    set(index, position, width, height);
+    return index;
+}
+
+void AabbSet::set(int index, glm::vec3 position, float width, float height)
+{
+    m_center_x[index] = position.x;
+    m_center_y[index] = position.y;
+    m_width[index] = width;
+    m_height[index] = height;
+}
+
+void AabbSet::clear()
+{
+    m_center_x.clear();
+    m_center_y.clear();
+    m_width.clear();
+    m_height.clear();
+    m_count = 0;
+}
+
+void AabbSet::reserve(int capacity)
+{
+    size_t size = (capacity + PADDING - 1) / PADDING * PADDING;
+    m_center_x.reserve(size);
+    m_center_y.reserve(size);
+    m_width.reserve(size);
+    m_height.reserve(size);
+}
+
+int AabbSet::find_first(glm::vec3 position, float width, float height) const
+{
+    AabbArrays boxes = { m_center_x.data(), m_center_y.data(), m_width.data(), m_height.data(), (int)m_center_x.size() };
+    return FIND_FIRST[get_aabb_kernel()](boxes, position.x, position.y, width, height);
+}
+
+int AabbSet::find_all(glm::vec3 position, float width, float height, uint64_t* mask) const
+{
+    AabbArrays boxes = { m_center_x.data(), m_center_y.data(), m_width.data(), m_height.data(), (int)m_center_x.size() };
+    memset(mask, 0, get_mask_words() * sizeof(uint64_t));
+    return FIND_ALL[get_aabb_kernel()](boxes, position.x, position.y, width, height, mask);
+}
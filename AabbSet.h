@@ -0,0 +1,56 @@
+#ifndef AABB_SET_H
+#define AABB_SET_H
+
+#include <cstdint>
+#include <vector>
+#include "glm/glm.hpp"
+
+enum AabbKernel { AABB_SCALAR, AABB_SSE2, AABB_AVX2, AABB_AVX512, AABB_KERNEL_COUNT };
+
+// Boxes stored as separate arrays of centres and sizes, so one query box
+// can be tested against 16 (AVX-512), 8 (AVX2) or 4 (SSE2) of them per
+// instruction. Every test is the same arithmetic as aabb_overlap, so all
+// kernels agree with it exactly.
+//
+// The kernel is picked once, at first use, from what the CPU supports; the
+// arrays are padded with boxes that overlap nothing, so no kernel needs a
+// scalar tail.
+class AabbSet
+{
+private:
+    std::vector<float> m_center_x, m_center_y, m_width, m_height;
+    int m_count = 0;
+
+public:
+    static constexpr int PADDING = 16;  // arrays are a multiple of this long
+
+    // ----- METHODS ----- //
+    int  add(glm::vec3 position, float width, float height);
+    void set(int index, glm::vec3 position, float width, float height);
+    void clear();
+    void reserve(int capacity);
+
+    // Lowest index of a box overlapping the query box, or -1
+    int find_first(glm::vec3 position, float width, float height) const;
+
+    // Sets bit i % 64 of mask[i / 64] for every box i that overlaps and
+    // clears the rest; mask needs get_mask_words() entries. Returns the
+    // number of overlapping boxes.
+    int find_all(glm::vec3 position, float width, float height, uint64_t* mask) const;
+
+    // ----- GETTERS ----- //
+    int get_count()      const { return m_count; }
+    int get_mask_words() const { return (m_count + 63) / 64; }
+};
+
+// The best kernel this CPU runs, detected on the first call
+AabbKernel get_best_aabb_kernel();
+
+// Kernel every AabbSet uses; defaults to get_best_aabb_kernel(). Forcing a
+// kernel the CPU cannot run falls back to the best one and returns false.
+AabbKernel get_aabb_kernel();
+bool       set_aabb_kernel(AabbKernel kernel);
+
+const char* get_aabb_kernel_name(AabbKernel kernel);
+
+#endif // AABB_SET_H
@@ -0,0 +1,40 @@
+#include <new>
+#include "Arena.h"
+
+// Every allocation starts at least this aligned, so the pools carved out
+// of an arena never straddle cache lines more than they have to
+constexpr size_t ARENA_ALIGNMENT = 64;
+
+bool Arena::initialise(size_t capacity)
+{
+    shutdown();
+
+    capacity = (capacity + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    m_memory = (unsigned char*)::operator new(capacity, std::align_val_t(ARENA_ALIGNMENT), std::nothrow);
+    if (!m_memory) return false;
+
+    m_capacity = capacity;
+    m_used = 0;
+    m_high_water = 0;
+    return true;
+}
+
+void Arena::shutdown()
+{
+    if (m_memory) ::operator delete(m_memory, std::align_val_t(ARENA_ALIGNMENT));
+    m_memory = nullptr;
+    m_capacity = 0;
+    m_used = 0;
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment)
+{
+    if (alignment < ARENA_ALIGNMENT) alignment = ARENA_ALIGNMENT;
+
+    size_t start = (m_used + alignment - 1) / alignment * alignment;
+    if (start + bytes > m_capacity) return nullptr;
+
+    m_used = start + bytes;
+    if (m_used > m_high_water) m_high_water = m_used;
+    return m_memory + start;
+}
@@ -0,0 +1,38 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+
+// One block of memory handed out front to back. Nothing is freed on its
+// own: rewinding to an earlier mark releases everything allocated since in
+// one step, which is how a level's storage is thrown away on reset.
+class Arena
+{
+private:
+    unsigned char* m_memory = nullptr;
+    size_t m_capacity = 0,
+        m_used = 0,
+        m_high_water = 0;
+
+public:
+    // ----- METHODS ----- //
+    bool initialise(size_t capacity);
+    void shutdown();
+
+    // Null when the arena is full. The memory is not cleared.
+    void* allocate(size_t bytes, size_t alignment);
+
+    template <typename T>
+    T* allocate_array(int count) { return (T*)allocate(sizeof(T) * count, alignof(T)); }
+
+    // Releases everything allocated after mark was taken
+    size_t get_mark() const { return m_used; }
+    void   rewind(size_t mark = 0) { m_used = mark; }
+
+    // ----- GETTERS ----- //
+    size_t get_capacity()   const { return m_capacity; }
+    size_t get_used()       const { return m_used; }
+    size_t get_high_water() const { return m_high_water; }
+};
+
+#endif // ARENA_H
@@ -0,0 +1,139 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <chrono>
+#include "AssetLoader.h"
+#include "GlState.h"
+
+static double milliseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void AssetLoader::initialise(int thread_count)
+{
+    if (thread_count < 1) thread_count = 1;
+
+    m_stopping = false;
+    m_stats = {};
+    m_stats.thread_count = thread_count;
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        m_threads.emplace_back(&AssetLoader::work, this);
+    }
+}
+
+void AssetLoader::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_pending.clear();
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) thread.join();
+    m_threads.clear();
+    m_finished.clear();
+}
+
+void AssetLoader::submit(AssetWorkFunction work, AssetReadyFunction ready, void* context)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back({ work, ready, context, false });
+        m_stats.submitted++;
+    }
+    m_wake.notify_one();
+}
+
+void AssetLoader::work()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_wake.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+        if (m_stopping) return;
+
+        Task task = m_pending.front();
+        m_pending.pop_front();
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        task.ok = task.work(task.context);
+        double elapsed = milliseconds_since(start);
+
+        lock.lock();
+        m_stats.work_ms += elapsed;
+        m_finished.push_back(task);
+    }
+}
+
+int AssetLoader::pump(double budget_ms)
+{
+    auto start = std::chrono::steady_clock::now();
+    int count = 0;
+
+    while (count == 0 || milliseconds_since(start) < budget_ms)
+    {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_finished.empty()) break;
+
+            task = m_finished.front();
+            m_finished.pop_front();
+        }
+
+        // Outside the lock: a ready callback is free to submit more work
+        auto ready_start = std::chrono::steady_clock::now();
+        task.ready(task.ok, task.context);
+        double elapsed = milliseconds_since(ready_start);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.completed++;
+        if (!task.ok) m_stats.failed++;
+        m_stats.ready_ms += elapsed;
+        if (elapsed > m_stats.longest_ready_ms) m_stats.longest_ready_ms = elapsed;
+        count++;
+    }
+
+    return count;
+}
+
+bool AssetLoader::is_idle() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats.completed == m_stats.submitted;
+}
+
+AssetLoaderStats AssetLoader::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+GLuint create_placeholder_texture(unsigned rgba)
+{
+    unsigned char pixel[4] = {
+        (unsigned char)(rgba >> 24), (unsigned char)(rgba >> 16),
+        (unsigned char)(rgba >> 8), (unsigned char)rgba
+    };
+
+    GLuint texture_id;
+    glGenTextures(1, &texture_id);
+    GlState::get().bind_texture(texture_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    return texture_id;
+}
@@ -0,0 +1,85 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpriteBatch.h"
+
+// Runs on a worker thread: file reads, decoding, packing. No GL calls.
+typedef bool (*AssetWorkFunction)(void* context);
+
+// Runs on the GL thread from pump() once the work is done; this is where
+// textures and buffers get uploaded. ok is what the work returned.
+typedef void (*AssetReadyFunction)(bool ok, void* context);
+
+struct AssetLoaderStats
+{
+    int    thread_count;
+    int    submitted;
+    int    completed;       // ready callbacks run so far
+    int    failed;
+    double work_ms;         // summed over the workers
+    double ready_ms;        // spent in ready callbacks on the GL thread
+    double longest_ready_ms;
+};
+
+// A small pool of worker threads for startup loading. Each task is a pair
+// of callbacks: the work runs on whichever worker is free, and its ready
+// callback is queued for the GL thread, which runs finished ones from
+// pump() between frames. Nothing blocks the GL thread, so the game can
+// draw placeholders while the real assets are still on their way.
+//
+// Tasks may submit further tasks from their ready callback (a pack that
+// waits for several decodes, say). Which worker runs a task, and the order
+// finished tasks reach pump(), are not deterministic.
+class AssetLoader
+{
+private:
+    struct Task
+    {
+        AssetWorkFunction  work;
+        AssetReadyFunction ready;
+        void*              context;
+        bool               ok;
+    };
+
+    std::vector<std::thread> m_threads;
+
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Task>        m_pending;      // waiting for a worker
+    std::deque<Task>        m_finished;     // waiting for pump()
+    bool m_stopping = false;
+
+    AssetLoaderStats m_stats = {};
+
+    void work();
+
+public:
+    // ----- METHODS ----- //
+    void initialise(int thread_count);
+
+    // Tasks not yet started are dropped, and so are the ready callbacks of
+    // finished ones; tasks already running are waited for
+    void shutdown();
+
+    void submit(AssetWorkFunction work, AssetReadyFunction ready, void* context);
+
+    // GL thread only. Runs ready callbacks until the budget is spent (at
+    // least one, when any are waiting) and returns how many ran.
+    int pump(double budget_ms);
+
+    // ----- GETTERS ----- //
+    // True once every submitted task has had its ready callback run
+    bool is_idle() const;
+    AssetLoaderStats get_stats() const;
+};
+
+// A 1x1 texture of one colour (0xRRGGBBAA) to draw in place of an asset
+// that is still loading
+GLuint create_placeholder_texture(unsigned rgba);
+
+#endif // ASSET_LOADER_H
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "AssetPack.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char ASSET_PACK_MAGIC[4] = { 'L', 'L', 'P', '1' };
+
+struct AssetPackHeader
+{
+    char     magic[4];
+    uint32_t entry_count;
+    uint64_t file_size;         // catches a truncated copy before anything reads past the end
+};
+
+static_assert(sizeof(AssetPackHeader) == 16, "AssetPackHeader is written to disk as is");
+
+static uint64_t align_up(uint64_t value)
+{
+    return (value + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+}
+
+// ----- READING ----- //
+bool AssetPack::open(const char* path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER file_size;
+    HANDLE mapping = NULL;
+    const void* view = NULL;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+    {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (view == NULL)
+    {
+        if (mapping != NULL) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (const unsigned char*)view;
+    m_size = (size_t)file_size.QuadPart;
+#else
+    int file = ::open(path, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(file, &info) == 0 && info.st_size > 0)
+    {
+        view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    // The mapping keeps the file alive on its own
+    ::close(file);
+    if (view == MAP_FAILED) return false;
+
+    // Ask for the whole pack up front: one large read instead of a fault
+    // (and, on a network filesystem, a round trip) per page
+    madvise(view, (size_t)info.st_size, MADV_WILLNEED);
+
+    m_data = (const unsigned char*)view;
+    m_size = (size_t)info.st_size;
+#endif
+
+    // ----- VALIDATION ----- //
+    // Everything below trusts the index, so check all of it once here
+    AssetPackHeader header;
+    bool ok = m_size >= sizeof(header);
+    if (ok)
+    {
+        memcpy(&header, m_data, sizeof(header));
+        ok = memcmp(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic)) == 0 && header.file_size == m_size &&
+            header.entry_count <= (m_size - sizeof(header)) / sizeof(AssetPackEntry);
+    }
+
+    m_entries = (const AssetPackEntry*)(m_data + sizeof(header));
+    m_entry_count = ok ? (int)header.entry_count : 0;
+
+    for (int i = 0; ok && i < m_entry_count; i++)
+    {
+        const AssetPackEntry& entry = m_entries[i];
+        ok = memchr(entry.name, '\0', AssetPackEntry::NAME_SIZE) != NULL &&
+            (i == 0 || strcmp(m_entries[i - 1].name, entry.name) < 0) &&
+            entry.offset % ASSET_PACK_ALIGNMENT == 0 && entry.offset <= m_size && entry.size <= m_size - entry.offset;
+
+        if (ok && entry.type == ASSET_TEXTURE) {
+            ok = entry.width > 0 && entry.height > 0 && entry.size == (uint64_t)entry.width * entry.height * 4;
+        }
+        else if (ok) {
+            ok = entry.type == ASSET_RAW;
+        }
+    }
+
+    if (!ok) close();
+    return ok;
+}
+
+void AssetPack::close()
+{
+    if (m_data == nullptr) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle((HANDLE)m_mapping);
+    CloseHandle((HANDLE)m_file);
+    m_file = m_mapping = nullptr;
+#else
+    munmap((void*)m_data, m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_entry_count = 0;
+}
+
+const AssetPackEntry* AssetPack::find(const char* name) const
+{
+    const AssetPackEntry* end = m_entries + m_entry_count;
+    const AssetPackEntry* entry = std::lower_bound(m_entries, end, name,
+        [](const AssetPackEntry& a, const char* b) { return strcmp(a.name, b) < 0; });
+
+    return entry != end && strcmp(entry->name, name) == 0 ? entry : nullptr;
+}
+
+// ----- WRITING ----- //
+bool AssetPackWriter::add(const char* name, AssetType type, int width, int height, const void* data, size_t size)
+{
+    if (strlen(name) >= (size_t)AssetPackEntry::NAME_SIZE) return false;
+    for (const Pending& pending : m_pending)
+    {
+        if (strcmp(pending.entry.name, name) == 0) return false;
+    }
+
+    Pending pending;
+    memset(&pending.entry, 0, sizeof(pending.entry));
+    strcpy(pending.entry.name, name);
+    pending.entry.type = type;
+    pending.entry.width = width;
+    pending.entry.height = height;
+    pending.entry.size = size;
+    pending.data.assign((const unsigned char*)data, (const unsigned char*)data + size);
+
+    m_pending.push_back(std::move(pending));
+    return true;
+}
+
+bool AssetPackWriter::add_raw(const char* name, const void* data, size_t size)
+{
+    return add(name, ASSET_RAW, 0, 0, data, size);
+}
+
+bool AssetPackWriter::add_texture(const char* name, int width, int height, const unsigned char* pixels)
+{
+    return width > 0 && height > 0 && add(name, ASSET_TEXTURE, width, height, pixels, (size_t)width * height * 4);
+}
+
+bool AssetPackWriter::add_file(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+
+    std::vector<unsigned char> data;
+    unsigned char buffer[65536];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + count);
+
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok && add_raw(path, data.data(), data.size());
+}
+
+bool AssetPackWriter::save(const char* path)
+{
+    // The reader looks names up with a binary search
+    std::sort(m_pending.begin(), m_pending.end(),
+        [](const Pending& a, const Pending& b) { return strcmp(a.entry.name, b.entry.name) < 0; });
+
+    uint64_t offset = align_up(sizeof(AssetPackHeader) + m_pending.size() * sizeof(AssetPackEntry));
+    for (Pending& pending : m_pending)
+    {
+        pending.entry.offset = offset;
+        offset = align_up(offset + pending.entry.size);
+    }
+
+    AssetPackHeader header;
+    memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+    header.entry_count = (uint32_t)m_pending.size();
+    header.file_size = offset;
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (size_t i = 0; ok && i < m_pending.size(); i++)
+    {
+        ok = fwrite(&m_pending[i].entry, sizeof(AssetPackEntry), 1, file) == 1;
+    }
+
+    // Zero padding up to each entry's page, and after the last one up to the
+    // end of its page, so the file size is what the header says
+    static const unsigned char zeros[ASSET_PACK_ALIGNMENT] = {};
+    uint64_t written = sizeof(header) + m_pending.size() * sizeof(AssetPackEntry);
+    for (size_t i = 0; ok && i <= m_pending.size(); i++)
+    {
+        uint64_t target = i < m_pending.size() ? m_pending[i].entry.offset : header.file_size;
+        ok = fwrite(zeros, 1, (size_t)(target - written), file) == target - written;
+        written = target;
+
+        if (ok && i < m_pending.size())
+        {
+            const Pending& pending = m_pending[i];
+            ok = fwrite(pending.data.data(), 1, pending.data.size(), file) == pending.data.size();
+            written += pending.data.size();
+        }
+    }
+
+    fclose(file);
+    if (!ok) remove(path);
+    return ok;
+}
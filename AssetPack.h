@@ -0,0 +1,98 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum AssetType : uint32_t
+{
+    ASSET_RAW,          // the file's bytes as they were (shader source, audio)
+    ASSET_TEXTURE       // RGBA8 pixels, width * height * 4 bytes, ready for glTexImage2D
+};
+
+// One index record, as stored in the pack
+struct AssetPackEntry
+{
+    static constexpr int NAME_SIZE = 64;
+
+    char      name[NAME_SIZE];  // NUL-terminated, usually the asset's path
+    AssetType type;
+    int32_t   width, height;    // textures only
+    uint32_t  reserved;
+    uint64_t  offset;           // from the start of the pack, a multiple of ASSET_PACK_ALIGNMENT
+    uint64_t  size;
+};
+
+static_assert(sizeof(AssetPackEntry) == 96, "AssetPackEntry is written to disk as is");
+
+// Every entry starts on its own page, so a texture upload or a shader read
+// faults in exactly the pages it covers
+constexpr uint64_t ASSET_PACK_ALIGNMENT = 4096;
+
+// Every asset in one file: a header, an index sorted by name, then the
+// entries' data on page boundaries. Textures are stored decoded.
+//
+// open() maps the whole pack read-only, and get_data() points straight into
+// the mapping, so nothing is copied or parsed per asset: loading a texture
+// is one glTexImage2D from the mapped pixels. Pointers stay valid until
+// close(). The pack is built ahead of time by the asset packer
+// (asset_packer_main.cpp) and has to be rebuilt whenever an asset changes.
+class AssetPack
+{
+private:
+    const unsigned char*  m_data = nullptr;
+    size_t                m_size = 0;
+    const AssetPackEntry* m_entries = nullptr;
+    int                   m_entry_count = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+
+public:
+    ~AssetPack() { close(); }
+
+    // ----- METHODS ----- //
+    // One open and one mapping; fails on a missing, truncated or foreign file
+    bool open(const char* path);
+    void close();
+
+    // Null when there is no entry by that name
+    const AssetPackEntry* find(const char* name) const;
+    const unsigned char*  get_data(const AssetPackEntry& entry) const { return m_data + entry.offset; }
+
+    // ----- GETTERS ----- //
+    bool is_open()         const { return m_data != nullptr; }
+    int  get_entry_count() const { return m_entry_count; }
+    const AssetPackEntry& get_entry(int index) const { return m_entries[index]; }
+};
+
+// Collects entries in memory and writes them out as a pack
+class AssetPackWriter
+{
+private:
+    struct Pending
+    {
+        AssetPackEntry             entry;
+        std::vector<unsigned char> data;
+    };
+
+    std::vector<Pending> m_pending;
+
+    bool add(const char* name, AssetType type, int width, int height, const void* data, size_t size);
+
+public:
+    // ----- METHODS ----- //
+    // Names must be unique and shorter than AssetPackEntry::NAME_SIZE
+    bool add_raw(const char* name, const void* data, size_t size);
+    bool add_texture(const char* name, int width, int height, const unsigned char* pixels);
+
+    // The file's bytes as a raw entry named after its path
+    bool add_file(const char* path);
+
+    bool save(const char* path);
+};
+
+#endif // ASSET_PACK_H
@@ -0,0 +1,236 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <cstdio>
+#include <cstring>
+#include "BakedLevel.h"
+#include "GlState.h"
+
+constexpr char BAKED_LEVEL_MAGIC[4] = { 'L', 'L', 'B', '1' };
+constexpr uint32_t BAKED_LEVEL_VERSION = 2;     // 2: blocks in grid order, wide levels
+
+// Sanity limits for a file read back from disk
+constexpr int32_t MAX_BAKED_VERTICES = 6 * 1000000,
+    MAX_BAKED_COLUMNS = 1000000;
+
+uint64_t BakedLevel::make_key(int level, int screen_count, const UvRect* rects, int rect_count)
+{
+    // FNV-1a, as hash_world
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size)
+    {
+        const unsigned char* bytes = (const unsigned char*)data;
+        for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 1099511628211ull;
+    };
+
+    mix(&BAKED_LEVEL_VERSION, sizeof(BAKED_LEVEL_VERSION));
+    mix(&level, sizeof(level));
+    mix(&screen_count, sizeof(screen_count));
+    for (int i = 0; i < rect_count; i++) mix(&rects[i], sizeof(UvRect));
+    return hash;
+}
+
+bool BakedLevel::bake(const EntityPool& blocks, const Terrain& terrain)
+{
+    const EntityBody* bodies = blocks.get_bodies();
+    const EntitySprite* sprites = blocks.get_sprites();
+    int count = blocks.get_count();
+
+    for (int i = 1; i < count; i++)
+    {
+        if (sprites[i].texture_id != sprites[0].texture_id) return false;
+    }
+
+    SpatialGrid grid;
+    grid.build(blocks, CELL_WIDTH);
+
+    // The same quads SpriteBatch::draw writes for a positioned sprite, in
+    // grid order
+    m_vertices.clear();
+    m_vertices.reserve(count * VERTICES_PER_BLOCK * FLOATS_PER_VERTEX);
+    for (int item = 0; item < count; item++)
+    {
+        int i = grid.get_items()[item];
+        const EntitySprite& sprite = sprites[i];
+        const UvRect& uv = sprite.uv;
+        glm::vec3 position = bodies[i].position;
+
+        float x0 = position.x - sprite.width * 0.5f, x1 = position.x + sprite.width * 0.5f,
+            y0 = position.y - sprite.height * 0.5f, y1 = position.y + sprite.height * 0.5f;
+
+        m_vertices.insert(m_vertices.end(), {
+            x0, y0, uv.u0, uv.v1,
+            x1, y0, uv.u1, uv.v1,
+            x1, y1, uv.u1, uv.v0,
+            x0, y0, uv.u0, uv.v1,
+            x1, y1, uv.u1, uv.v0,
+            x0, y1, uv.u0, uv.v0,
+            });
+    }
+    m_vertex_count = count * VERTICES_PER_BLOCK;
+
+    m_terrain = terrain;
+    return build_grid();
+}
+
+// From the vertices, so a loaded bake gets its grid without storing it.
+// Fails for vertices that are not in grid order.
+bool BakedLevel::build_grid()
+{
+    int block_count = get_block_count();
+    int block_floats = VERTICES_PER_BLOCK * FLOATS_PER_VERTEX;
+
+    // The first two vertices of a quad are its bottom-left and bottom-right corners
+    std::vector<float> min_x(block_count), max_x(block_count);
+    for (int i = 0; i < block_count; i++)
+    {
+        min_x[i] = m_vertices[i * block_floats];
+        max_x[i] = m_vertices[i * block_floats + FLOATS_PER_VERTEX];
+    }
+    m_grid.build(min_x.data(), max_x.data(), block_count, CELL_WIDTH);
+
+    for (int i = 0; i < block_count; i++)
+    {
+        if (m_grid.get_items()[i] != i) return false;
+    }
+    return true;
+}
+
+bool BakedLevel::save(const char* path, uint64_t key) const
+{
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    int32_t column_count = m_terrain.get_column_count();
+    int32_t pad_count = (int32_t)m_terrain.get_pads().size();
+    float layout[2] = { m_terrain.get_origin_x(), m_terrain.get_column_width() };
+
+    bool ok = fwrite(BAKED_LEVEL_MAGIC, sizeof(BAKED_LEVEL_MAGIC), 1, file) == 1 &&
+        fwrite(&key, sizeof(key), 1, file) == 1 &&
+        fwrite(&m_vertex_count, sizeof(m_vertex_count), 1, file) == 1 &&
+        fwrite(m_vertices.data(), sizeof(float), m_vertices.size(), file) == m_vertices.size() &&
+        fwrite(&column_count, sizeof(column_count), 1, file) == 1 &&
+        fwrite(layout, sizeof(layout), 1, file) == 1;
+
+    // Columns go out as three arrays so each is one read on load
+    std::vector<float> bottom(column_count), top(column_count);
+    std::vector<uint8_t> kind(column_count);
+    for (int32_t i = 0; i < column_count; i++)
+    {
+        bottom[i] = m_terrain.get_bottom(i);
+        top[i] = m_terrain.get_top(i);
+        kind[i] = m_terrain.get_kind(i);
+    }
+    ok = ok && fwrite(bottom.data(), sizeof(float), column_count, file) == (size_t)column_count &&
+        fwrite(top.data(), sizeof(float), column_count, file) == (size_t)column_count &&
+        fwrite(kind.data(), 1, column_count, file) == (size_t)column_count;
+
+    ok = ok && fwrite(&pad_count, sizeof(pad_count), 1, file) == 1;
+    for (int32_t i = 0; ok && i < pad_count; i++)
+    {
+        int32_t range[2] = { m_terrain.get_pads()[i].first_column, m_terrain.get_pads()[i].last_column };
+        ok = fwrite(range, sizeof(range), 1, file) == 1;
+    }
+
+    fclose(file);
+    if (!ok) remove(path);
+    return ok;
+}
+
+bool BakedLevel::load(const char* path, uint64_t key)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+
+    char magic[4];
+    uint64_t file_key;
+    int32_t vertex_count;
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1 && memcmp(magic, BAKED_LEVEL_MAGIC, sizeof(magic)) == 0 &&
+        fread(&file_key, sizeof(file_key), 1, file) == 1 && file_key == key &&
+        fread(&vertex_count, sizeof(vertex_count), 1, file) == 1 &&
+        vertex_count >= 0 && vertex_count <= MAX_BAKED_VERTICES && vertex_count % VERTICES_PER_BLOCK == 0;
+
+    std::vector<float> vertices(ok ? vertex_count * FLOATS_PER_VERTEX : 0);
+    int32_t column_count;
+    float layout[2];
+    ok = ok && fread(vertices.data(), sizeof(float), vertices.size(), file) == vertices.size() &&
+        fread(&column_count, sizeof(column_count), 1, file) == 1 &&
+        column_count > 0 && column_count <= MAX_BAKED_COLUMNS &&
+        fread(layout, sizeof(layout), 1, file) == 1 && layout[1] > 0.0f;
+
+    std::vector<float> bottom(ok ? column_count : 0), top(ok ? column_count : 0);
+    std::vector<uint8_t> kind(ok ? column_count : 0);
+    ok = ok && fread(bottom.data(), sizeof(float), column_count, file) == (size_t)column_count &&
+        fread(top.data(), sizeof(float), column_count, file) == (size_t)column_count &&
+        fread(kind.data(), 1, column_count, file) == (size_t)column_count;
+
+    Terrain terrain;
+    if (ok) terrain.reset(layout[0], layout[1], column_count);
+    for (int32_t i = 0; ok && i < column_count; i++)
+    {
+        ok = kind[i] <= SURFACE_PAD;
+        if (ok && kind[i] != SURFACE_NONE) terrain.set_column(i, bottom[i], top[i], (SurfaceKind)kind[i]);
+    }
+
+    int32_t pad_count;
+    ok = ok && fread(&pad_count, sizeof(pad_count), 1, file) == 1 && pad_count >= 0 && pad_count <= column_count;
+    for (int32_t i = 0; ok && i < pad_count; i++)
+    {
+        int32_t range[2];
+        ok = fread(range, sizeof(range), 1, file) == 1 &&
+            range[0] >= 0 && range[0] <= range[1] && range[1] < column_count;
+        if (ok) terrain.add_pad(range[0], range[1]);
+    }
+
+    fclose(file);
+    if (!ok) return false;
+
+    m_vertices.swap(vertices);
+    m_vertex_count = vertex_count;
+    m_terrain = terrain;
+    return build_grid();
+}
+
+void BakedLevel::upload(GLuint texture_id)
+{
+    m_texture_id = texture_id;
+
+    glGenBuffers(1, &m_vertex_buffer);
+    GlState::get().bind_array_buffer(m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(float), m_vertices.data(), GL_STATIC_DRAW);
+
+    std::vector<float>().swap(m_vertices);
+}
+
+void BakedLevel::shutdown()
+{
+    GlState::get().forget_buffer(m_vertex_buffer);
+    glDeleteBuffers(1, &m_vertex_buffer);
+    m_vertex_buffer = 0;
+}
+
+int BakedLevel::draw(ShaderProgram* program, float min_x, float max_x) const
+{
+    GridSpan span = m_grid.query(min_x, max_x);
+    if (span.count == 0) return 0;
+
+    GlState& gl = GlState::get();
+    gl.set_model_matrix(program, glm::mat4(1.0f));
+    gl.bind_array_buffer(m_vertex_buffer);
+
+    GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (const void*)0);
+    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride,
+        (const void*)(2 * sizeof(float)));
+    gl.enable_sprite_attribs(program);
+
+    gl.bind_texture(m_texture_id);
+    gl.draw_arrays(GL_TRIANGLES, span.first * VERTICES_PER_BLOCK, span.count * VERTICES_PER_BLOCK);
+    return span.count;
+}
@@ -0,0 +1,67 @@
+#ifndef BAKED_LEVEL_H
+#define BAKED_LEVEL_H
+
+#include <cstdint>
+#include <vector>
+#include "EntityPool.h"
+#include "ShaderProgram.h"
+#include "SpatialGrid.h"
+#include "Terrain.h"
+
+// A level's static geometry, baked once: every block and pad merged into
+// one immutable vertex buffer and the terrain columns used for collision.
+//
+// The blocks go into the buffer in the order of a SpatialGrid over them, so
+// the ones in view are always one contiguous range of it: a frame draws
+// just those with a single call, and its cost follows what is on screen
+// rather than how wide the level is.
+//
+// The bake is saved next to the assets under a key describing what it was
+// built from, so later loads of the same level read it back instead of
+// rebuilding either part.
+class BakedLevel
+{
+private:
+    std::vector<float> m_vertices;      // x, y, u, v; six vertices per block
+    int      m_vertex_count = 0;
+    Terrain  m_terrain;
+    SpatialGrid m_grid;                 // items are blocks in buffer order
+
+    bool build_grid();
+
+    GLuint m_vertex_buffer = 0;
+    GLuint m_texture_id = 0;
+
+public:
+    static constexpr int FLOATS_PER_VERTEX = 4,
+        VERTICES_PER_BLOCK = 6;
+    static constexpr float CELL_WIDTH = 2.5f;   // a quarter of the view
+
+    // Identifies the inputs of a bake: the level number, its width in
+    // screens and the UV rectangles its sprites come from (they move
+    // whenever the atlas is repacked). Change BAKED_LEVEL_VERSION in
+    // BakedLevel.cpp when the level layout does.
+    static uint64_t make_key(int level, int screen_count, const UvRect* rects, int rect_count);
+
+    // ----- METHODS ----- //
+    // Merges every entity in blocks into the vertex data and takes a copy of
+    // the terrain. All the sprites must share one texture.
+    bool bake(const EntityPool& blocks, const Terrain& terrain);
+
+    bool load(const char* path, uint64_t key);
+    bool save(const char* path, uint64_t key) const;
+
+    // Creates the static vertex buffer; the CPU copy is released afterwards
+    void upload(GLuint texture_id);
+    void shutdown();
+
+    // Draws the blocks that may overlap min_x..max_x and returns how many that was
+    int draw(ShaderProgram* program, float min_x, float max_x) const;
+
+    // ----- GETTERS ----- //
+    const Terrain& get_terrain()      const { return m_terrain; }
+    int            get_vertex_count() const { return m_vertex_count; }
+    int            get_block_count()  const { return m_vertex_count / VERTICES_PER_BLOCK; }
+};
+
+#endif // BAKED_LEVEL_H
@@ -0,0 +1,146 @@
+#include <chrono>
+#include "Broadphase.h"
+
+int Broadphase::add_body(glm::vec3 position, float width, float height)
+{
+    int body = get_body_count();
+
+    m_min_x.push_back(0.0f);
+    m_max_x.push_back(0.0f);
+    m_min_y.push_back(0.0f);
+    m_max_y.push_back(0.0f);
+    m_active_slot.push_back(-1);
+    move_body(body, position, width, height);
+
+    // New endpoints go on the end; the next update sorts them into place
+    Endpoint min_end = { m_min_x[body], (uint32_t)body << 1 };
+    Endpoint max_end = { m_max_x[body], ((uint32_t)body << 1) | 1u };
+    m_endpoints.push_back(min_end);
+    m_endpoints.push_back(max_end);
+
+    return body;
+}
+
+void Broadphase::move_body(int body, glm::vec3 position, float width, float height)
+{
+    m_min_x[body] = position.x - width / 2.0f;
+    m_max_x[body] = position.x + width / 2.0f;
+    m_min_y[body] = position.y - height / 2.0f;
+    m_max_y[body] = position.y + height / 2.0f;
+}
+
+void Broadphase::clear()
+{
+    m_min_x.clear();
+    m_max_x.clear();
+    m_min_y.clear();
+    m_max_y.clear();
+    m_endpoints.clear();
+    m_active.clear();
+    m_active_slot.clear();
+    m_pairs.clear();
+    m_stats = BroadphaseStats();
+}
+
+// Where endpoints share a value, max ends sort before min ends: boxes that
+// only touch do not overlap, matching the strict test in aabb_overlap. A
+// zero-width box has both ends at one value, so its pair goes between the
+// two, its own min first, and it opens and closes without meeting boxes that
+// only touch it.
+static inline int tie_rank(uint32_t tag, const float* min_x, const float* max_x)
+{
+    int body = (int)(tag >> 1);
+    if (min_x[body] == max_x[body]) return 1;
+    return (tag & 1u) ? 0 : 2;
+}
+
+static inline bool endpoint_less(float a_value, uint32_t a_tag, float b_value, uint32_t b_tag,
+    const float* min_x, const float* max_x)
+{
+    if (a_value != b_value) return a_value < b_value;
+
+    int a_rank = tie_rank(a_tag, min_x, max_x),
+        b_rank = tie_rank(b_tag, min_x, max_x);
+    if (a_rank != b_rank) return a_rank < b_rank;
+    // Zero-width boxes in body order, each min before its max
+    return a_rank == 1 && a_tag < b_tag;
+}
+
+void Broadphase::sort_endpoints()
+{
+    long long swaps = 0;
+
+    for (size_t i = 0; i < m_endpoints.size(); i++)
+    {
+        uint32_t tag = m_endpoints[i].body_and_side;
+        int body = (int)(tag >> 1);
+        m_endpoints[i].value = (tag & 1u) ? m_max_x[body] : m_min_x[body];
+    }
+
+    for (size_t i = 1; i < m_endpoints.size(); i++)
+    {
+        Endpoint moving = m_endpoints[i];
+        size_t j = i;
+        while (j > 0 && endpoint_less(moving.value, moving.body_and_side,
+            m_endpoints[j - 1].value, m_endpoints[j - 1].body_and_side, m_min_x.data(), m_max_x.data()))
+        {
+            m_endpoints[j] = m_endpoints[j - 1];
+            j--;
+            swaps++;
+        }
+        m_endpoints[j] = moving;
+    }
+
+    m_stats.swap_count = swaps;
+}
+
+void Broadphase::update()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    sort_endpoints();
+
+    m_pairs.clear();
+    m_active.clear();
+
+    for (size_t i = 0; i < m_endpoints.size(); i++)
+    {
+        uint32_t tag = m_endpoints[i].body_and_side;
+        int body = (int)(tag >> 1);
+
+        if (tag & 1u)
+        {
+            // Interval closes: swap-remove from the active list. The sort
+            // opens every box before closing it, but a box whose ends went
+            // out of order (a NaN position) is skipped rather than trusted.
+            int slot = m_active_slot[body];
+            if (slot < 0) continue;
+            int last = m_active.back();
+            m_active[slot] = last;
+            m_active_slot[last] = slot;
+            m_active.pop_back();
+            m_active_slot[body] = -1;
+            continue;
+        }
+
+        // Interval opens: everything still open overlaps on x, so only y is left to check
+        for (size_t k = 0; k < m_active.size(); k++)
+        {
+            int other = m_active[k];
+            if (m_min_y[body] < m_max_y[other] && m_min_y[other] < m_max_y[body])
+            {
+                BodyPair pair;
+                pair.a = body < other ? body : other;
+                pair.b = body < other ? other : body;
+                m_pairs.push_back(pair);
+            }
+        }
+
+        m_active_slot[body] = (int)m_active.size();
+        m_active.push_back(body);
+    }
+
+    m_stats.body_count = get_body_count();
+    m_stats.pair_count = (int)m_pairs.size();
+    m_stats.update_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
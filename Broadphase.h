@@ -0,0 +1,62 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <cstdint>
+#include <vector>
+#include "glm/glm.hpp"
+
+struct BodyPair
+{
+    int a;      // always the lower body index
+    int b;
+};
+
+struct BroadphaseStats
+{
+    int       body_count;
+    int       pair_count;   // candidate pairs found by the last update()
+    long long swap_count;   // endpoint swaps the incremental sort needed; the
+                            // first sort of many unsorted bodies passes 2^31
+    float     update_ms;    // wall time of the last update()
+};
+
+// Sweep-and-prune over the x axis. Box endpoints stay sorted between
+// updates, and since bodies only move a little per tick the insertion sort
+// that restores the order is close to linear. The sweep then reports every
+// pair of boxes whose x and y extents overlap; callers confirm each pair
+// with the exact AABB test (aabb_overlap / Entity::check_collision).
+class Broadphase
+{
+private:
+    struct Endpoint
+    {
+        float    value;
+        uint32_t body_and_side;     // body index << 1, low bit set for the max end
+    };
+
+    std::vector<float> m_min_x, m_max_x, m_min_y, m_max_y;
+    std::vector<Endpoint> m_endpoints;
+
+    std::vector<int> m_active;              // bodies whose x interval is open during the sweep
+    std::vector<int> m_active_slot;         // where each body sits in m_active
+
+    std::vector<BodyPair> m_pairs;
+    BroadphaseStats m_stats = {};
+
+    void sort_endpoints();
+
+public:
+    // ----- METHODS ----- //
+    int  add_body(glm::vec3 position, float width, float height);
+    void move_body(int body, glm::vec3 position, float width, float height);
+    void clear();
+
+    void update();
+
+    // ----- GETTERS ----- //
+    int get_body_count() const { return (int)m_min_x.size(); }
+    const std::vector<BodyPair>& get_pairs() const { return m_pairs; }
+    const BroadphaseStats&       get_stats() const { return m_stats; }
+};
+
+#endif // BROADPHASE_H
@@ -0,0 +1,40 @@
+#include <algorithm>
+#include "glm/gtc/matrix_transform.hpp"
+#include "Camera.h"
+
+void Camera::initialise(float half_width, float dead_zone_half_width)
+{
+    m_half_width = half_width;
+    m_dead_zone = dead_zone_half_width;
+    m_min_x = m_max_x = m_x = 0.0f;
+}
+
+void Camera::set_bounds(float min_x, float max_x)
+{
+    // Narrower than the view: centre on the world
+    if (max_x - min_x <= 2.0f * m_half_width)
+    {
+        m_min_x = m_max_x = (min_x + max_x) * 0.5f;
+    }
+    else {
+        m_min_x = min_x + m_half_width;
+        m_max_x = max_x - m_half_width;
+    }
+    move_to(m_x);
+}
+
+void Camera::follow(glm::vec3 target)
+{
+    if (target.x > m_x + m_dead_zone) move_to(target.x - m_dead_zone);
+    else if (target.x < m_x - m_dead_zone) move_to(target.x + m_dead_zone);
+}
+
+void Camera::move_to(float x)
+{
+    m_x = std::min(std::max(x, m_min_x), m_max_x);
+}
+
+glm::mat4 Camera::get_view_matrix() const
+{
+    return glm::translate(glm::mat4(1.0f), glm::vec3(-m_x, 0.0f, 0.0f));
+}
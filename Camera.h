@@ -0,0 +1,41 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include "glm/glm.hpp"
+
+// A view of fixed width that scrolls sideways after its target. The target
+// can move freely inside the middle dead_zone_half_width of the view; the
+// camera only moves once it would leave that, and only as far as needed, so
+// small corrections do not shake the screen. The view never shows past the
+// bounds, which for a world no wider than the view pins it in place.
+//
+// A target that jumps (a lander wrapping around the world) is followed at
+// once.
+class Camera
+{
+private:
+    float m_half_width = 1.0f,
+        m_dead_zone = 0.0f;
+    float m_min_x = 0.0f,       // the view's centre stays between these
+        m_max_x = 0.0f;
+    float m_x = 0.0f;
+
+public:
+    // ----- METHODS ----- //
+    void initialise(float half_width, float dead_zone_half_width);
+
+    // The part of the world the view may show
+    void set_bounds(float min_x, float max_x);
+
+    void follow(glm::vec3 target);
+    void move_to(float x);
+
+    // ----- GETTERS ----- //
+    glm::mat4 get_view_matrix() const;
+
+    float get_x()     const { return m_x; }
+    float get_min_x() const { return m_x - m_half_width; }
+    float get_max_x() const { return m_x + m_half_width; }
+};
+
+#endif // CAMERA_H
@@ -12,6 +12,8 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
 #include "Entity.h"
+#include "GlState.h"
+#include "Simulation.h"
 
 // Default constructor
 Entity::Entity()
@@ -58,29 +60,22 @@ void Entity::draw_sprite_from_texture_atlas(ShaderProgram* program, GLuint textu
         -0.5f, -0.5f,  0.5f, 0.5f,  -0.5f, 0.5f
     };
 
-    // Bind the texture and set up the vertices
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    // Bind the texture and set up the vertices, straight from client memory
+    GlState& gl = GlState::get();
+    gl.bind_texture(texture_id);
+    gl.bind_array_buffer(0);
 
     glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->get_position_attribute());
-
     glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+    gl.enable_sprite_attribs(program);
 
     // Draw the single sprite
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    // Clean up
-    glDisableVertexAttribArray(program->get_position_attribute());
-    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+    gl.draw_arrays(GL_TRIANGLES, 0, 6);
 }
 
 bool const Entity::check_collision(Entity* other) const
 {
-    float x_distance = fabs(m_position.x - other->m_position.x) - ((m_width + other->m_width) / 2.0f);
-    float y_distance = fabs(m_position.y - other->m_position.y) - ((m_height + other->m_height) / 2.0f);
-
-    return x_distance < 0.0f && y_distance < 0.0f;
+    return aabb_overlap(m_position, m_width, m_height, other->m_position, other->m_width, other->m_height);
 }
 
 void Entity::update(float delta_time, Entity* player, Entity* collidable_entities, int collidable_entity_count)
@@ -88,66 +83,19 @@ void Entity::update(float delta_time, Entity* player, Entity* collidable_entitie
     for (int i = 0; i < collidable_entity_count; i++)
     {
         if (check_collision(&collidable_entities[i])) {
-            if (collidable_entities[i].get_platform_status()) {
-                if (m_velocity.y > -2.0f) {
-                    set_is_winner();
-                    return;
-                }
-                else {
-                    set_is_loser();
-                    set_crash_land();
-                    return;
-                }
+            ContactOutcome outcome = classify_contact(collidable_entities[i].get_platform_status(), m_velocity.y);
+            if (outcome == CONTACT_LANDED) {
+                set_is_winner();
             }
             else {
                 set_is_loser();
-                return;
+                if (outcome == CONTACT_CRASH_LANDED) set_crash_land();
             }
+            return;
         }
     }
 
-
-    if (m_acceleration.x > 0) {
-        m_acceleration.x -= 0.05;
-        if (m_acceleration.x < 0) {
-            m_acceleration.x = 0;
-        }
-    }
-    else if (m_acceleration.x < 0) {
-        m_acceleration.x += 0.05;
-        if (m_acceleration.x > 0) {
-            m_acceleration.x = 0;
-        }
-    }
-
-    // Limit vertical acceleration to max value
-    if (m_acceleration.y > 3.0f) {
-        m_acceleration.y = 3.0f; // or whatever your max is
-    }
-    if (m_acceleration.y < -1.0f) {
-        m_acceleration.y = -1.0f; // ensure upward velocity isn't too much
-    }
-    else {
-        m_acceleration.y -= 1.0f;
-    }
-
-    if (m_acceleration.x == 0) {
-        if (m_velocity.x > 0) {
-            m_velocity.x -= 0.05;
-            if (m_velocity.x < 0) {
-                m_velocity.x = 0;
-            }
-        }
-        else if (m_velocity.x < 0) {
-            m_velocity.x += 0.05;
-            if (m_velocity.x > 0) {
-                m_velocity.x = 0;
-            }
-        }
-    }
-
-    m_velocity += m_acceleration * delta_time;
-    m_position += m_velocity * delta_time;
+    integrate_lander(m_position, m_velocity, m_acceleration, delta_time);
 
 
     m_model_matrix = glm::mat4(1.0f);
@@ -159,7 +107,8 @@ void Entity::update(float delta_time, Entity* player, Entity* collidable_entitie
 
 void Entity::render(ShaderProgram* program)
 {
-    program->set_model_matrix(m_model_matrix);
+    GlState& gl = GlState::get();
+    gl.set_model_matrix(program, m_model_matrix);
 
     if (m_animation_indices != NULL)
     {
@@ -168,17 +117,20 @@ void Entity::render(ShaderProgram* program)
     }
 
     float vertices[] = { -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5 };
-    float tex_coords[] = { 0.0,  1.0, 1.0,  1.0, 1.0, 0.0,  0.0,  1.0, 1.0, 0.0,  0.0, 0.0 };
+    float tex_coords[] = { m_uv.u0, m_uv.v1, m_uv.u1, m_uv.v1, m_uv.u1, m_uv.v0,
+                           m_uv.u0, m_uv.v1, m_uv.u1, m_uv.v0, m_uv.u0, m_uv.v0 };
 
-    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    gl.bind_texture(m_texture_id);
+    gl.bind_array_buffer(0);
 
     glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->get_position_attribute());
     glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+    gl.enable_sprite_attribs(program);
 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    gl.draw_arrays(GL_TRIANGLES, 0, 6);
+}
 
-    glDisableVertexAttribArray(program->get_position_attribute());
-    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+void Entity::render(SpriteBatch* batch)
+{
+    batch->draw(m_texture_id, m_model_matrix, m_uv);
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "glm/glm.hpp"
 #include "ShaderProgram.h"
+#include "SpriteBatch.h"
 enum EntityType { PLATFORM, PLAYER, ENEMY };
 enum AIType { WALKER, GUARD };
 enum AIState { WALKING, IDLE, ATTACKING };
@@ -34,6 +35,7 @@ private:
 
     //  TEXTURES  //
     GLuint    m_texture_id;
+    UvRect    m_uv = FULL_TEXTURE;     // where the sprite sits inside its texture
 
     //  ANIMATION  //
     int m_animation_cols;
@@ -79,6 +81,7 @@ public:
 
     void update(float delta_time, Entity* player, Entity* collidable_entities, int collidable_entity_count);
     void render(ShaderProgram* program);
+    void render(SpriteBatch* batch);
 
     void normalise_movement() { m_movement = glm::normalize(m_movement); }
 
@@ -101,6 +104,7 @@ public:
     glm::vec3 const get_acceleration() const { return m_acceleration; }
     glm::vec3 const get_movement()     const { return m_movement; }
     glm::vec3 const get_scale()        const { return m_scale; }
+    glm::mat4 const get_model_matrix() const { return m_model_matrix; }
     GLuint    const get_texture_id()   const { return m_texture_id; }
     float     const get_speed()        const { return m_speed; }
     bool      const get_collided_top() const { return m_collided_top; }
@@ -127,6 +131,7 @@ public:
     void const set_movement(glm::vec3 new_movement) { m_movement = new_movement; }
     void const set_scale(glm::vec3 new_scale) { m_scale = new_scale; }
     void const set_texture_id(GLuint new_texture_id) { m_texture_id = new_texture_id; }
+    void const set_uv_rect(UvRect new_uv) { m_uv = new_uv; }
     void const set_speed(float new_speed) { m_speed = new_speed; }
     void const set_animation_cols(int new_cols) { m_animation_cols = new_cols; }
     void const set_animation_rows(int new_rows) { m_animation_rows = new_rows; }
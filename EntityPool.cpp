@@ -0,0 +1,130 @@
+#include "EntityPool.h"
+
+size_t EntityPool::get_arena_bytes(int capacity)
+{
+    // Each array starts on its own 64-byte line (see Arena::allocate)
+    size_t bytes = 0;
+    const size_t sizes[] = { sizeof(EntityBody), sizeof(EntitySprite), sizeof(uint32_t), sizeof(Slot) };
+    for (size_t size : sizes) bytes += (size * capacity + 63) / 64 * 64;
+    return bytes;
+}
+
+bool EntityPool::initialise(Arena& arena, int capacity)
+{
+    size_t mark = arena.get_mark();
+    m_bodies = arena.allocate_array<EntityBody>(capacity);
+    m_sprites = arena.allocate_array<EntitySprite>(capacity);
+    m_slot_of = arena.allocate_array<uint32_t>(capacity);
+    m_slots = arena.allocate_array<Slot>(capacity);
+
+    if (!m_bodies || !m_sprites || !m_slot_of || !m_slots)
+    {
+        arena.rewind(mark);
+        m_capacity = 0;
+        m_count = 0;
+        m_slots_used = 0;
+        m_free_slot = NO_SLOT;
+        return false;
+    }
+
+    m_capacity = capacity;
+    m_count = 0;
+    m_slots_used = 0;
+    m_free_slot = NO_SLOT;
+    return true;
+}
+
+const EntityPool::Slot* EntityPool::find_slot(EntityHandle handle) const
+{
+    // Slots past m_slots_used hold whatever the arena held before, and are
+    // never looked at
+    if (handle.generation == 0 || handle.slot >= (uint32_t)m_slots_used) return nullptr;
+
+    const Slot& slot = m_slots[handle.slot];
+    if (slot.generation != handle.generation || slot.index >= (uint32_t)m_count) return nullptr;
+    return &slot;
+}
+
+EntityHandle EntityPool::create(const EntityBody& body, const EntitySprite& sprite)
+{
+    if (m_count == m_capacity) return NULL_ENTITY;
+
+    uint32_t slot_index;
+    if (m_free_slot != NO_SLOT)
+    {
+        slot_index = m_free_slot;
+        m_free_slot = m_slots[slot_index].index;
+    }
+    else
+    {
+        slot_index = (uint32_t)m_slots_used++;
+    }
+
+    Slot& slot = m_slots[slot_index];
+    slot.generation = m_next_generation++;
+    if (m_next_generation == 0) m_next_generation = 1;
+    slot.index = (uint32_t)m_count;
+
+    m_bodies[m_count] = body;
+    m_sprites[m_count] = sprite;
+    m_slot_of[m_count] = slot_index;
+    m_count++;
+
+    EntityHandle handle = { slot_index, slot.generation };
+    return handle;
+}
+
+bool EntityPool::destroy(EntityHandle handle)
+{
+    if (!find_slot(handle)) return false;
+
+    Slot& slot = m_slots[handle.slot];
+    uint32_t index = slot.index;
+    uint32_t last = (uint32_t)m_count - 1;
+
+    // Keep the arrays dense by moving the last entity into the hole
+    if (index != last)
+    {
+        m_bodies[index] = m_bodies[last];
+        m_sprites[index] = m_sprites[last];
+        m_slot_of[index] = m_slot_of[last];
+        m_slots[m_slot_of[index]].index = index;
+    }
+    m_count--;
+
+    // A generation of 0 never matches a handle
+    slot.generation = 0;
+    slot.index = m_free_slot;
+    m_free_slot = handle.slot;
+    return true;
+}
+
+EntityBody* EntityPool::get_body(EntityHandle handle)
+{
+    const Slot* slot = find_slot(handle);
+    return slot ? &m_bodies[slot->index] : nullptr;
+}
+
+EntitySprite* EntityPool::get_sprite(EntityHandle handle)
+{
+    const Slot* slot = find_slot(handle);
+    return slot ? &m_sprites[slot->index] : nullptr;
+}
+
+void EntityPool::render(SpriteBatch* batch) const
+{
+    for (int i = 0; i < m_count; i++)
+    {
+        const EntitySprite& sprite = m_sprites[i];
+        batch->draw(sprite.texture_id, m_bodies[i].position, sprite.width, sprite.height, sprite.uv);
+    }
+}
+
+void EntityPool::render(SpriteBatch* batch, const int* indices, int count) const
+{
+    for (int i = 0; i < count; i++)
+    {
+        const EntitySprite& sprite = m_sprites[indices[i]];
+        batch->draw(sprite.texture_id, m_bodies[indices[i]].position, sprite.width, sprite.height, sprite.uv);
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+#include <cstdint>
+#include "glm/glm.hpp"
+#include "Arena.h"
+#include "Entity.h"
+#include "SpriteBatch.h"
+
+// Refers to one entity for as long as it lives. A handle whose entity was
+// destroyed (or whose pool was reset) stops resolving instead of pointing
+// at whatever took its place.
+struct EntityHandle
+{
+    uint32_t slot;
+    uint32_t generation;    // 0 is never handed out
+};
+
+constexpr EntityHandle NULL_ENTITY = { 0, 0 };
+
+// Hot: what physics and collision read every tick, 32 bytes per entity
+struct EntityBody
+{
+    glm::vec3 position;
+    glm::vec3 velocity;
+    float half_width,
+        half_height;
+};
+
+// Cold: only read while drawing
+struct EntitySprite
+{
+    GLuint     texture_id;
+    UvRect     uv;
+    float      width,           // drawn size, which need not match the body
+        height;
+    EntityType entity_type;
+};
+
+// Entities stored as components in packed arrays carved out of an arena.
+// Bodies and sprites sit in separate arrays at the same index, so a physics
+// pass walks nothing but bodies. The arrays stay dense: destroying an
+// entity moves the last one into its place, which invalidates indices and
+// pointers into the arrays (but never handles).
+//
+// initialise() only carves the arrays out of the arena, without touching
+// them, so a world reset is an arena rewind plus initialise(), however many
+// entities there were. Handles from before the reset no longer resolve.
+class EntityPool
+{
+private:
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    struct Slot
+    {
+        uint32_t generation;
+        uint32_t index;         // into the dense arrays, or the next free slot
+    };
+
+    EntityBody*   m_bodies = nullptr;
+    EntitySprite* m_sprites = nullptr;
+    uint32_t*     m_slot_of = nullptr;      // dense index -> slot
+    Slot*         m_slots = nullptr;
+
+    int m_capacity = 0,
+        m_count = 0,
+        m_slots_used = 0;                   // slots handed out since initialise()
+    uint32_t m_free_slot = NO_SLOT;
+
+    // Never reset, so a generation is never reused by a later level either
+    uint32_t m_next_generation = 1;
+
+    const Slot* find_slot(EntityHandle handle) const;
+
+public:
+    // Arena space initialise() needs for capacity entities
+    static size_t get_arena_bytes(int capacity);
+
+    // ----- METHODS ----- //
+    // False when the arena cannot hold capacity entities
+    bool initialise(Arena& arena, int capacity);
+
+    // NULL_ENTITY when the pool is full
+    EntityHandle create(const EntityBody& body, const EntitySprite& sprite);
+    bool destroy(EntityHandle handle);
+
+    bool is_alive(EntityHandle handle) const { return find_slot(handle) != nullptr; }
+
+    // Null for a stale handle; valid until the next create() or destroy()
+    EntityBody*   get_body(EntityHandle handle);
+    EntitySprite* get_sprite(EntityHandle handle);
+
+    // One batched draw call per texture for every entity in the pool
+    void render(SpriteBatch* batch) const;
+    // The same for just the entities at the given dense indices (what a
+    // SpatialGrid built over the pool returns for a view)
+    void render(SpriteBatch* batch, const int* indices, int count) const;
+
+    // ----- GETTERS ----- //
+    int get_count()    const { return m_count; }
+    int get_capacity() const { return m_capacity; }
+
+    // The dense arrays, get_count() long, in no particular order
+    EntityBody*         get_bodies()        { return m_bodies; }
+    const EntityBody*   get_bodies()  const { return m_bodies; }
+    const EntitySprite* get_sprites() const { return m_sprites; }
+};
+
+#endif // ENTITY_POOL_H
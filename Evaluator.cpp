@@ -0,0 +1,200 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "Evaluator.h"
+#include "JobSystem.h"
+
+// Episodes per job, and so per partial sum; fixed so the summing order
+// never depends on the thread count
+constexpr int EPISODES_PER_CHUNK = 4096;
+
+constexpr int PAD_CHOICES = 20;
+
+// Where a flight can start: anywhere across the screen, above the blocks,
+// drifting a little
+constexpr float START_MIN_X = -4.5f,
+START_MAX_X = 4.5f,
+START_MIN_Y = 1.5f,
+START_MAX_Y = 3.5f,
+START_MAX_SPEED_X = 1.0f,
+START_MIN_SPEED_Y = -1.0f;
+
+uint64_t next_random(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+float random_range(uint64_t& state, float low, float high)
+{
+    return low + (high - low) * (float)(next_random(state) >> 40) / (float)(1 << 24);
+}
+
+// ----- CONTROLLERS ----- //
+// Same autopilot as headless_main: keep the descent gentle and drift towards the pad
+static TickInput autopilot(const World& world, uint64_t&)
+{
+    const Lander& lander = world.lander;
+    float pad_x = world.terrain->get_pad_center_x(0);
+
+    TickInput input;
+    input.left = lander.position.x > pad_x + 0.1f && lander.velocity.x > -0.5f;
+    input.right = lander.position.x < pad_x - 0.1f && lander.velocity.x < 0.5f;
+    input.up = lander.velocity.y < LANDING_SPEED_LIMIT * 0.5f;
+    return input;
+}
+
+static TickInput random_keys(const World&, uint64_t& rng)
+{
+    uint64_t bits = next_random(rng);
+
+    TickInput input;
+    input.left = (bits & 3) == 0;
+    input.right = (bits & 3) == 1;
+    input.up = ((bits >> 2) & 1) != 0;
+    return input;
+}
+
+static TickInput idle(const World&, uint64_t&)
+{
+    TickInput input = { false, false, false };
+    return input;
+}
+
+static const Controller CONTROLLERS[] = {
+    { "autopilot", autopilot },
+    { "random",    random_keys },
+    { "idle",      idle },
+};
+
+const Controller* get_controllers(int& count)
+{
+    count = sizeof(CONTROLLERS) / sizeof(CONTROLLERS[0]);
+    return CONTROLLERS;
+}
+
+const Controller* find_controller(const char* name)
+{
+    int count;
+    const Controller* controllers = get_controllers(count);
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(controllers[i].name, name) == 0) return &controllers[i];
+    }
+    return nullptr;
+}
+
+// ----- EPISODES ----- //
+namespace
+{
+    struct ChunkResult
+    {
+        long long landed, crash_landed, hit, timed_out, fuel_out, ticks;
+        double    fuel_left, impact_speed, contact_time;
+    };
+
+    struct EvaluationJob
+    {
+        const EvaluationConfig* config;
+        const Terrain*          terrains;      // one per pad index, shared read-only
+        std::vector<ChunkResult> chunks;
+    };
+}
+
+static void run_episode(const EvaluationConfig& config, const Terrain* terrains, long long index, ChunkResult& result)
+{
+    uint64_t rng = config.seed ^ ((uint64_t)index * 0xD1B54A32D192ED03ull);
+    next_random(rng);
+
+    int pad_index = (int)(next_random(rng) % PAD_CHOICES) + 1;
+
+    World world;
+    reset_world(world, &terrains[pad_index]);
+
+    Lander& lander = world.lander;
+    lander.position.x = random_range(rng, START_MIN_X, START_MAX_X);
+    lander.position.y = random_range(rng, START_MIN_Y, START_MAX_Y);
+    lander.velocity.x = random_range(rng, -START_MAX_SPEED_X, START_MAX_SPEED_X);
+    lander.velocity.y = random_range(rng, START_MIN_SPEED_Y, 0.0f);
+    lander.fuel = config.tuning.starting_fuel;
+
+    int step_ticks = config.step_ticks > 1 ? config.step_ticks : 1;
+    int decision_ticks = config.decision_ticks > step_ticks ? config.decision_ticks : step_ticks;
+    while ((int)world.tick < config.max_ticks && !lander.is_winner && !lander.is_loser)
+    {
+        TickInput input = config.controller->decide(world, rng);
+        for (int held = 0; held < decision_ticks && !lander.is_winner && !lander.is_loser; held += step_ticks)
+        {
+            step_world(world, input, config.tuning, step_ticks);
+        }
+    }
+
+    if (lander.is_winner) result.landed++;
+    else if (lander.crash_land) result.crash_landed++;
+    else if (lander.is_loser) result.hit++;
+    else result.timed_out++;
+
+    if (lander.depleted || lander.fuel <= 0.0f) result.fuel_out++;
+    result.ticks += world.tick;
+    result.fuel_left += lander.fuel > 0.0f ? lander.fuel : 0.0f;
+    if (world.contact_time >= 0.0f)
+    {
+        result.impact_speed += fabs(lander.velocity.y);
+        result.contact_time += world.contact_time;
+    }
+}
+
+static void run_chunk(int chunk, int, void* context)
+{
+    EvaluationJob& job = *(EvaluationJob*)context;
+    const EvaluationConfig& config = *job.config;
+
+    ChunkResult& result = job.chunks[chunk];
+    result = ChunkResult();
+
+    long long first = (long long)chunk * EPISODES_PER_CHUNK;
+    long long last = first + EPISODES_PER_CHUNK;
+    if (last > config.episode_count) last = config.episode_count;
+
+    for (long long episode = first; episode < last; episode++)
+    {
+        run_episode(config, job.terrains, episode, result);
+    }
+}
+
+EvaluationResult evaluate(const EvaluationConfig& config, int thread_count)
+{
+    Terrain terrains[PAD_CHOICES + 1];
+    for (int pad = 1; pad <= PAD_CHOICES; pad++) build_classic_terrain(terrains[pad], pad);
+
+    EvaluationJob job;
+    job.config = &config;
+    job.terrains = terrains;
+
+    int chunk_count = (int)((config.episode_count + EPISODES_PER_CHUNK - 1) / EPISODES_PER_CHUNK);
+    job.chunks.resize(chunk_count);
+
+    JobStats stats = run_jobs(chunk_count, thread_count, run_chunk, &job);
+
+    EvaluationResult result = {};
+    result.episodes = config.episode_count;
+    for (const ChunkResult& chunk : job.chunks)
+    {
+        result.landed += chunk.landed;
+        result.crash_landed += chunk.crash_landed;
+        result.hit += chunk.hit;
+        result.timed_out += chunk.timed_out;
+        result.fuel_out += chunk.fuel_out;
+        result.ticks += chunk.ticks;
+        result.fuel_left += chunk.fuel_left;
+        result.impact_speed += chunk.impact_speed;
+        result.contact_time += chunk.contact_time;
+    }
+
+    result.thread_count = stats.thread_count;
+    result.steals = stats.steals;
+    result.run_ms = stats.run_ms;
+    return result;
+}
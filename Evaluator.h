@@ -0,0 +1,65 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <cstdint>
+#include "Simulation.h"
+
+// Decides the input for the next tick. rng is the episode's own generator
+// (see next_random), so a controller that wants randomness stays
+// reproducible. Controllers are called from several threads at once and
+// must not keep state of their own.
+typedef TickInput (*ControllerFunction)(const World& world, uint64_t& rng);
+
+struct Controller
+{
+    const char*        name;
+    ControllerFunction decide;
+};
+
+// Built-in controllers: "autopilot", "random" and "idle"
+const Controller* find_controller(const char* name);
+const Controller* get_controllers(int& count);
+
+struct EvaluationConfig
+{
+    uint64_t     seed;
+    long long    episode_count;
+    int          max_ticks;             // an episode still flying after this many ticks has timed out
+    int          decision_ticks;        // ticks each controller decision is held for; 1 decides every
+                                        // tick, 6 every 0.1 s
+    int          step_ticks;            // ticks per physics step (see step_world), dividing
+                                        // decision_ticks; 1 flies at 60 Hz, 6 in 0.1 s steps
+    LanderTuning tuning;
+    const Controller* controller;
+};
+
+struct EvaluationResult
+{
+    long long episodes;
+    long long landed;
+    long long crash_landed;             // on the pad, but faster than LANDING_SPEED_LIMIT
+    long long hit;                      // came down on rock
+    long long timed_out;
+    long long fuel_out;                 // ran the tank dry, whatever the outcome
+    long long ticks;
+    double    fuel_left;                // summed over every episode
+    double    impact_speed;             // summed over the episodes that touched down
+    double    contact_time;             // likewise, in seconds
+
+    int    thread_count;
+    int    steals;
+    double run_ms;
+};
+
+// Flies config.episode_count episodes over all threads. Episode i draws its
+// pad (1..20, like initialise()) and start state from a generator seeded by
+// config.seed and i alone, and episodes are summed in fixed chunks in
+// index order, so every field except the timing ones is identical for any
+// thread_count.
+EvaluationResult evaluate(const EvaluationConfig& config, int thread_count);
+
+// SplitMix64 step, returning the next 64 random bits
+uint64_t next_random(uint64_t& state);
+float    random_range(uint64_t& state, float low, float high);
+
+#endif // EVALUATOR_H
@@ -0,0 +1,155 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <cmath>
+#include <vector>
+#include "FlightScene.h"
+#include "GameAssets.h"
+
+// ----- LEVEL ----- //
+void create_level_blocks(EntityPool& blocks, Arena& arena, int screen_count, int level_number,
+    GLuint texture_id, const TextureAtlas* atlas)
+{
+    int block_count = PLATFORM_COUNT * screen_count;
+    blocks.initialise(arena, block_count);
+
+    std::vector<Block> level_blocks(block_count);
+    build_wide_blocks(level_blocks.data(), screen_count, level_number);
+    for (int i = 0; i < block_count; i++)
+    {
+        const Block& block = level_blocks[i];
+        EntityBody body = { block.position, glm::vec3(0.0f), block.width / 2.0f, block.height / 2.0f };
+        UvRect uv = atlas != nullptr ? atlas->get_rect(block.is_platform ? ATLAS_PLATFORM : ATLAS_BLOCK) : FULL_TEXTURE;
+        EntitySprite sprite = { texture_id, uv, 0.5f, 0.5f, PLATFORM };
+        blocks.create(body, sprite);
+    }
+}
+
+void set_up_camera(Camera& camera, int screen_count)
+{
+    camera.initialise(VIEW_HALF_WIDTH, CAMERA_DEAD_ZONE);
+    float wrap_limit = get_wrap_limit_x(screen_count);
+    camera.set_bounds(-wrap_limit + WRAP_OFFSET_X, wrap_limit - WRAP_OFFSET_X);
+}
+
+float ground_below(const Terrain& terrain, float x)
+{
+    int column = (int)floorf((x - terrain.get_origin_x()) / terrain.get_column_width());
+    if (column < 0 || column >= terrain.get_column_count()) return -INFINITY;
+    return terrain.get_top(column);
+}
+
+// ----- PARTICLES ----- //
+void FlightEffects::initialise()
+{
+    m_arena.initialise(ParticleSystem::get_arena_bytes(PARTICLE_CAPACITY));
+    m_particles.initialise(m_arena, PARTICLE_CAPACITY);
+    m_particles.create_buffers();
+
+    m_exhaust_carry = m_dust_carry = 0.0f;
+    m_crash_shown = false;
+}
+
+void FlightEffects::set_sprites(GLuint atlas_texture_id, const TextureAtlas& atlas)
+{
+    m_particles.set_texture(atlas_texture_id);
+    m_exhaust_sprite = m_particles.add_sprite(atlas.get_rect(ATLAS_FLAME));
+    m_dust_sprite = m_particles.add_sprite(atlas.get_rect(ATLAS_BLOCK));
+    m_debris_sprite = m_particles.add_sprite(atlas.get_rect(ATLAS_LANDER));
+}
+
+void FlightEffects::shutdown()
+{
+    m_particles.shutdown();
+    m_arena.shutdown();
+}
+
+void FlightEffects::update(const Lander& lander, glm::vec3 position, bool thrusting, const Terrain& terrain, float delta_time)
+{
+    if (thrusting && !lander.depleted)
+    {
+        // Spawn counts follow the frame time, so the plume looks the same at any refresh rate
+        m_exhaust_carry += EXHAUST_RATE * delta_time;
+        int exhaust_count = (int)m_exhaust_carry;
+        m_exhaust_carry -= exhaust_count;
+
+        ParticleSpawn exhaust = { position + glm::vec3(0.04f, -0.45f, 0.0f), 0.04f,
+            lander.velocity + glm::vec3(0.0f, -3.0f, 0.0f), glm::vec3(0.5f, 0.6f, 0.0f),
+            0.3f, 0.1f, 0.25f, 0.0f, m_exhaust_sprite };
+        m_particles.emit(exhaust, exhaust_count);
+
+        float ground = ground_below(terrain, position.x);
+        if (position.y - ground < DUST_HEIGHT)
+        {
+            m_dust_carry += DUST_RATE * delta_time;
+            int dust_count = (int)m_dust_carry;
+            m_dust_carry -= dust_count;
+
+            ParticleSpawn dust = { glm::vec3(position.x, ground, 0.0f), 0.15f,
+                glm::vec3(0.0f, 0.6f, 0.0f), glm::vec3(2.5f, 0.4f, 0.0f),
+                0.8f, 0.3f, 0.08f, -1.6f, m_dust_sprite };
+            m_particles.emit(dust, dust_count);
+        }
+    }
+
+    // Once, on the first frame that shows the crash
+    if (lander.is_loser && !m_crash_shown)
+    {
+        ParticleSpawn debris = { position, 0.2f,
+            glm::vec3(0.0f, 2.5f, 0.0f), glm::vec3(3.0f, 2.5f, 0.0f),
+            1.5f, 0.5f, 0.12f, -9.8f, m_debris_sprite };
+        m_particles.emit(debris, DEBRIS_COUNT);
+    }
+    m_crash_shown = lander.is_loser;
+
+    m_particles.update(delta_time);
+}
+
+// ----- HUD ----- //
+void FlightHud::initialise(GLuint font_texture_id, const UvRect& font_rect)
+{
+    m_text.set_font(font_texture_id, font_rect);
+    m_fuel_label = m_text.add_run(6, 0.2f, 0.001f, glm::vec3(-4.5f, 2.25f, 0.0f));
+    m_fuel = m_text.add_run(HudText::NUMBER_LENGTH, 0.2f, 0.001f, m_text.get_position_after(m_fuel_label, 6));
+    m_velocity_label = m_text.add_run(10, 0.2f, 0.001f, glm::vec3(-4.5f, 2.5f, 0.0f));
+    m_velocity = m_text.add_run(HudText::NUMBER_LENGTH, 0.2f, 0.001f, m_text.get_position_after(m_velocity_label, 10));
+    m_success = m_text.add_run(15, 0.5f, 0.05f, glm::vec3(-3.75f, 2.5f, 0.0f));
+    m_fail = m_text.add_run(12, 0.5f, 0.05f, glm::vec3(-3.0f, 2.5f, 0.0f));
+    m_too_hard = m_text.add_run(15, 0.4f, 0.05f, glm::vec3(-3.15f, 1.75f, 0.0f));
+
+    m_text.set_text(m_fuel_label, "Fuel: ");
+    m_text.set_text(m_velocity_label, "Velocity: ");
+    m_text.set_text(m_success, "MISSION SUCCESS");
+    m_text.set_text(m_fail, "MISSION FAIL");
+    m_text.set_text(m_too_hard, "LANDED TOO HARD");
+    m_text.initialise();
+}
+
+void FlightHud::draw(ShaderProgram* program, const Lander& lander)
+{
+    // If no winner / loser, keep displaying stats
+    bool flying = !lander.is_winner && !lander.is_loser;
+    m_text.set_visible(m_fuel_label, flying);
+    m_text.set_visible(m_fuel, flying);
+    m_text.set_visible(m_velocity_label, flying);
+    m_text.set_visible(m_velocity, flying);
+
+    if (flying) {
+        // Only the glyphs whose digit changed get rewritten and uploaded
+        m_text.set_number(m_fuel, lander.fuel);
+        m_text.set_number(m_velocity, lander.velocity.y);
+    }
+
+    // Check win/loss conditions
+    m_text.set_visible(m_success, lander.is_winner);
+    m_text.set_visible(m_fail, !lander.is_winner && lander.is_loser);
+    m_text.set_visible(m_too_hard, !lander.is_winner && lander.is_loser && lander.crash_land);
+
+    m_text.draw(program);
+}
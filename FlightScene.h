@@ -0,0 +1,95 @@
+#ifndef FLIGHT_SCENE_H
+#define FLIGHT_SCENE_H
+
+#include "glm/glm.hpp"
+#include "Arena.h"
+#include "Camera.h"
+#include "EntityPool.h"
+#include "HudText.h"
+#include "ParticleSystem.h"
+#include "Simulation.h"
+#include "TextureAtlas.h"
+
+// What the game draws around the simulation, shared by main.cpp and the
+// flight capture (capture_main.cpp) so a captured video shows what the
+// window showed
+
+// The view is 10 x 7.5 world units; over worlds wider than that the camera scrolls it
+constexpr float VIEW_HALF_WIDTH = 5.0f,
+VIEW_HALF_HEIGHT = 3.75f,
+CAMERA_DEAD_ZONE = 1.5f;    // how far the lander gets from the centre before the view follows
+
+constexpr float BG_RED = 0.0f,
+BG_GREEN = 0.0f,
+BG_BLUE = 0.5f,   //0.549f
+BG_OPACITY = 1.0f;
+
+constexpr int PARTICLE_CAPACITY = 16384,
+DEBRIS_COUNT = 400;                 // all at once, when the lander crashes
+constexpr float EXHAUST_RATE = 240.0f,     // particles per second while thrusting
+DUST_RATE = 160.0f,
+DUST_HEIGHT = 2.0f;                 // the plume kicks up dust from this close to the ground
+
+// Fills blocks, carved out of arena, with the level's blocks. Without an
+// atlas each sprite shows the whole texture.
+void create_level_blocks(EntityPool& blocks, Arena& arena, int screen_count, int level_number,
+    GLuint texture_id, const TextureAtlas* atlas);
+
+// The lander leaves the view half a unit before it wraps, as it always
+// left the screen; a one-screen world never scrolls
+void set_up_camera(Camera& camera, int screen_count);
+
+// Top of the terrain column under x, or -infinity off either end
+float ground_below(const Terrain& terrain, float x);
+
+// Exhaust, dust and debris; drawn only, spawned from what each frame shows
+// of the flight. Their storage lives in the effects' own arena.
+class FlightEffects
+{
+private:
+    Arena m_arena;
+    ParticleSystem m_particles;
+
+    int m_exhaust_sprite = 0,
+        m_dust_sprite = 0,
+        m_debris_sprite = 0;
+    float m_exhaust_carry = 0.0f,   // fractions of a particle owed from earlier frames
+        m_dust_carry = 0.0f;
+    bool m_crash_shown = false;
+
+public:
+    // ----- METHODS ----- //
+    // Before the atlas is in; set_sprites() then picks the particles' looks
+    void initialise();
+    void set_sprites(GLuint atlas_texture_id, const TextureAtlas& atlas);
+    void shutdown();
+
+    // Spawns for delta_time seconds of a frame showing the lander at
+    // position, then steps every particle by it
+    void update(const Lander& lander, glm::vec3 position, bool thrusting, const Terrain& terrain, float delta_time);
+    void draw(ShaderProgram* program) { m_particles.draw(program); }
+
+    // ----- GETTERS ----- //
+    const ParticleStats& get_stats() const { return m_particles.get_stats(); }
+};
+
+// Fuel and vertical speed while flying, then how the flight ended. Every
+// string gets a fixed HudText run; the labels are written once.
+class FlightHud
+{
+private:
+    HudText m_text;
+    int m_fuel_label, m_fuel,
+        m_velocity_label, m_velocity,
+        m_success, m_fail, m_too_hard;
+
+public:
+    // ----- METHODS ----- //
+    void initialise(GLuint font_texture_id, const UvRect& font_rect);
+    void shutdown() { m_text.shutdown(); }
+
+    // In screen space, over the frame
+    void draw(ShaderProgram* program, const Lander& lander);
+};
+
+#endif // FLIGHT_SCENE_H
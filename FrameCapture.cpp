@@ -0,0 +1,472 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include "FrameCapture.h"
+
+static double milliseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ----- SETUP ----- //
+bool FrameCapture::initialise(int width, int height, const char* directory, FrameCaptureFormat format,
+    int ring_size, int buffer_count)
+{
+    if (width <= 0 || height <= 0 || ring_size < 1 || buffer_count < 1) return false;
+    if (strlen(directory) + 32 > sizeof(m_directory)) return false;
+
+    m_width = width;
+    m_height = height;
+    m_format = format;
+    strcpy(m_directory, directory);
+
+    if (format == CAPTURE_RAW)
+    {
+        char path[sizeof(m_directory) + 32];
+        snprintf(path, sizeof(path), "%s/frames.rgba", m_directory);
+        m_raw_file = fopen(path, "wb");
+        if (m_raw_file == NULL) return false;
+    }
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+
+    glGenRenderbuffers(1, &m_colour_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colour_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colour_buffer);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    size_t frame_bytes = (size_t)width * height * 4;
+
+    // GL_STREAM_READ: written once by the GPU, read once by us
+    m_pixel_buffers.assign(ring_size, 0);
+    m_fences.assign(ring_size, nullptr);
+    glGenBuffers(ring_size, m_pixel_buffers.data());
+    for (GLuint pixel_buffer : m_pixel_buffers)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixel_buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frame_bytes, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_frames.resize(buffer_count);
+    for (int i = 0; i < buffer_count; i++)
+    {
+        m_frames[i].pixels.resize(frame_bytes);
+        m_free.push_back(i);
+    }
+
+    m_frames_issued = m_frames_read = 0;
+    m_stopping = false;
+    m_stats = {};
+
+    if (!complete)
+    {
+        shutdown();
+        return false;
+    }
+
+    m_writer = std::thread(&FrameCapture::write, this);
+    return true;
+}
+
+void FrameCapture::shutdown()
+{
+    if (m_writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_queued_changed.notify_one();
+        m_writer.join();
+    }
+
+    for (GLsync fence : m_fences)
+    {
+        if (fence != nullptr) glDeleteSync(fence);
+    }
+    m_fences.clear();
+
+    if (!m_pixel_buffers.empty()) glDeleteBuffers((GLsizei)m_pixel_buffers.size(), m_pixel_buffers.data());
+    m_pixel_buffers.clear();
+
+    if (m_colour_buffer != 0) glDeleteRenderbuffers(1, &m_colour_buffer);
+    if (m_framebuffer != 0) glDeleteFramebuffers(1, &m_framebuffer);
+    m_colour_buffer = m_framebuffer = 0;
+
+    if (m_raw_file != nullptr) fclose(m_raw_file);
+    m_raw_file = nullptr;
+
+    m_frames.clear();
+    m_free.clear();
+    m_queued.clear();
+}
+
+// ----- CAPTURE ----- //
+void FrameCapture::begin_frame()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void FrameCapture::end_frame()
+{
+    int ring_size = (int)m_pixel_buffers.size();
+    int slot = m_frames_issued % ring_size;
+
+    // The slot's previous transfer was issued ring_size frames ago and has
+    // long finished; take it out before the buffer is reused
+    if (m_frames_issued - m_frames_read == ring_size) read_back(slot);
+
+    // With a pack buffer bound the last argument is an offset into it, and
+    // the call returns as soon as the copy is queued
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixel_buffers[slot]);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_frames_issued++;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameCapture::finish()
+{
+    int ring_size = (int)m_pixel_buffers.size();
+    while (m_frames_read < m_frames_issued) read_back(m_frames_read % ring_size);
+}
+
+void FrameCapture::read_back(int slot)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Flushes too, so a transfer that is still queued gets going
+    GLenum status = glClientWaitSync(m_fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    bool stalled = status == GL_TIMEOUT_EXPIRED;
+    glDeleteSync(m_fences[slot]);
+    m_fences[slot] = nullptr;
+
+    int index;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_free.empty())
+        {
+            auto wait_start = std::chrono::steady_clock::now();
+            m_free_changed.wait(lock, [this] { return !m_free.empty(); });
+            m_stats.writer_waits++;
+            m_stats.writer_wait_ms += milliseconds_since(wait_start);
+        }
+        index = m_free.front();
+        m_free.pop_front();
+    }
+
+    Frame& frame = m_frames[index];
+    frame.number = m_frames_read++;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixel_buffers[slot]);
+    const void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    bool mapped = pixels != NULL;
+    if (mapped)
+    {
+        memcpy(frame.pixels.data(), pixels, frame.pixels.size());
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    double elapsed = milliseconds_since(start);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (mapped) {
+            m_queued.push_back(index);
+        }
+        else {
+            m_free.push_back(index);
+            m_stats.failed++;
+        }
+        m_stats.captured++;
+        if (stalled) m_stats.readback_stalls++;
+        m_stats.readback_ms += elapsed;
+        if (elapsed > m_stats.max_readback_ms) m_stats.max_readback_ms = elapsed;
+    }
+    m_queued_changed.notify_one();
+}
+
+void FrameCapture::blit_to_window() const
+{
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+FrameCaptureStats FrameCapture::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+// ----- WRITER ----- //
+void FrameCapture::write()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        // Everything queued is written before the thread stops
+        m_queued_changed.wait(lock, [this] { return m_stopping || !m_queued.empty(); });
+        if (m_queued.empty()) return;
+
+        int index = m_queued.front();
+        m_queued.pop_front();
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = write_frame(m_frames[index]);
+        double elapsed = milliseconds_since(start);
+
+        lock.lock();
+        if (ok) {
+            m_stats.written++;
+        }
+        else {
+            m_stats.failed++;
+        }
+        m_stats.write_ms += elapsed;
+        m_free.push_back(index);
+        m_free_changed.notify_one();
+    }
+}
+
+bool FrameCapture::write_frame(const Frame& frame)
+{
+    size_t row_bytes = (size_t)m_width * 4;
+    const unsigned char* last_row = frame.pixels.data() + row_bytes * (m_height - 1);
+
+    if (m_format == CAPTURE_RAW)
+    {
+        // Frames are read back in order, so the file stays in order too
+        bool ok = true;
+        for (int y = 0; ok && y < m_height; y++)
+        {
+            ok = fwrite(last_row - row_bytes * y, 1, row_bytes, m_raw_file) == row_bytes;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ok) m_stats.bytes_written += (double)row_bytes * m_height;
+        return ok;
+    }
+
+    char path[sizeof(m_directory) + 32];
+    snprintf(path, sizeof(path), "%s/frame_%06d.png", m_directory, frame.number);
+
+    encode_png(m_encoded, m_width, m_height, last_row, -(ptrdiff_t)row_bytes);
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+    bool ok = fwrite(m_encoded.data(), 1, m_encoded.size(), file) == m_encoded.size();
+    ok = fclose(file) == 0 && ok;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (ok) m_stats.bytes_written += (double)m_encoded.size();
+    return ok;
+}
+
+// ----- PNG ----- //
+// Deflate with the fixed Huffman codes and one kind of match: a copy from
+// four bytes back, which repeats the previous pixel. Each row of the image
+// is unfiltered, so a run stops at the end of its row.
+namespace
+{
+    struct BitWriter
+    {
+        std::vector<unsigned char>& out;
+        uint32_t bits;
+        int      count;
+
+        void put(uint32_t value, int length)
+        {
+            bits |= value << count;
+            count += length;
+            while (count >= 8)
+            {
+                out.push_back((unsigned char)bits);
+                bits >>= 8;
+                count -= 8;
+            }
+        }
+
+        // Huffman codes go in most significant bit first
+        void put_code(uint32_t code, int length)
+        {
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; i++) reversed |= ((code >> i) & 1) << (length - 1 - i);
+            put(reversed, length);
+        }
+
+        void flush()
+        {
+            if (count > 0) out.push_back((unsigned char)bits);
+            bits = 0;
+            count = 0;
+        }
+    };
+
+    void put_literal(BitWriter& writer, int symbol)
+    {
+        if (symbol < 144)      writer.put_code(0x30 + symbol, 8);
+        else if (symbol < 256) writer.put_code(0x190 + symbol - 144, 9);
+        else if (symbol < 280) writer.put_code(symbol - 256, 7);
+        else                   writer.put_code(0xC0 + symbol - 280, 8);
+    }
+
+    // length is 3 to 258
+    void put_match(BitWriter& writer, int length)
+    {
+        static const int BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static const int EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+        int code = 28;
+        while (BASE[code] > length) code--;
+
+        put_literal(writer, 257 + code);
+        writer.put(length - BASE[code], EXTRA[code]);
+        writer.put_code(3, 5);      // distance 4
+    }
+
+    uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size)
+    {
+        static uint32_t table[256];
+        static bool built = false;
+        if (!built)
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; bit++) value = value & 1 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                table[i] = value;
+            }
+            built = true;
+        }
+
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    void put_u32(std::vector<unsigned char>& out, uint32_t value)
+    {
+        out.push_back((unsigned char)(value >> 24));
+        out.push_back((unsigned char)(value >> 16));
+        out.push_back((unsigned char)(value >> 8));
+        out.push_back((unsigned char)value);
+    }
+
+    // Length, type, data, then the CRC of type and data
+    void finish_chunk(std::vector<unsigned char>& out, size_t chunk_start)
+    {
+        size_t data_size = out.size() - chunk_start - 8;
+        out[chunk_start] = (unsigned char)(data_size >> 24);
+        out[chunk_start + 1] = (unsigned char)(data_size >> 16);
+        out[chunk_start + 2] = (unsigned char)(data_size >> 8);
+        out[chunk_start + 3] = (unsigned char)data_size;
+        put_u32(out, crc32(0, out.data() + chunk_start + 4, data_size + 4));
+    }
+
+    size_t begin_chunk(std::vector<unsigned char>& out, const char* type)
+    {
+        size_t chunk_start = out.size();
+        put_u32(out, 0);
+        out.insert(out.end(), type, type + 4);
+        return chunk_start;
+    }
+}
+
+void encode_png(std::vector<unsigned char>& out, int width, int height, const unsigned char* rows, ptrdiff_t row_stride)
+{
+    static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.assign(SIGNATURE, SIGNATURE + sizeof(SIGNATURE));
+
+    size_t chunk = begin_chunk(out, "IHDR");
+    put_u32(out, (uint32_t)width);
+    put_u32(out, (uint32_t)height);
+    const unsigned char header[5] = { 8, 6, 0, 0, 0 };     // 8 bits per channel, RGBA
+    out.insert(out.end(), header, header + sizeof(header));
+    finish_chunk(out, chunk);
+
+    chunk = begin_chunk(out, "IDAT");
+    out.push_back(0x78);        // zlib: deflate, 32K window
+    out.push_back(0x01);
+
+    BitWriter writer = { out, 0, 0 };
+    writer.put(1, 1);           // the only block
+    writer.put(1, 2);           // fixed codes
+
+    uint32_t adler_a = 1, adler_b = 0;
+    int row_bytes = width * 4;
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char* row = rows + row_stride * y;
+
+        put_literal(writer, 0);     // filter: none
+        adler_b = (adler_b + adler_a) % 65521;
+
+        int x = 0;
+        while (x < row_bytes)
+        {
+            int length = 0;
+            if (x >= 4)
+            {
+                while (length < 258 && x + length < row_bytes && row[x + length] == row[x + length - 4]) length++;
+            }
+
+            if (length >= 3) {
+                put_match(writer, length);
+            }
+            else {
+                length = 1;
+                put_literal(writer, row[x]);
+            }
+
+            for (int i = 0; i < length; i++)
+            {
+                adler_a = (adler_a + row[x + i]) % 65521;
+                adler_b = (adler_b + adler_a) % 65521;
+            }
+            x += length;
+        }
+    }
+
+    put_literal(writer, 256);       // end of block
+    writer.flush();
+    put_u32(out, adler_b << 16 | adler_a);
+    finish_chunk(out, chunk);
+
+    chunk = begin_chunk(out, "IEND");
+    finish_chunk(out, chunk);
+}
+
+bool write_png(const char* path, int width, int height, const unsigned char* rows, ptrdiff_t row_stride)
+{
+    std::vector<unsigned char> encoded;
+    encode_png(encoded, width, height, rows, row_stride);
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+    bool ok = fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,128 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpriteBatch.h"
+
+enum FrameCaptureFormat
+{
+    CAPTURE_RAW,    // every frame appended to one frames.rgba file, top row first
+    CAPTURE_PNG     // frame_000000.png, frame_000001.png, ...
+};
+
+struct FrameCaptureStats
+{
+    int    captured;            // frames read back so far
+    int    written;
+    int    failed;              // frames the writer could not save
+    double readback_ms;         // GL thread: mapping a finished transfer and copying it out
+    double max_readback_ms;
+    int    readback_stalls;     // maps that found their transfer still running
+    int    writer_waits;        // end_frame() calls that had to wait for the writer to free a buffer
+    double writer_wait_ms;
+    double write_ms;            // writer thread: encoding and writing
+    double bytes_written;
+};
+
+// Renders frames into an offscreen framebuffer and streams them to disk
+// without stalling the GL thread.
+//
+// Drawing between begin_frame() and end_frame() lands in the capture's own
+// framebuffer. end_frame() starts an asynchronous glReadPixels into the next
+// pixel buffer object of a small ring. A buffer is only mapped when its slot
+// comes round again, ring_size frames later, so the map never waits for
+// the frame just drawn. The pixels are copied into a free buffer and
+// handed to a writer thread, which flips them upright and saves them.
+//
+// Every frame is kept: when the writer falls behind by more than its
+// buffers, end_frame() waits for it rather than dropping one. Call
+// finish() after the last frame to read back the ones still in the ring.
+class FrameCapture
+{
+public:
+    static constexpr int DEFAULT_RING_SIZE = 3,
+        DEFAULT_BUFFER_COUNT = 8;
+
+private:
+    struct Frame
+    {
+        std::vector<unsigned char> pixels;  // bottom row first, as GL returns them
+        int number;
+    };
+
+    int m_width = 0,
+        m_height = 0;
+    FrameCaptureFormat m_format = CAPTURE_RAW;
+    char m_directory[512] = "";
+
+    GLuint m_framebuffer = 0,
+        m_colour_buffer = 0;
+
+    std::vector<GLuint> m_pixel_buffers;
+    std::vector<GLsync> m_fences;       // one per pixel buffer, set when its read is issued
+    int m_frames_issued = 0,
+        m_frames_read = 0;
+
+    // ----- WRITER ----- //
+    std::thread m_writer;
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_queued_changed,
+        m_free_changed;
+    std::vector<Frame>      m_frames;
+    std::deque<int>         m_free,     // indices into m_frames
+        m_queued;
+    bool m_stopping = false;
+
+    FILE* m_raw_file = nullptr;
+    std::vector<unsigned char> m_encoded;   // writer thread's scratch space
+
+    FrameCaptureStats m_stats = {};
+
+    void read_back(int slot);
+    void write();
+    bool write_frame(const Frame& frame);
+
+public:
+    // ----- METHODS ----- //
+    // directory has to exist already. Needs a current GL context with
+    // framebuffer objects and pixel buffer objects (GL 2.1 plus
+    // ARB_framebuffer_object, or GL 3.0).
+    bool initialise(int width, int height, const char* directory, FrameCaptureFormat format,
+        int ring_size = DEFAULT_RING_SIZE, int buffer_count = DEFAULT_BUFFER_COUNT);
+
+    // Waits for the writer to save everything it was given
+    void shutdown();
+
+    // Binds the capture framebuffer and sets the viewport to cover it
+    void begin_frame();
+    // Queues the frame's readback and unbinds the framebuffer
+    void end_frame();
+    // Reads back the frames still in flight, after the last end_frame()
+    void finish();
+
+    // Copies the last captured frame onto the window's framebuffer, for
+    // recording a game that is also being shown
+    void blit_to_window() const;
+
+    // ----- GETTERS ----- //
+    int get_width()  const { return m_width; }
+    int get_height() const { return m_height; }
+    FrameCaptureStats get_stats() const;
+};
+
+// Writes an 8-bit RGBA PNG. row_stride is the byte distance from one row
+// to the next, negative for pixels stored bottom row first (pass the
+// address of the last row then). The only compression is runs of repeated
+// pixels, which is most of what a frame of this game holds.
+bool write_png(const char* path, int width, int height, const unsigned char* rows, ptrdiff_t row_stride);
+
+// The same, into a buffer instead of a file
+void encode_png(std::vector<unsigned char>& out, int width, int height, const unsigned char* rows, ptrdiff_t row_stride);
+
+#endif // FRAME_CAPTURE_H
@@ -0,0 +1,32 @@
+#ifndef GAME_ASSETS_H
+#define GAME_ASSETS_H
+
+// Every file the game loads, shared by main.cpp and the asset packer
+// (asset_packer_main.cpp), which puts all of them in ASSET_PACK_FILEPATH
+
+constexpr char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
+F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+
+constexpr char SPRITESHEET_FILEPATH[] = "assets/lunarLander.png";
+constexpr char BLOCK_FILEPATH[] = "assets/block.png";
+constexpr char PLATFORM_FILEPATH[] = "assets/platform.png";
+constexpr char FONTSHEET_FILEPATH[] = "assets/font1.png";
+constexpr char FLAME_FILEPATH[] = "assets/flame.png";
+
+constexpr char BGM_FILEPATH[] = "assets/crypto.mp3",
+SFX_FILEPATH[] = "assets/bounce.wav";
+
+// Every sprite lives in one atlas; these are their slots in it
+enum AtlasSprite { ATLAS_BLOCK, ATLAS_PLATFORM, ATLAS_FONT, ATLAS_LANDER, ATLAS_FLAME, ATLAS_SPRITE_COUNT };
+const char* const ATLAS_SOURCES[ATLAS_SPRITE_COUNT] = {
+    BLOCK_FILEPATH, PLATFORM_FILEPATH, FONTSHEET_FILEPATH, SPRITESHEET_FILEPATH, FLAME_FILEPATH
+};
+
+// Stored as they are, next to the atlas
+const char* const PACKED_FILES[] = { V_SHADER_PATH, F_SHADER_PATH, BGM_FILEPATH, SFX_FILEPATH };
+constexpr int PACKED_FILE_COUNT = sizeof(PACKED_FILES) / sizeof(PACKED_FILES[0]);
+
+constexpr char ASSET_PACK_FILEPATH[] = "assets.pack";
+constexpr char ATLAS_PACK_NAME[] = "atlas";     // the packed atlas's entry in the pack
+
+#endif // GAME_ASSETS_H
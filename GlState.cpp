@@ -0,0 +1,165 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "GlState.h"
+
+// No GL call returns this as a name, so nothing compares equal to it
+constexpr GLuint UNKNOWN_NAME = 0xFFFFFFFFu;
+
+GlState::GlState()
+{
+    invalidate();
+}
+
+GlState& GlState::get()
+{
+    static GlState state;
+    return state;
+}
+
+void GlState::invalidate()
+{
+    m_program = m_texture = m_array_buffer = m_element_buffer = UNKNOWN_NAME;
+    m_attribs_known = m_attribs_enabled = 0;
+    m_program_count = 0;
+}
+
+void GlState::begin_frame()
+{
+    m_last_frame = m_stats;
+    m_stats = GlStateStats();
+}
+
+// Counts the call either way and says whether it can be dropped
+bool GlState::is_set(bool same, GlCallKind kind)
+{
+    if (m_caching && same)
+    {
+        m_stats.elided[kind]++;
+        return true;
+    }
+    m_stats.issued[kind]++;
+    return false;
+}
+
+void GlState::use_program(ShaderProgram* program)
+{
+    GLuint program_id = program->get_program_id();
+    if (is_set(program_id == m_program, CALL_USE_PROGRAM)) return;
+
+    glUseProgram(program_id);
+    m_program = program_id;
+}
+
+GlState::ProgramMatrices* GlState::matrices_for(const ShaderProgram* program)
+{
+    for (int i = 0; i < m_program_count; i++)
+    {
+        if (m_matrices[i].program == program) return &m_matrices[i];
+    }
+    // Past MAX_PROGRAMS, the matrices of the rest are always uploaded
+    if (m_program_count == MAX_PROGRAMS) return nullptr;
+
+    ProgramMatrices& entry = m_matrices[m_program_count++];
+    entry.program = program;
+    entry.known = 0;
+    return &entry;
+}
+
+void GlState::set_matrix(ShaderProgram* program, MatrixUniform which, const glm::mat4& matrix)
+{
+    use_program(program);
+
+    ProgramMatrices* entry = matrices_for(program);
+    unsigned bit = 1u << which;
+    bool same = entry != nullptr && (entry->known & bit) != 0 && entry->matrices[which] == matrix;
+    if (is_set(same, CALL_UNIFORM)) return;
+
+    switch (which)
+    {
+    case MATRIX_MODEL:      program->set_model_matrix(matrix); break;
+    case MATRIX_VIEW:       program->set_view_matrix(matrix); break;
+    case MATRIX_PROJECTION: program->set_projection_matrix(matrix); break;
+    default: break;
+    }
+
+    if (entry != nullptr)
+    {
+        entry->matrices[which] = matrix;
+        entry->known |= bit;
+    }
+}
+
+void GlState::bind_texture(GLuint texture_id)
+{
+    if (is_set(texture_id == m_texture, CALL_BIND_TEXTURE)) return;
+
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    m_texture = texture_id;
+}
+
+void GlState::bind_array_buffer(GLuint buffer)
+{
+    if (is_set(buffer == m_array_buffer, CALL_BIND_BUFFER)) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    m_array_buffer = buffer;
+}
+
+void GlState::bind_element_buffer(GLuint buffer)
+{
+    if (is_set(buffer == m_element_buffer, CALL_BIND_BUFFER)) return;
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    m_element_buffer = buffer;
+}
+
+void GlState::set_attrib_array(GLuint index, bool enabled)
+{
+    // Attributes past the mask are never shadowed
+    uint32_t bit = index < (GLuint)MAX_ATTRIBS ? 1u << index : 0u;
+    bool same = (m_attribs_known & bit) != 0 && ((m_attribs_enabled & bit) != 0) == enabled;
+    if (is_set(same, CALL_ATTRIB_ARRAY)) return;
+
+    if (enabled) glEnableVertexAttribArray(index);
+    else glDisableVertexAttribArray(index);
+
+    m_attribs_known |= bit;
+    if (enabled) m_attribs_enabled |= bit;
+    else m_attribs_enabled &= ~bit;
+}
+
+void GlState::enable_sprite_attribs(ShaderProgram* program)
+{
+    enable_attrib_array(program->get_position_attribute());
+    enable_attrib_array(program->get_tex_coordinate_attribute());
+}
+
+void GlState::draw_arrays(GLenum mode, GLint first, GLsizei count)
+{
+    glDrawArrays(mode, first, count);
+    m_stats.draw_calls++;
+}
+
+void GlState::draw_elements(GLenum mode, GLsizei count, GLenum type, const void* offset)
+{
+    glDrawElements(mode, count, type, offset);
+    m_stats.draw_calls++;
+}
+
+void GlState::forget_texture(GLuint texture_id)
+{
+    if (m_texture == texture_id) m_texture = UNKNOWN_NAME;
+}
+
+void GlState::forget_buffer(GLuint buffer)
+{
+    if (m_array_buffer == buffer) m_array_buffer = UNKNOWN_NAME;
+    if (m_element_buffer == buffer) m_element_buffer = UNKNOWN_NAME;
+}
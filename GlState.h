@@ -0,0 +1,127 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <cstdint>
+#include "glm/glm.hpp"
+#include "ShaderProgram.h"
+
+// The kinds of state change GlState filters
+enum GlCallKind
+{
+    CALL_USE_PROGRAM,
+    CALL_BIND_TEXTURE,
+    CALL_BIND_BUFFER,
+    CALL_ATTRIB_ARRAY,  // enabling or disabling a vertex attribute array
+    CALL_UNIFORM,       // a ShaderProgram matrix setter
+    CALL_KIND_COUNT
+};
+
+struct GlStateStats
+{
+    int issued[CALL_KIND_COUNT];    // passed on to the driver
+    int elided[CALL_KIND_COUNT];    // dropped: the state was already set
+    int draw_calls;
+
+    int get_issued() const { int total = 0; for (int count : issued) total += count; return total; }
+    int get_elided() const { int total = 0; for (int count : elided) total += count; return total; }
+};
+
+// A shadow of the GL state the renderers change every frame: the program
+// in use, the texture bound to unit 0, the array and element buffers, which
+// vertex attribute arrays are enabled and the matrices last given to each
+// program. A call that would set what is already set is dropped before it
+// reaches the driver.
+//
+// Every draw in the game feeds the same two attributes, so once enabled
+// they stay enabled; code drawing from client memory binds buffer 0 before
+// pointing the attributes at it rather than relying on whoever drew last to
+// have unbound theirs.
+//
+// The shadow is only right while every change of that state goes through
+// here, so GL code anywhere in the game binds through it too, and reports
+// the textures and buffers it deletes (a deleted name that was bound reads
+// back as 0 and may be handed out again). After state is changed behind its
+// back (a new context, a library drawing), call invalidate().
+//
+// Like the GL context, it belongs to the thread that renders.
+class GlState
+{
+public:
+    static constexpr int MAX_PROGRAMS = 4,      // whose matrices are remembered
+        MAX_ATTRIBS = 32;
+
+private:
+    enum MatrixUniform { MATRIX_MODEL, MATRIX_VIEW, MATRIX_PROJECTION, MATRIX_COUNT };
+
+    struct ProgramMatrices
+    {
+        const ShaderProgram* program;
+        glm::mat4 matrices[MATRIX_COUNT];
+        unsigned  known;                        // a bit per MatrixUniform
+    };
+
+    bool m_caching = true;
+
+    GLuint m_program,
+        m_texture,
+        m_array_buffer,
+        m_element_buffer;
+    uint32_t m_attribs_known,
+        m_attribs_enabled;
+    ProgramMatrices m_matrices[MAX_PROGRAMS];
+    int m_program_count;
+
+    GlStateStats m_stats = {};
+    GlStateStats m_last_frame = {};
+
+    GlState();
+
+    bool is_set(bool same, GlCallKind kind);
+    ProgramMatrices* matrices_for(const ShaderProgram* program);
+    void set_matrix(ShaderProgram* program, MatrixUniform which, const glm::mat4& matrix);
+    void set_attrib_array(GLuint index, bool enabled);
+
+public:
+    static GlState& get();
+
+    // ----- METHODS ----- //
+    // Forgets everything; the next call for each piece of state is issued
+    void invalidate();
+    // With caching off every call is issued (and still counted), to compare
+    // against
+    void set_caching(bool caching) { m_caching = caching; }
+
+    // Starts a new frame's counts; get_stats() then returns the frame before
+    void begin_frame();
+
+    void use_program(ShaderProgram* program);
+    // Each makes the program current first, as ShaderProgram's uniforms
+    // apply to the program in use
+    void set_model_matrix(ShaderProgram* program, const glm::mat4& matrix)      { set_matrix(program, MATRIX_MODEL, matrix); }
+    void set_view_matrix(ShaderProgram* program, const glm::mat4& matrix)       { set_matrix(program, MATRIX_VIEW, matrix); }
+    void set_projection_matrix(ShaderProgram* program, const glm::mat4& matrix) { set_matrix(program, MATRIX_PROJECTION, matrix); }
+
+    void bind_texture(GLuint texture_id);
+    void bind_array_buffer(GLuint buffer);
+    void bind_element_buffer(GLuint buffer);
+
+    void enable_attrib_array(GLuint index)  { set_attrib_array(index, true); }
+    void disable_attrib_array(GLuint index) { set_attrib_array(index, false); }
+    // Both attributes of the sprite shader
+    void enable_sprite_attribs(ShaderProgram* program);
+
+    // Never filtered; counted so the stats show what the state changes buy
+    void draw_arrays(GLenum mode, GLint first, GLsizei count);
+    void draw_elements(GLenum mode, GLsizei count, GLenum type, const void* offset);
+
+    // Call before deleting a texture or buffer that may be bound
+    void forget_texture(GLuint texture_id);
+    void forget_buffer(GLuint buffer);
+
+    // ----- GETTERS ----- //
+    // Counts for the last whole frame
+    const GlStateStats& get_stats() const { return m_last_frame; }
+    bool is_caching() const { return m_caching; }
+};
+
+#endif // GL_STATE_H
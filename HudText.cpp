@@ -0,0 +1,219 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <cstdio>
+#include "GlState.h"
+#include "HudText.h"
+
+void format_hud_number(char* out, float value)
+{
+    // std::to_string(float) formats with "%f"; the HUD only ever showed the first few characters
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%f", value);
+
+    int length = 0;
+    while (length < HudText::NUMBER_LENGTH && buffer[length] != '\0')
+    {
+        out[length] = buffer[length];
+        length++;
+    }
+    out[length] = '\0';
+}
+
+void HudText::set_font(GLuint font_texture_id, const UvRect& font_rect)
+{
+    m_font_texture_id = font_texture_id;
+    m_font_rect = font_rect;
+}
+
+int HudText::add_run(int capacity, float font_size, float spacing, glm::vec3 position)
+{
+    Run run;
+    run.first_glyph = (int)m_characters.size();
+    run.capacity = capacity;
+    run.length = 0;
+    run.font_size = font_size;
+    run.spacing = spacing;
+    run.position = position;
+    run.visible = true;
+    m_runs.push_back(run);
+
+    // '\0' never matches a real character, so every slot is written on first use
+    m_characters.resize(m_characters.size() + capacity, '\0');
+    m_vertices.resize(m_vertices.size() + capacity * VERTICES_PER_GLYPH * FLOATS_PER_VERTEX, 0.0f);
+
+    return (int)m_runs.size() - 1;
+}
+
+glm::vec3 HudText::get_position_after(int run, int characters) const
+{
+    const Run& label = m_runs[run];
+    return label.position + glm::vec3((label.font_size + label.spacing) * characters, 0.0f, 0.0f);
+}
+
+void HudText::initialise()
+{
+    glGenBuffers(1, &m_vertex_buffer);
+    GlState::get().bind_array_buffer(m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(float), m_vertices.data(), GL_DYNAMIC_DRAW);
+}
+
+void HudText::shutdown()
+{
+    GlState::get().forget_buffer(m_vertex_buffer);
+    glDeleteBuffers(1, &m_vertex_buffer);
+    m_vertex_buffer = 0;
+}
+
+void HudText::write_glyph(const Run& run, int index, char character)
+{
+    // Same quad and UV layout as draw_text, with the run position baked in
+    float width = (m_font_rect.u1 - m_font_rect.u0) / FONTBANK_SIZE;
+    float height = (m_font_rect.v1 - m_font_rect.v0) / FONTBANK_SIZE;
+
+    int spritesheet_index = (int)(unsigned char)character;
+    float u = m_font_rect.u0 + (spritesheet_index % FONTBANK_SIZE) * width;
+    float v = m_font_rect.v0 + (spritesheet_index / FONTBANK_SIZE) * height;
+
+    float offset = (run.font_size + run.spacing) * index;
+    float left = run.position.x + offset - 0.5f * run.font_size;
+    float right = run.position.x + offset + 0.5f * run.font_size;
+    float top = run.position.y + 0.5f * run.font_size;
+    float bottom = run.position.y - 0.5f * run.font_size;
+
+    const float quad[VERTICES_PER_GLYPH * FLOATS_PER_VERTEX] = {
+        left,  top,    u,         v,
+        left,  bottom, u,         v + height,
+        right, top,    u + width, v,
+        right, bottom, u + width, v + height,
+        right, top,    u + width, v,
+        left,  bottom, u,         v + height,
+    };
+
+    int glyph = run.first_glyph + index;
+    float* destination = &m_vertices[glyph * VERTICES_PER_GLYPH * FLOATS_PER_VERTEX];
+    for (int i = 0; i < VERTICES_PER_GLYPH * FLOATS_PER_VERTEX; i++) destination[i] = quad[i];
+
+    m_characters[glyph] = character;
+
+    if (m_dirty_last < m_dirty_first)
+    {
+        m_dirty_first = m_dirty_last = glyph;
+    }
+    else {
+        if (glyph < m_dirty_first) m_dirty_first = glyph;
+        if (glyph > m_dirty_last) m_dirty_last = glyph;
+    }
+    m_stats.glyphs_rewritten++;
+}
+
+void HudText::set_text(int run_index, const char* text)
+{
+    Run& run = m_runs[run_index];
+
+    int length = 0;
+    while (length < run.capacity && text[length] != '\0')
+    {
+        // Slots past the old length may still hold this character's quad from earlier
+        if (m_characters[run.first_glyph + length] != text[length]) write_glyph(run, length, text[length]);
+        length++;
+    }
+    run.length = length;
+}
+
+void HudText::set_number(int run, float value)
+{
+    char text[NUMBER_LENGTH + 1];
+    format_hud_number(text, value);
+    set_text(run, text);
+}
+
+void HudText::draw(ShaderProgram* program)
+{
+    GlState& gl = GlState::get();
+    gl.bind_array_buffer(m_vertex_buffer);
+
+    if (m_dirty_last >= m_dirty_first)
+    {
+        int floats_per_glyph = VERTICES_PER_GLYPH * FLOATS_PER_VERTEX;
+        int bytes = (m_dirty_last - m_dirty_first + 1) * floats_per_glyph * (int)sizeof(float);
+
+        glBufferSubData(GL_ARRAY_BUFFER, m_dirty_first * floats_per_glyph * sizeof(float), bytes,
+            &m_vertices[m_dirty_first * floats_per_glyph]);
+
+        m_stats.bytes_uploaded = bytes;
+        m_dirty_first = 0;
+        m_dirty_last = -1;
+    }
+
+    gl.set_model_matrix(program, glm::mat4(1.0f));
+
+    GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (const void*)0);
+    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride,
+        (const void*)(2 * sizeof(float)));
+    gl.enable_sprite_attribs(program);
+
+    gl.bind_texture(m_font_texture_id);
+
+    for (size_t i = 0; i < m_runs.size(); i++)
+    {
+        const Run& run = m_runs[i];
+        if (!run.visible || run.length == 0) continue;
+
+        gl.draw_arrays(GL_TRIANGLES, run.first_glyph * VERTICES_PER_GLYPH, run.length * VERTICES_PER_GLYPH);
+        m_stats.draw_calls++;
+    }
+
+    m_last_frame = m_stats;
+    m_stats = HudTextStats();
+}
+
+void build_text_vertices(std::vector<float>& vertices, std::vector<float>& texture_coordinates,
+    const std::string& text, float font_size, float spacing, const UvRect& font_rect)
+{
+    // Scale the size of the fontbank in the UV-plane
+    // We will use this for spacing and positioning
+    float width = (font_rect.u1 - font_rect.u0) / HudText::FONTBANK_SIZE;
+    float height = (font_rect.v1 - font_rect.v0) / HudText::FONTBANK_SIZE;
+
+    vertices.clear();
+    texture_coordinates.clear();
+
+    // For every character...
+    for (int i = 0; i < (int)text.size(); i++) {
+        // 1. Get their index in the spritesheet, as well as their offset (i.e. their
+        //    position relative to the whole sentence)
+        int spritesheet_index = (int)text[i];  // ascii value of character
+        float offset = (font_size + spacing) * i;
+
+        // 2. Using the spritesheet index, we can calculate our U- and V-coordinates
+        float u_coordinate = font_rect.u0 + (spritesheet_index % HudText::FONTBANK_SIZE) * width;
+        float v_coordinate = font_rect.v0 + (spritesheet_index / HudText::FONTBANK_SIZE) * height;
+
+        // 3. Inset the current pair in both vectors
+        vertices.insert(vertices.end(), {
+            offset + (-0.5f * font_size), 0.5f * font_size,
+            offset + (-0.5f * font_size), -0.5f * font_size,
+            offset + (0.5f * font_size), 0.5f * font_size,
+            offset + (0.5f * font_size), -0.5f * font_size,
+            offset + (0.5f * font_size), 0.5f * font_size,
+            offset + (-0.5f * font_size), -0.5f * font_size,
+            });
+
+        texture_coordinates.insert(texture_coordinates.end(), {
+            u_coordinate, v_coordinate,
+            u_coordinate, v_coordinate + height,
+            u_coordinate + width, v_coordinate,
+            u_coordinate + width, v_coordinate + height,
+            u_coordinate + width, v_coordinate,
+            u_coordinate, v_coordinate + height,
+            });
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef HUD_TEXT_H
+#define HUD_TEXT_H
+
+#include <string>
+#include <vector>
+#include "glm/glm.hpp"
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+
+struct HudTextStats
+{
+    int glyphs_rewritten;   // glyph quads whose character changed this frame
+    int bytes_uploaded;
+    int draw_calls;
+};
+
+// Heads-up display text kept in one persistent vertex buffer. Each piece of
+// text is a run with a fixed position and a fixed glyph capacity, laid out
+// once. Changing a run's text only rewrites the glyphs whose character
+// actually changed, and the frame uploads just the dirty span. Nothing in
+// set_text/set_number/draw touches the heap once the runs are added.
+class HudText
+{
+private:
+    struct Run
+    {
+        int   first_glyph;
+        int   capacity;
+        int   length;
+        float font_size;
+        float spacing;
+        glm::vec3 position;
+        bool  visible;
+    };
+
+    std::vector<Run>   m_runs;
+    std::vector<char>  m_characters;    // current character of every glyph slot
+    std::vector<float> m_vertices;      // x, y, u, v; six vertices per glyph slot
+
+    GLuint m_vertex_buffer = 0;
+    GLuint m_font_texture_id = 0;
+    UvRect m_font_rect = FULL_TEXTURE;
+
+    int m_dirty_first = 0,              // glyph range waiting for upload
+        m_dirty_last = -1;
+
+    HudTextStats m_stats = {};
+    HudTextStats m_last_frame = {};
+
+    void write_glyph(const Run& run, int index, char character);
+
+public:
+    static constexpr int FLOATS_PER_VERTEX = 4,
+        VERTICES_PER_GLYPH = 6,
+        FONTBANK_SIZE = 16,
+        NUMBER_LENGTH = 4;
+
+    // ----- METHODS ----- //
+    void set_font(GLuint font_texture_id, const UvRect& font_rect);
+
+    // Runs are laid out like draw_text: glyph i sits (font_size + spacing) * i
+    // to the right of position. Add every run before initialise().
+    int  add_run(int capacity, float font_size, float spacing, glm::vec3 position);
+
+    void initialise();
+    void shutdown();
+
+    void set_text(int run, const char* text);
+    void set_number(int run, float value);
+    void set_visible(int run, bool visible) { m_runs[run].visible = visible; }
+
+    void draw(ShaderProgram* program);
+
+    // Glyph offset just past the end of a label run, for a value run that follows it
+    glm::vec3 get_position_after(int run, int characters) const;
+
+    // ----- GETTERS ----- //
+    const HudTextStats& get_stats() const { return m_last_frame; }
+};
+
+// Writes value the way std::to_string(value).substr(0, NUMBER_LENGTH) did,
+// into a caller-provided buffer of at least NUMBER_LENGTH + 1 chars
+void format_hud_number(char* out, float value);
+
+// The per-string arrays draw_text hands to OpenGL: six vertices per
+// character, laid out from the origin, with UVs inside font_rect. Both
+// vectors are cleared first.
+void build_text_vertices(std::vector<float>& vertices, std::vector<float>& texture_coordinates,
+    const std::string& text, float font_size, float spacing, const UvRect& font_rect);
+
+#endif // HUD_TEXT_H
@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "InputLog.h"
+
+// Version 1 logs were all one screen wide and have no screen count
+static const char INPUT_LOG_MAGIC[4] = { 'L', 'L', 'I', '2' },
+    INPUT_LOG_MAGIC_V1[4] = { 'L', 'L', 'I', '1' };
+
+enum InputBit { INPUT_LEFT = 1, INPUT_RIGHT = 2, INPUT_UP = 4 };
+
+void InputLog::begin(unsigned seed, int screen_count)
+{
+    m_seed = seed;
+    m_screen_count = screen_count;
+    m_end_tick = 0;
+    m_final_hash = 0;
+    m_record_count = 0;
+    m_last_tick = 0;
+    m_last_bits = 0;
+    m_bytes.clear();
+
+    // About ten minutes of constant input at 60 frames a second
+    m_bytes.reserve(1 << 16);
+}
+
+void InputLog::record(uint32_t tick, const TickInput& input)
+{
+    uint8_t bits = (input.left ? INPUT_LEFT : 0) | (input.right ? INPUT_RIGHT : 0) | (input.up ? INPUT_UP : 0);
+
+    // Idle after idle only clears a flame that is already off
+    if (bits == 0 && m_last_bits == 0) return;
+
+    uint32_t delta = tick - m_last_tick;
+    while (delta >= 0x80)
+    {
+        m_bytes.push_back((uint8_t)(delta | 0x80));
+        delta >>= 7;
+    }
+    m_bytes.push_back((uint8_t)delta);
+    m_bytes.push_back(bits);
+
+    m_last_tick = tick;
+    m_last_bits = bits;
+    m_record_count++;
+}
+
+void InputLog::finish(uint32_t end_tick, uint64_t final_hash)
+{
+    m_end_tick = end_tick;
+    m_final_hash = final_hash;
+}
+
+bool InputLog::next_record(InputLogCursor& cursor, InputRecord& record) const
+{
+    if (cursor.offset >= m_bytes.size()) return false;
+
+    uint32_t delta = 0;
+    int shift = 0;
+    while (cursor.offset < m_bytes.size())
+    {
+        uint8_t byte = m_bytes[cursor.offset++];
+        delta |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+        shift += 7;
+    }
+    if (cursor.offset >= m_bytes.size()) return false;
+
+    uint8_t bits = m_bytes[cursor.offset++];
+
+    cursor.tick += delta;
+    record.tick = cursor.tick;
+    record.input.left = (bits & INPUT_LEFT) != 0;
+    record.input.right = (bits & INPUT_RIGHT) != 0;
+    record.input.up = (bits & INPUT_UP) != 0;
+    return true;
+}
+
+bool InputLog::save(const char* path) const
+{
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    uint32_t header[5] = { m_seed, m_end_tick, m_record_count, (uint32_t)m_bytes.size(), (uint32_t)m_screen_count };
+
+    bool ok = fwrite(INPUT_LOG_MAGIC, sizeof(INPUT_LOG_MAGIC), 1, file) == 1 &&
+        fwrite(header, sizeof(header), 1, file) == 1 &&
+        fwrite(&m_final_hash, sizeof(m_final_hash), 1, file) == 1 &&
+        fwrite(m_bytes.data(), 1, m_bytes.size(), file) == m_bytes.size();
+
+    fclose(file);
+    return ok;
+}
+
+bool InputLog::load(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    char magic[4];
+    uint32_t header[5] = { 0, 0, 0, 0, 1 };
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1;
+    bool v1 = ok && memcmp(magic, INPUT_LOG_MAGIC_V1, sizeof(magic)) == 0;
+    ok = ok && (v1 || memcmp(magic, INPUT_LOG_MAGIC, sizeof(magic)) == 0) &&
+        fread(header, sizeof(uint32_t), v1 ? 4 : 5, file) == (v1 ? 4u : 5u) &&
+        header[4] >= 1 && header[4] <= (uint32_t)MAX_SCREEN_COUNT &&
+        fread(&m_final_hash, sizeof(m_final_hash), 1, file) == 1;
+
+    if (ok)
+    {
+        m_seed = header[0];
+        m_screen_count = (int)header[4];
+        m_end_tick = header[1];
+        m_record_count = header[2];
+        m_bytes.resize(header[3]);
+        ok = fread(m_bytes.data(), 1, m_bytes.size(), file) == m_bytes.size();
+    }
+
+    fclose(file);
+    return ok;
+}
+
+uint64_t replay_input_log(const InputLog& log, Terrain& terrain, World& world, FILE* trace)
+{
+    // Same draw from rand() as initialise()
+    srand(log.get_seed());
+    build_wide_terrain(terrain, log.get_screen_count(), rand() % 20 + 1);
+    reset_world(world, &terrain, log.get_screen_count());
+
+    InputLogCursor cursor;
+    InputRecord record;
+    bool pending = log.next_record(cursor, record);
+
+    while (true)
+    {
+        while (pending && record.tick == world.tick)
+        {
+            apply_input(world, record.input);
+            pending = log.next_record(cursor, record);
+        }
+
+        if (world.tick >= log.get_end_tick()) break;
+
+        tick_world(world);
+        if (trace) fprintf(trace, "%u %016llx\n", world.tick, (unsigned long long)hash_world(world));
+    }
+
+    return hash_world(world);
+}
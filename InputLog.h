@@ -0,0 +1,72 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Simulation.h"
+
+struct InputRecord
+{
+    uint32_t  tick;     // world tick the input was sampled before
+    TickInput input;
+};
+
+// Where next_record() is in the log; start from a default-constructed one
+struct InputLogCursor
+{
+    size_t   offset = 0;
+    uint32_t tick = 0;
+};
+
+// Everything needed to fly a recorded game again: the seed the level was
+// built from, how many screens wide it was, and every sampled input, keyed
+// by the fixed tick it was applied before. Several samples can share a tick
+// (frames shorter than a tick still poll the keyboard and still burn fuel),
+// so they are all kept in order.
+//
+// Each record is a varint tick delta plus one byte of input bits. A sample
+// with no keys held after another one with no keys held changes nothing,
+// so those are not stored and idle stretches cost no space at all.
+class InputLog
+{
+private:
+    unsigned m_seed = 0;
+    int      m_screen_count = 1;
+    uint32_t m_end_tick = 0;
+    uint64_t m_final_hash = 0;
+
+    uint32_t m_record_count = 0;
+    uint32_t m_last_tick = 0;
+    uint8_t  m_last_bits = 0;
+    std::vector<uint8_t> m_bytes;
+
+public:
+    // ----- RECORDING ----- //
+    void begin(unsigned seed, int screen_count = 1);
+    void record(uint32_t tick, const TickInput& input);
+    // The final hash lets a replay tell at a glance whether it ended in the same state
+    void finish(uint32_t end_tick, uint64_t final_hash);
+
+    bool save(const char* path) const;
+    bool load(const char* path);
+
+    // ----- PLAYBACK ----- //
+    bool next_record(InputLogCursor& cursor, InputRecord& record) const;
+
+    // ----- GETTERS ----- //
+    unsigned get_seed()         const { return m_seed; }
+    int      get_screen_count() const { return m_screen_count; }
+    uint32_t get_end_tick()     const { return m_end_tick; }
+    uint64_t get_final_hash()   const { return m_final_hash; }
+    uint32_t get_record_count() const { return m_record_count; }
+    size_t   get_byte_count()   const { return m_bytes.size(); }
+};
+
+// Rebuilds the level from the seed the way initialise() does, then flies
+// the recorded inputs through tick_world as fast as possible. When trace
+// is given, every tick writes "<tick> <hash>" to it. Returns the final
+// hash_world().
+uint64_t replay_input_log(const InputLog& log, Terrain& terrain, World& world, FILE* trace);
+
+#endif // INPUT_LOG_H
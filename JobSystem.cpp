@@ -0,0 +1,111 @@
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "JobSystem.h"
+
+namespace
+{
+    struct WorkQueue
+    {
+        std::mutex      mutex;
+        std::deque<int> jobs;
+    };
+
+    struct Run
+    {
+        std::vector<WorkQueue> queues;
+        std::atomic<int>       steals;
+        JobFunction            function;
+        void*                  context;
+
+        explicit Run(int thread_count) : queues(thread_count), steals(0) {}
+    };
+
+    bool pop_own(WorkQueue& queue, int& job)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) return false;
+
+        job = queue.jobs.back();
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    bool steal(WorkQueue& queue, int& job)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) return false;
+
+        job = queue.jobs.front();
+        queue.jobs.pop_front();
+        return true;
+    }
+
+    void work(Run& run, int worker)
+    {
+        int thread_count = (int)run.queues.size();
+        int job;
+
+        while (true)
+        {
+            if (pop_own(run.queues[worker], job))
+            {
+                run.function(job, worker, run.context);
+                continue;
+            }
+
+            // Jobs are never added once the run starts, so one empty pass
+            // over every queue means there is nothing left to take
+            bool stole = false;
+            for (int i = 1; i < thread_count && !stole; i++)
+            {
+                stole = steal(run.queues[(worker + i) % thread_count], job);
+            }
+            if (!stole) return;
+
+            run.steals++;
+            run.function(job, worker, run.context);
+        }
+    }
+}
+
+JobStats run_jobs(int job_count, int thread_count, JobFunction function, void* context)
+{
+    if (thread_count < 1) thread_count = 1;
+
+    auto start = std::chrono::steady_clock::now();
+
+    Run run(thread_count);
+    run.function = function;
+    run.context = context;
+
+    // Contiguous shares, popped from the back: the owner walks its share in
+    // reverse while thieves take the other end
+    for (int job = job_count - 1; job >= 0; job--)
+    {
+        int owner = (int)((long long)job * thread_count / job_count);
+        run.queues[owner].jobs.push_front(job);
+    }
+
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < thread_count; worker++)
+    {
+        threads.emplace_back(work, std::ref(run), worker);
+    }
+    work(run, 0);
+    for (std::thread& thread : threads) thread.join();
+
+    JobStats stats;
+    stats.thread_count = thread_count;
+    stats.steals = run.steals;
+    stats.run_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+int get_core_count()
+{
+    unsigned count = std::thread::hardware_concurrency();
+    return count > 0 ? (int)count : 1;
+}
@@ -0,0 +1,27 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <vector>
+
+typedef void (*JobFunction)(int job, int worker, void* context);
+
+struct JobStats
+{
+    int    thread_count;
+    int    steals;          // jobs a worker took from another worker's queue
+    double run_ms;
+};
+
+// Runs jobs 0..job_count-1 on thread_count threads (the calling thread is
+// worker 0) and returns when all of them are done.
+//
+// Every worker starts with a contiguous share of the jobs and works through
+// it from the back; a worker that runs dry steals from the front of another
+// worker's queue, so uneven jobs still finish together. Which worker runs a
+// job is not deterministic: jobs must only write to their own output slot.
+JobStats run_jobs(int job_count, int thread_count, JobFunction function, void* context);
+
+// std::thread::hardware_concurrency(), or 1 when it is unknown
+int get_core_count();
+
+#endif // JOB_SYSTEM_H
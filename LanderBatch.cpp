@@ -0,0 +1,426 @@
+#include "LanderBatch.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LANDER_BATCH_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LANDER_BATCH_LANES 4
+#else
+#define LANDER_BATCH_LANES 1
+#endif
+
+int LanderBatch::add(const Lander& lander)
+{
+    m_position_x.push_back(0.0f);
+    m_position_y.push_back(0.0f);
+    m_velocity_x.push_back(0.0f);
+    m_velocity_y.push_back(0.0f);
+    m_acceleration_x.push_back(0.0f);
+    m_acceleration_y.push_back(0.0f);
+    m_width.push_back(0.0f);
+    m_height.push_back(0.0f);
+    m_fuel.push_back(0.0f);
+    m_flags.push_back(0);
+
+    int index = size() - 1;
+    set(index, lander);
+    return index;
+}
+
+void LanderBatch::clear()
+{
+    m_position_x.clear();
+    m_position_y.clear();
+    m_velocity_x.clear();
+    m_velocity_y.clear();
+    m_acceleration_x.clear();
+    m_acceleration_y.clear();
+    m_width.clear();
+    m_height.clear();
+    m_fuel.clear();
+    m_flags.clear();
+}
+
+void LanderBatch::reserve(int capacity)
+{
+    m_position_x.reserve(capacity);
+    m_position_y.reserve(capacity);
+    m_velocity_x.reserve(capacity);
+    m_velocity_y.reserve(capacity);
+    m_acceleration_x.reserve(capacity);
+    m_acceleration_y.reserve(capacity);
+    m_width.reserve(capacity);
+    m_height.reserve(capacity);
+    m_fuel.reserve(capacity);
+    m_flags.reserve(capacity);
+}
+
+Lander LanderBatch::get(int index) const
+{
+    Lander lander;
+    lander.position = glm::vec3(m_position_x[index], m_position_y[index], 0.0f);
+    lander.velocity = glm::vec3(m_velocity_x[index], m_velocity_y[index], 0.0f);
+    lander.acceleration = glm::vec3(m_acceleration_x[index], m_acceleration_y[index], 0.0f);
+    lander.width = m_width[index];
+    lander.height = m_height[index];
+    lander.fuel = m_fuel[index];
+
+    uint32_t flags = m_flags[index];
+    lander.depleted = (flags & LANDER_DEPLETED) != 0;
+    lander.is_winner = (flags & LANDER_WINNER) != 0;
+    lander.is_loser = (flags & LANDER_LOSER) != 0;
+    lander.crash_land = (flags & LANDER_CRASH_LAND) != 0;
+    return lander;
+}
+
+void LanderBatch::set(int index, const Lander& lander)
+{
+    m_position_x[index] = lander.position.x;
+    m_position_y[index] = lander.position.y;
+    m_velocity_x[index] = lander.velocity.x;
+    m_velocity_y[index] = lander.velocity.y;
+    m_acceleration_x[index] = lander.acceleration.x;
+    m_acceleration_y[index] = lander.acceleration.y;
+    m_width[index] = lander.width;
+    m_height[index] = lander.height;
+    m_fuel[index] = lander.fuel;
+
+    uint32_t flags = m_flags[index] & LANDER_THRUSTING;
+    if (lander.depleted) flags |= LANDER_DEPLETED;
+    if (lander.is_winner) flags |= LANDER_WINNER;
+    if (lander.is_loser) flags |= LANDER_LOSER;
+    if (lander.crash_land) flags |= LANDER_CRASH_LAND;
+    m_flags[index] = flags;
+}
+
+void LanderBatch::apply_input(const TickInput* inputs)
+{
+    for (int i = 0; i < size(); i++)
+    {
+        // Same rules as apply_input(World&, ...): a depleted lander keeps its flame state
+        if (m_flags[i] & LANDER_DEPLETED) continue;
+
+        if (inputs[i].left)
+        {
+            m_fuel[i] -= LATERAL_FUEL_COST;
+            m_acceleration_x[i] = -LATERAL_ACCELERATION;
+        }
+        else if (inputs[i].right)
+        {
+            m_fuel[i] -= LATERAL_FUEL_COST;
+            m_acceleration_x[i] = LATERAL_ACCELERATION;
+        }
+        if (inputs[i].up)
+        {
+            m_fuel[i] -= THRUST_FUEL_COST;
+            m_acceleration_y[i] = THRUST_ACCELERATION;
+            m_flags[i] |= LANDER_THRUSTING;
+        }
+        else {
+            m_flags[i] &= ~LANDER_THRUSTING;
+        }
+    }
+}
+
+void LanderBatch::tick(const TickInput* inputs, const Block* blocks, int block_count)
+{
+    if (inputs != NULL) apply_input(inputs);
+
+    for (int i = 0; i < size(); i++)
+    {
+        if (m_fuel[i] <= 0.0f) {
+            m_fuel[i] = 0.0f;
+            m_flags[i] |= LANDER_DEPLETED;
+        }
+        if (m_position_x[i] > WRAP_LIMIT_X) {
+            m_position_x[i] = -m_position_x[i] + WRAP_OFFSET_X;
+        }
+        if (m_position_x[i] < -WRAP_LIMIT_X) {
+            m_position_x[i] = -m_position_x[i] - WRAP_OFFSET_X;
+        }
+    }
+
+    step(blocks, block_count, FIXED_TIMESTEP);
+}
+
+int LanderBatch::collide_landers(Broadphase& broadphase)
+{
+    if (broadphase.get_body_count() != size())
+    {
+        broadphase.clear();
+        for (int i = 0; i < size(); i++)
+            broadphase.add_body(glm::vec3(m_position_x[i], m_position_y[i], 0.0f), m_width[i], m_height[i]);
+    }
+    else {
+        for (int i = 0; i < size(); i++)
+            broadphase.move_body(i, glm::vec3(m_position_x[i], m_position_y[i], 0.0f), m_width[i], m_height[i]);
+    }
+
+    broadphase.update();
+
+    int contacts = 0;
+    const std::vector<BodyPair>& pairs = broadphase.get_pairs();
+    for (size_t p = 0; p < pairs.size(); p++)
+    {
+        int a = pairs[p].a, b = pairs[p].b;
+        if (!aabb_overlap(glm::vec3(m_position_x[a], m_position_y[a], 0.0f), m_width[a], m_height[a],
+            glm::vec3(m_position_x[b], m_position_y[b], 0.0f), m_width[b], m_height[b])) continue;
+
+        contacts++;
+        if (!(m_flags[a] & (LANDER_WINNER | LANDER_LOSER))) m_flags[a] |= LANDER_LOSER;
+        if (!(m_flags[b] & (LANDER_WINNER | LANDER_LOSER))) m_flags[b] |= LANDER_LOSER;
+    }
+
+    return contacts;
+}
+
+void LanderBatch::step(const Block* blocks, int block_count, float delta_time)
+{
+    int vector_end = size() - size() % LANDER_BATCH_LANES;
+
+    step_vector(0, vector_end, blocks, block_count, delta_time);
+    step_scalar(vector_end, size(), blocks, block_count, delta_time);
+}
+
+void LanderBatch::step_scalar(int first, int last, const Block* blocks, int block_count, float delta_time)
+{
+    for (int i = first; i < last; i++)
+    {
+        Lander lander = get(i);
+        step_lander(lander, blocks, block_count, delta_time);
+        set(i, lander);
+    }
+}
+
+#if LANDER_BATCH_LANES == 8
+
+// ----- AVX2 KERNEL ----- //
+// The horizontal damping constant is a double and the scalar code rounds
+// through it, so the damping step widens to two 4 x double halves.
+static inline __m256 damp_towards_zero(__m256 value, __m256 positive, __m256 negative)
+{
+    const __m256 ones = _mm256_set1_ps(1.0f);
+    __m256 direction = _mm256_or_ps(_mm256_and_ps(negative, ones),
+        _mm256_and_ps(positive, _mm256_set1_ps(-1.0f)));
+
+    __m256d step = _mm256_set1_pd(HORIZONTAL_DAMPING);
+    __m256d low = _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(value)),
+        _mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(direction)), step));
+    __m256d high = _mm256_add_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(value, 1)),
+        _mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(direction, 1)), step));
+
+    __m256 damped = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(low)), _mm256_cvtpd_ps(high), 1);
+
+    // Stop at zero instead of overshooting past it
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 overshot = _mm256_or_ps(_mm256_and_ps(positive, _mm256_cmp_ps(damped, zero, _CMP_LT_OQ)),
+        _mm256_and_ps(negative, _mm256_cmp_ps(damped, zero, _CMP_GT_OQ)));
+    damped = _mm256_blendv_ps(damped, zero, overshot);
+
+    return _mm256_blendv_ps(value, damped, _mm256_or_ps(positive, negative));
+}
+
+void LanderBatch::step_vector(int first, int last, const Block* blocks, int block_count, float delta_time)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 dt = _mm256_set1_ps(delta_time);
+
+    for (int i = first; i < last; i += 8)
+    {
+        __m256 px = _mm256_loadu_ps(&m_position_x[i]);
+        __m256 py = _mm256_loadu_ps(&m_position_y[i]);
+        __m256 vx = _mm256_loadu_ps(&m_velocity_x[i]);
+        __m256 vy = _mm256_loadu_ps(&m_velocity_y[i]);
+        __m256 ax = _mm256_loadu_ps(&m_acceleration_x[i]);
+        __m256 ay = _mm256_loadu_ps(&m_acceleration_y[i]);
+        __m256 width = _mm256_loadu_ps(&m_width[i]);
+        __m256 height = _mm256_loadu_ps(&m_height[i]);
+
+        // ----- COLLISIONS ----- //
+        // The first block hit in array order decides the outcome, as in step_lander
+        __m256 hit = zero;
+        __m256 hit_platform = zero;
+        for (int b = 0; b < block_count; b++)
+        {
+            __m256 x_distance = _mm256_sub_ps(
+                _mm256_and_ps(_mm256_sub_ps(px, _mm256_set1_ps(blocks[b].position.x)), abs_mask),
+                _mm256_mul_ps(_mm256_add_ps(width, _mm256_set1_ps(blocks[b].width)), half));
+            __m256 y_distance = _mm256_sub_ps(
+                _mm256_and_ps(_mm256_sub_ps(py, _mm256_set1_ps(blocks[b].position.y)), abs_mask),
+                _mm256_mul_ps(_mm256_add_ps(height, _mm256_set1_ps(blocks[b].height)), half));
+
+            __m256 overlap = _mm256_and_ps(_mm256_cmp_ps(x_distance, zero, _CMP_LT_OQ),
+                _mm256_cmp_ps(y_distance, zero, _CMP_LT_OQ));
+            __m256 first_hit = _mm256_andnot_ps(hit, overlap);
+
+            if (blocks[b].is_platform) hit_platform = _mm256_or_ps(hit_platform, first_hit);
+            hit = _mm256_or_ps(hit, first_hit);
+        }
+
+        if (_mm256_movemask_ps(hit))
+        {
+            __m256 landed = _mm256_and_ps(hit_platform,
+                _mm256_cmp_ps(vy, _mm256_set1_ps(LANDING_SPEED_LIMIT), _CMP_GT_OQ));
+            __m256 crashed = _mm256_andnot_ps(landed, hit_platform);
+            __m256 lost = _mm256_andnot_ps(landed, hit);
+
+            __m256i flags = _mm256_loadu_si256((const __m256i*)&m_flags[i]);
+            flags = _mm256_or_si256(flags, _mm256_and_si256(_mm256_castps_si256(landed), _mm256_set1_epi32(LANDER_WINNER)));
+            flags = _mm256_or_si256(flags, _mm256_and_si256(_mm256_castps_si256(lost), _mm256_set1_epi32(LANDER_LOSER)));
+            flags = _mm256_or_si256(flags, _mm256_and_si256(_mm256_castps_si256(crashed), _mm256_set1_epi32(LANDER_CRASH_LAND)));
+            _mm256_storeu_si256((__m256i*)&m_flags[i], flags);
+        }
+
+        // ----- INTEGRATION ----- //
+        __m256 new_ax = damp_towards_zero(ax,
+            _mm256_cmp_ps(ax, zero, _CMP_GT_OQ), _mm256_cmp_ps(ax, zero, _CMP_LT_OQ));
+
+        __m256 new_ay = _mm256_blendv_ps(ay, _mm256_set1_ps(MAX_ACCELERATION_Y),
+            _mm256_cmp_ps(ay, _mm256_set1_ps(MAX_ACCELERATION_Y), _CMP_GT_OQ));
+        new_ay = _mm256_blendv_ps(_mm256_sub_ps(new_ay, _mm256_set1_ps(ACCELERATION_Y_DECAY)),
+            _mm256_set1_ps(MIN_ACCELERATION_Y),
+            _mm256_cmp_ps(new_ay, _mm256_set1_ps(MIN_ACCELERATION_Y), _CMP_LT_OQ));
+
+        __m256 coasting = _mm256_cmp_ps(new_ax, zero, _CMP_EQ_OQ);
+        __m256 new_vx = damp_towards_zero(vx,
+            _mm256_and_ps(coasting, _mm256_cmp_ps(vx, zero, _CMP_GT_OQ)),
+            _mm256_and_ps(coasting, _mm256_cmp_ps(vx, zero, _CMP_LT_OQ)));
+
+        new_vx = _mm256_add_ps(new_vx, _mm256_mul_ps(new_ax, dt));
+        __m256 new_vy = _mm256_add_ps(vy, _mm256_mul_ps(new_ay, dt));
+        __m256 new_px = _mm256_add_ps(px, _mm256_mul_ps(new_vx, dt));
+        __m256 new_py = _mm256_add_ps(py, _mm256_mul_ps(new_vy, dt));
+
+        // Landers touching something do not move this tick
+        _mm256_storeu_ps(&m_position_x[i], _mm256_blendv_ps(new_px, px, hit));
+        _mm256_storeu_ps(&m_position_y[i], _mm256_blendv_ps(new_py, py, hit));
+        _mm256_storeu_ps(&m_velocity_x[i], _mm256_blendv_ps(new_vx, vx, hit));
+        _mm256_storeu_ps(&m_velocity_y[i], _mm256_blendv_ps(new_vy, vy, hit));
+        _mm256_storeu_ps(&m_acceleration_x[i], _mm256_blendv_ps(new_ax, ax, hit));
+        _mm256_storeu_ps(&m_acceleration_y[i], _mm256_blendv_ps(new_ay, ay, hit));
+    }
+}
+
+const char* LanderBatch::get_kernel_name() { return "avx2"; }
+
+#elif LANDER_BATCH_LANES == 4
+
+// ----- SSE2 KERNEL ----- //
+// SSE2 has no blendv, so lanes are picked with and/andnot/or
+static inline __m128 select(__m128 mask, __m128 if_true, __m128 if_false)
+{
+    return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+}
+
+static inline __m128 damp_towards_zero(__m128 value, __m128 positive, __m128 negative)
+{
+    __m128 direction = _mm_or_ps(_mm_and_ps(negative, _mm_set1_ps(1.0f)),
+        _mm_and_ps(positive, _mm_set1_ps(-1.0f)));
+
+    __m128d step = _mm_set1_pd(HORIZONTAL_DAMPING);
+    __m128d low = _mm_add_pd(_mm_cvtps_pd(value), _mm_mul_pd(_mm_cvtps_pd(direction), step));
+    __m128d high = _mm_add_pd(_mm_cvtps_pd(_mm_movehl_ps(value, value)),
+        _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(direction, direction)), step));
+
+    __m128 damped = _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high));
+
+    // Stop at zero instead of overshooting past it
+    const __m128 zero = _mm_setzero_ps();
+    __m128 overshot = _mm_or_ps(_mm_and_ps(positive, _mm_cmplt_ps(damped, zero)),
+        _mm_and_ps(negative, _mm_cmpgt_ps(damped, zero)));
+    damped = select(overshot, zero, damped);
+
+    return select(_mm_or_ps(positive, negative), damped, value);
+}
+
+void LanderBatch::step_vector(int first, int last, const Block* blocks, int block_count, float delta_time)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 dt = _mm_set1_ps(delta_time);
+
+    for (int i = first; i < last; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(&m_position_x[i]);
+        __m128 py = _mm_loadu_ps(&m_position_y[i]);
+        __m128 vx = _mm_loadu_ps(&m_velocity_x[i]);
+        __m128 vy = _mm_loadu_ps(&m_velocity_y[i]);
+        __m128 ax = _mm_loadu_ps(&m_acceleration_x[i]);
+        __m128 ay = _mm_loadu_ps(&m_acceleration_y[i]);
+        __m128 width = _mm_loadu_ps(&m_width[i]);
+        __m128 height = _mm_loadu_ps(&m_height[i]);
+
+        // ----- COLLISIONS ----- //
+        __m128 hit = zero;
+        __m128 hit_platform = zero;
+        for (int b = 0; b < block_count; b++)
+        {
+            __m128 x_distance = _mm_sub_ps(
+                _mm_and_ps(_mm_sub_ps(px, _mm_set1_ps(blocks[b].position.x)), abs_mask),
+                _mm_mul_ps(_mm_add_ps(width, _mm_set1_ps(blocks[b].width)), half));
+            __m128 y_distance = _mm_sub_ps(
+                _mm_and_ps(_mm_sub_ps(py, _mm_set1_ps(blocks[b].position.y)), abs_mask),
+                _mm_mul_ps(_mm_add_ps(height, _mm_set1_ps(blocks[b].height)), half));
+
+            __m128 overlap = _mm_and_ps(_mm_cmplt_ps(x_distance, zero), _mm_cmplt_ps(y_distance, zero));
+            __m128 first_hit = _mm_andnot_ps(hit, overlap);
+
+            if (blocks[b].is_platform) hit_platform = _mm_or_ps(hit_platform, first_hit);
+            hit = _mm_or_ps(hit, first_hit);
+        }
+
+        if (_mm_movemask_ps(hit))
+        {
+            __m128 landed = _mm_and_ps(hit_platform, _mm_cmpgt_ps(vy, _mm_set1_ps(LANDING_SPEED_LIMIT)));
+            __m128 crashed = _mm_andnot_ps(landed, hit_platform);
+            __m128 lost = _mm_andnot_ps(landed, hit);
+
+            __m128i flags = _mm_loadu_si128((const __m128i*)&m_flags[i]);
+            flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(landed), _mm_set1_epi32(LANDER_WINNER)));
+            flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(lost), _mm_set1_epi32(LANDER_LOSER)));
+            flags = _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(crashed), _mm_set1_epi32(LANDER_CRASH_LAND)));
+            _mm_storeu_si128((__m128i*)&m_flags[i], flags);
+        }
+
+        // ----- INTEGRATION ----- //
+        __m128 new_ax = damp_towards_zero(ax, _mm_cmpgt_ps(ax, zero), _mm_cmplt_ps(ax, zero));
+
+        __m128 new_ay = select(_mm_cmpgt_ps(ay, _mm_set1_ps(MAX_ACCELERATION_Y)), _mm_set1_ps(MAX_ACCELERATION_Y), ay);
+        new_ay = select(_mm_cmplt_ps(new_ay, _mm_set1_ps(MIN_ACCELERATION_Y)), _mm_set1_ps(MIN_ACCELERATION_Y),
+            _mm_sub_ps(new_ay, _mm_set1_ps(ACCELERATION_Y_DECAY)));
+
+        __m128 coasting = _mm_cmpeq_ps(new_ax, zero);
+        __m128 new_vx = damp_towards_zero(vx,
+            _mm_and_ps(coasting, _mm_cmpgt_ps(vx, zero)), _mm_and_ps(coasting, _mm_cmplt_ps(vx, zero)));
+
+        new_vx = _mm_add_ps(new_vx, _mm_mul_ps(new_ax, dt));
+        __m128 new_vy = _mm_add_ps(vy, _mm_mul_ps(new_ay, dt));
+        __m128 new_px = _mm_add_ps(px, _mm_mul_ps(new_vx, dt));
+        __m128 new_py = _mm_add_ps(py, _mm_mul_ps(new_vy, dt));
+
+        // Landers touching something do not move this tick
+        _mm_storeu_ps(&m_position_x[i], select(hit, px, new_px));
+        _mm_storeu_ps(&m_position_y[i], select(hit, py, new_py));
+        _mm_storeu_ps(&m_velocity_x[i], select(hit, vx, new_vx));
+        _mm_storeu_ps(&m_velocity_y[i], select(hit, vy, new_vy));
+        _mm_storeu_ps(&m_acceleration_x[i], select(hit, ax, new_ax));
+        _mm_storeu_ps(&m_acceleration_y[i], select(hit, ay, new_ay));
+    }
+}
+
+const char* LanderBatch::get_kernel_name() { return "sse2"; }
+
+#else
+
+void LanderBatch::step_vector(int first, int last, const Block* blocks, int block_count, float delta_time)
+{
+    step_scalar(first, last, blocks, block_count, delta_time);
+}
+
+const char* LanderBatch::get_kernel_name() { return "scalar"; }
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef LANDER_BATCH_H
+#define LANDER_BATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "Broadphase.h"
+#include "Simulation.h"
+
+// ----- FLAGS ----- //
+enum LanderFlag : uint32_t
+{
+    LANDER_DEPLETED = 1u << 0,
+    LANDER_WINNER = 1u << 1,
+    LANDER_LOSER = 1u << 2,
+    LANDER_CRASH_LAND = 1u << 3,
+    LANDER_THRUSTING = 1u << 4
+};
+
+// Thousands of landers stepped together. Every field lives in its own
+// contiguous array so the step kernel can work on 8 (AVX2) or 4 (SSE2)
+// landers per instruction. Landers stay in the z = 0 plane, so only x and y
+// are stored.
+//
+// step()/tick() give the same results as step_lander()/tick_lander() on each
+// lander, bit for bit, as long as the compiler is not allowed to fuse
+// multiply-adds (-ffp-contract=off) on either path. The kernels only know
+// the per-tick damping and decay, so step() takes FIXED_TIMESTEP.
+class LanderBatch
+{
+private:
+    std::vector<float> m_position_x, m_position_y;
+    std::vector<float> m_velocity_x, m_velocity_y;
+    std::vector<float> m_acceleration_x, m_acceleration_y;
+    std::vector<float> m_width, m_height;
+    std::vector<float> m_fuel;
+    std::vector<uint32_t> m_flags;
+
+    void step_scalar(int first, int last, const Block* blocks, int block_count, float delta_time);
+    void step_vector(int first, int last, const Block* blocks, int block_count, float delta_time);
+
+public:
+    // ----- METHODS ----- //
+    int  add(const Lander& lander);
+    void clear();
+    void reserve(int capacity);
+
+    Lander get(int index) const;
+    void   set(int index, const Lander& lander);
+
+    void apply_input(const TickInput* inputs);
+    void step(const Block* blocks, int block_count, float delta_time);
+
+    // Batch equivalent of apply_input + tick_lander for every lander;
+    // inputs may be NULL for a tick without input
+    void tick(const TickInput* inputs, const Block* blocks, int block_count);
+
+    // Lander-to-lander contacts: candidate pairs come from the broadphase
+    // and are confirmed with aabb_overlap. A lander still in flight that
+    // touches another one is lost, as if it had hit a rock. Returns the
+    // number of touching pairs.
+    int collide_landers(Broadphase& broadphase);
+
+    // ----- GETTERS ----- //
+    int      size()                const { return (int)m_position_x.size(); }
+    uint32_t get_flags(int index)  const { return m_flags[index]; }
+
+    static const char* get_kernel_name();
+};
+
+#endif // LANDER_BATCH_H
@@ -0,0 +1,117 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <cstring>
+#include "OffscreenContext.h"
+
+#ifdef _WIN32
+
+bool OffscreenContext::initialise() { return false; }
+void OffscreenContext::shutdown() {}
+
+#else
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+static bool has_extension(const char* extensions, const char* name)
+{
+    if (extensions == NULL) return false;
+
+    size_t length = strlen(name);
+    for (const char* found = strstr(extensions, name); found != NULL; found = strstr(found + length, name))
+    {
+        bool starts = found == extensions || found[-1] == ' ';
+        bool ends = found[length] == ' ' || found[length] == '\0';
+        if (starts && ends) return true;
+    }
+    return false;
+}
+
+bool OffscreenContext::initialise()
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // Client extensions are queried without a display
+    const char* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (has_extension(client_extensions, "EGL_MESA_platform_surfaceless"))
+    {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (get_platform_display != NULL) {
+            display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        }
+    }
+    if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) return false;
+    m_display = display;
+
+    // The shaders are desktop GLSL, so not a GLES context
+    const EGLint config_attributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint config_count = 0;
+    if (!eglBindAPI(EGL_OPENGL_API) ||
+        !eglChooseConfig(display, config_attributes, &config, 1, &config_count) || config_count == 0)
+    {
+        shutdown();
+        return false;
+    }
+
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+    if (context == EGL_NO_CONTEXT)
+    {
+        shutdown();
+        return false;
+    }
+    m_context = context;
+
+    // Everything is drawn into framebuffer objects, so a surface is only
+    // made for drivers that cannot make a context current without one
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (!has_extension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+    {
+        const EGLint surface_attributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, surface_attributes);
+        m_surface = surface;
+    }
+
+    if (!eglMakeCurrent(display, surface, surface, context))
+    {
+        shutdown();
+        return false;
+    }
+    return true;
+}
+
+void OffscreenContext::shutdown()
+{
+    if (m_display == nullptr) return;
+
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_surface != nullptr) eglDestroySurface(m_display, m_surface);
+    if (m_context != nullptr) eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+
+    m_display = m_context = m_surface = nullptr;
+}
+
+#endif
+
+const char* OffscreenContext::get_renderer() const
+{
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    return renderer != NULL ? (const char*)renderer : "none";
+}
@@ -0,0 +1,28 @@
+#ifndef OFFSCREEN_CONTEXT_H
+#define OFFSCREEN_CONTEXT_H
+
+// A desktop OpenGL context with no window and no display server behind it,
+// for rendering on build machines and servers. It comes from EGL: Mesa's
+// surfaceless platform where there is one (llvmpipe renders on the CPU, so
+// no GPU is needed either), else the default display. The context has no
+// usable default framebuffer; draw into a FrameCapture.
+//
+// Not available on Windows, where initialise() fails.
+class OffscreenContext
+{
+private:
+    void* m_display = nullptr;      // EGLDisplay
+    void* m_context = nullptr;      // EGLContext
+    void* m_surface = nullptr;      // EGLSurface; only when the driver needs one to make a context current
+
+public:
+    // ----- METHODS ----- //
+    bool initialise();
+    void shutdown();
+
+    // ----- GETTERS ----- //
+    // GL_RENDERER of the current context, "llvmpipe (LLVM ...)" on Mesa's software rasteriser
+    const char* get_renderer() const;
+};
+
+#endif // OFFSCREEN_CONTEXT_H
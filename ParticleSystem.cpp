@@ -0,0 +1,310 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <chrono>
+#include <vector>
+#include "GlState.h"
+#include "ParticleSystem.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PARTICLE_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLE_LANES 4
+#else
+#define PARTICLE_LANES 1
+#endif
+
+// Capacity is rounded up to this many slots, so the integrator never needs
+// a scalar tail: the slots past get_count() are stepped too and ignored
+constexpr int PARTICLE_PADDING = 8;
+constexpr int PARTICLE_FLOAT_ARRAYS = 8;
+
+static double milliseconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int padded(int capacity)
+{
+    return (capacity + PARTICLE_PADDING - 1) / PARTICLE_PADDING * PARTICLE_PADDING;
+}
+
+size_t ParticleSystem::get_arena_bytes(int capacity)
+{
+    size_t slots = (size_t)padded(capacity);
+    size_t vertex_floats = slots * VERTICES_PER_PARTICLE * FLOATS_PER_VERTEX;
+
+    // Plus a cache line per array for alignment
+    return PARTICLE_FLOAT_ARRAYS * (slots * sizeof(float) + 64) + (slots + 64) + (vertex_floats * sizeof(float) + 64);
+}
+
+bool ParticleSystem::initialise(Arena& arena, int capacity)
+{
+    int slots = padded(capacity);
+    size_t mark = arena.get_mark();
+
+    float** arrays[PARTICLE_FLOAT_ARRAYS] = {
+        &m_position_x, &m_position_y, &m_velocity_x, &m_velocity_y, &m_gravity, &m_age, &m_lifetime, &m_size
+    };
+    bool ok = true;
+    for (int i = 0; i < PARTICLE_FLOAT_ARRAYS; i++)
+    {
+        *arrays[i] = arena.allocate_array<float>(slots);
+        ok = ok && *arrays[i] != nullptr;
+    }
+    m_sprite = arena.allocate_array<uint8_t>(slots);
+    m_vertices = arena.allocate_array<float>(slots * VERTICES_PER_PARTICLE * FLOATS_PER_VERTEX);
+
+    m_count = 0;
+    m_stats = {};
+    m_last_frame = {};
+    if (!ok || !m_sprite || !m_vertices)
+    {
+        arena.rewind(mark);
+        m_capacity = 0;
+        return false;
+    }
+
+    // The padding slots are stepped along with the live ones; give them
+    // finite values once so they never turn into NaNs or denormals
+    for (int i = 0; i < PARTICLE_FLOAT_ARRAYS; i++)
+    {
+        for (int j = 0; j < slots; j++) (*arrays[i])[j] = 0.0f;
+    }
+
+    m_capacity = capacity;
+    return true;
+}
+
+void ParticleSystem::create_buffers()
+{
+    // The index pattern of every quad is the same, so it is written once
+    std::vector<GLuint> indices((size_t)m_capacity * INDICES_PER_PARTICLE);
+    for (int i = 0; i < m_capacity; i++)
+    {
+        GLuint first = (GLuint)i * VERTICES_PER_PARTICLE;
+        GLuint* quad = &indices[(size_t)i * INDICES_PER_PARTICLE];
+        quad[0] = first;
+        quad[1] = first + 1;
+        quad[2] = first + 2;
+        quad[3] = first;
+        quad[4] = first + 2;
+        quad[5] = first + 3;
+    }
+
+    GlState& gl = GlState::get();
+    glGenBuffers(1, &m_index_buffer);
+    gl.bind_element_buffer(m_index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &m_vertex_buffer);
+    gl.bind_array_buffer(m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)m_capacity * VERTICES_PER_PARTICLE * FLOATS_PER_VERTEX * sizeof(float),
+        NULL, GL_STREAM_DRAW);
+}
+
+void ParticleSystem::shutdown()
+{
+    GlState::get().forget_buffer(m_vertex_buffer);
+    GlState::get().forget_buffer(m_index_buffer);
+    glDeleteBuffers(1, &m_vertex_buffer);
+    glDeleteBuffers(1, &m_index_buffer);
+    m_vertex_buffer = m_index_buffer = 0;
+}
+
+int ParticleSystem::add_sprite(const UvRect& uv)
+{
+    if (m_sprite_count == MAX_SPRITES) return -1;
+
+    m_sprites[m_sprite_count] = uv;
+    return m_sprite_count++;
+}
+
+// ----- SPAWNING ----- //
+// xorshift32, mapped to [-1, 1); particles only draw, so the sequence
+// does not need to be anything in particular
+float ParticleSystem::random_signed()
+{
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return (float)(m_random >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+int ParticleSystem::emit(const ParticleSpawn& spawn, int count)
+{
+    int room = m_capacity - m_count;
+    int added = count < room ? count : room;
+    int sprite = spawn.sprite >= 0 && spawn.sprite < m_sprite_count ? spawn.sprite : 0;
+
+    for (int k = 0; k < added; k++)
+    {
+        int i = m_count++;
+        m_position_x[i] = spawn.position.x + spawn.position_jitter * random_signed();
+        m_position_y[i] = spawn.position.y + spawn.position_jitter * random_signed();
+        m_velocity_x[i] = spawn.velocity.x + spawn.velocity_jitter.x * random_signed();
+        m_velocity_y[i] = spawn.velocity.y + spawn.velocity_jitter.y * random_signed();
+        m_gravity[i] = spawn.gravity;
+        m_age[i] = 0.0f;
+        m_lifetime[i] = spawn.lifetime + spawn.lifetime_jitter * random_signed();
+        m_size[i] = spawn.size;
+        m_sprite[i] = (uint8_t)sprite;
+    }
+
+    m_stats.spawned += added;
+    m_stats.dropped += count - added;
+    return added;
+}
+
+// ----- UPDATE ----- //
+#if PARTICLE_LANES == 8
+
+void ParticleSystem::integrate(float delta_time)
+{
+    const __m256 dt = _mm256_set1_ps(delta_time);
+    for (int i = 0; i < m_count; i += 8)
+    {
+        __m256 velocity_x = _mm256_load_ps(m_velocity_x + i);
+        __m256 velocity_y = _mm256_add_ps(_mm256_load_ps(m_velocity_y + i), _mm256_mul_ps(_mm256_load_ps(m_gravity + i), dt));
+
+        _mm256_store_ps(m_velocity_y + i, velocity_y);
+        _mm256_store_ps(m_position_x + i, _mm256_add_ps(_mm256_load_ps(m_position_x + i), _mm256_mul_ps(velocity_x, dt)));
+        _mm256_store_ps(m_position_y + i, _mm256_add_ps(_mm256_load_ps(m_position_y + i), _mm256_mul_ps(velocity_y, dt)));
+        _mm256_store_ps(m_age + i, _mm256_add_ps(_mm256_load_ps(m_age + i), dt));
+    }
+}
+
+const char* ParticleSystem::get_kernel_name() { return "avx2"; }
+
+#elif PARTICLE_LANES == 4
+
+void ParticleSystem::integrate(float delta_time)
+{
+    const __m128 dt = _mm_set1_ps(delta_time);
+    for (int i = 0; i < m_count; i += 4)
+    {
+        __m128 velocity_x = _mm_load_ps(m_velocity_x + i);
+        __m128 velocity_y = _mm_add_ps(_mm_load_ps(m_velocity_y + i), _mm_mul_ps(_mm_load_ps(m_gravity + i), dt));
+
+        _mm_store_ps(m_velocity_y + i, velocity_y);
+        _mm_store_ps(m_position_x + i, _mm_add_ps(_mm_load_ps(m_position_x + i), _mm_mul_ps(velocity_x, dt)));
+        _mm_store_ps(m_position_y + i, _mm_add_ps(_mm_load_ps(m_position_y + i), _mm_mul_ps(velocity_y, dt)));
+        _mm_store_ps(m_age + i, _mm_add_ps(_mm_load_ps(m_age + i), dt));
+    }
+}
+
+const char* ParticleSystem::get_kernel_name() { return "sse2"; }
+
+#else
+
+void ParticleSystem::integrate(float delta_time)
+{
+    for (int i = 0; i < m_count; i++)
+    {
+        m_velocity_y[i] += m_gravity[i] * delta_time;
+        m_position_x[i] += m_velocity_x[i] * delta_time;
+        m_position_y[i] += m_velocity_y[i] * delta_time;
+        m_age[i] += delta_time;
+    }
+}
+
+const char* ParticleSystem::get_kernel_name() { return "scalar"; }
+
+#endif
+
+void ParticleSystem::update(float delta_time)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    integrate(delta_time);
+
+    // Expired particles are replaced by the last live one, which is then
+    // checked in turn; nothing else moves
+    for (int i = 0; i < m_count; )
+    {
+        if (m_age[i] < m_lifetime[i])
+        {
+            i++;
+            continue;
+        }
+
+        int last = --m_count;
+        m_position_x[i] = m_position_x[last];
+        m_position_y[i] = m_position_y[last];
+        m_velocity_x[i] = m_velocity_x[last];
+        m_velocity_y[i] = m_velocity_y[last];
+        m_gravity[i] = m_gravity[last];
+        m_age[i] = m_age[last];
+        m_lifetime[i] = m_lifetime[last];
+        m_size[i] = m_size[last];
+        m_sprite[i] = m_sprite[last];
+    }
+
+    double elapsed = milliseconds_since(start);
+    m_stats.update_ms = elapsed;
+    m_stats.total_update_ms += elapsed;
+    if (elapsed > m_stats.max_update_ms) m_stats.max_update_ms = elapsed;
+}
+
+// ----- DRAWING ----- //
+void ParticleSystem::draw(ShaderProgram* program)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Bottom left, bottom right, top right, top left, with the same UV
+    // orientation as SpriteBatch
+    float* vertex = m_vertices;
+    for (int i = 0; i < m_count; i++)
+    {
+        float half = 0.5f * m_size[i] * (1.0f - m_age[i] / m_lifetime[i]);
+        const UvRect& uv = m_sprites[m_sprite[i]];
+        float x0 = m_position_x[i] - half, x1 = m_position_x[i] + half,
+            y0 = m_position_y[i] - half, y1 = m_position_y[i] + half;
+
+        vertex[0] = x0;  vertex[1] = y0;  vertex[2] = uv.u0;  vertex[3] = uv.v1;
+        vertex[4] = x1;  vertex[5] = y0;  vertex[6] = uv.u1;  vertex[7] = uv.v1;
+        vertex[8] = x1;  vertex[9] = y1;  vertex[10] = uv.u1; vertex[11] = uv.v0;
+        vertex[12] = x0; vertex[13] = y1; vertex[14] = uv.u0; vertex[15] = uv.v0;
+        vertex += VERTICES_PER_PARTICLE * FLOATS_PER_VERTEX;
+    }
+    m_stats.build_ms = milliseconds_since(start);
+
+    if (m_count > 0 && m_vertex_buffer != 0)
+    {
+        size_t bytes = (size_t)m_count * VERTICES_PER_PARTICLE * FLOATS_PER_VERTEX * sizeof(float);
+
+        GlState& gl = GlState::get();
+        gl.bind_array_buffer(m_vertex_buffer);
+        // Orphan last frame's storage so the driver never waits on it
+        glBufferData(GL_ARRAY_BUFFER, (size_t)m_capacity * VERTICES_PER_PARTICLE * FLOATS_PER_VERTEX * sizeof(float),
+            NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_vertices);
+        gl.bind_element_buffer(m_index_buffer);
+
+        gl.set_model_matrix(program, glm::mat4(1.0f));
+
+        GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+        glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (const void*)0);
+        glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride,
+            (const void*)(2 * sizeof(float)));
+        gl.enable_sprite_attribs(program);
+
+        gl.bind_texture(m_texture_id);
+        gl.draw_elements(GL_TRIANGLES, m_count * INDICES_PER_PARTICLE, GL_UNSIGNED_INT, (const void*)0);
+    }
+
+    m_stats.live = m_count;
+    if (m_count > m_stats.peak_live) m_stats.peak_live = m_count;
+    m_stats.frames++;
+    m_last_frame = m_stats;
+    m_stats.spawned = 0;
+    m_stats.dropped = 0;
+}
@@ -0,0 +1,115 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <cstdint>
+#include "glm/glm.hpp"
+#include "Arena.h"
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+
+// One burst of particles. Every value is varied per particle by up to
+// +/- its jitter.
+struct ParticleSpawn
+{
+    glm::vec3 position;         // z is ignored
+    float     position_jitter;
+    glm::vec3 velocity;
+    glm::vec3 velocity_jitter;
+    float     lifetime, lifetime_jitter;
+    float     size;             // at birth; particles shrink to nothing over their life
+    float     gravity;          // vertical acceleration in m/s^2, negative is down
+    int       sprite;           // from add_sprite()
+};
+
+struct ParticleStats
+{
+    int    live;
+    int    spawned;             // since the previous draw()
+    int    dropped;             // since the previous draw(), because the pool was full
+    double update_ms;           // integrate and remove
+    double build_ms;            // write the vertices
+
+    // Since initialise()
+    int    peak_live;
+    int    frames;
+    double total_update_ms, max_update_ms;
+};
+
+// Short-lived sprites (exhaust, dust, debris) that only ever draw: they
+// take no part in the simulation and never collide.
+//
+// Particles live in a fixed-capacity pool carved out of an arena, one
+// array per field, dense from 0 to get_count(). update() steps every
+// particle at once (8 or 4 per instruction where AVX2 or SSE2 is
+// available) and then swap-removes the expired ones, so the order of the
+// particles changes. draw() writes one quad per particle into a persistent
+// vertex buffer and draws them all with a single call; every particle
+// shares one texture and picks its rectangle in it from a small table.
+class ParticleSystem
+{
+public:
+    static constexpr int MAX_SPRITES = 8,
+        FLOATS_PER_VERTEX = 4,
+        VERTICES_PER_PARTICLE = 4,
+        INDICES_PER_PARTICLE = 6;
+
+private:
+    float* m_position_x = nullptr;
+    float* m_position_y = nullptr;
+    float* m_velocity_x = nullptr;
+    float* m_velocity_y = nullptr;
+    float* m_gravity = nullptr;
+    float* m_age = nullptr;
+    float* m_lifetime = nullptr;
+    float* m_size = nullptr;
+    uint8_t* m_sprite = nullptr;
+
+    int m_capacity = 0,
+        m_count = 0;
+
+    uint32_t m_random = 0x9E3779B9u;
+
+    GLuint m_texture_id = 0;
+    UvRect m_sprites[MAX_SPRITES];
+    int    m_sprite_count = 0;
+
+    float* m_vertices = nullptr;        // x, y, u, v; four per particle
+    GLuint m_vertex_buffer = 0,
+        m_index_buffer = 0;
+
+    ParticleStats m_stats = {};
+    ParticleStats m_last_frame = {};
+
+    float random_signed();
+    void  integrate(float delta_time);
+
+public:
+    // ----- METHODS ----- //
+    // What initialise() carves out of its arena, vertex staging included
+    static size_t get_arena_bytes(int capacity);
+    bool initialise(Arena& arena, int capacity);
+
+    // GL side: the vertex buffer and the quads' shared index buffer
+    void create_buffers();
+    void shutdown();
+
+    void set_texture(GLuint texture_id) { m_texture_id = texture_id; }
+    int  add_sprite(const UvRect& uv);
+
+    // Returns how many particles were added; the rest did not fit
+    int  emit(const ParticleSpawn& spawn, int count);
+    void update(float delta_time);
+    void clear() { m_count = 0; }
+
+    void draw(ShaderProgram* program);
+
+    // ----- GETTERS ----- //
+    int get_count()    const { return m_count; }
+    int get_capacity() const { return m_capacity; }
+    // As of the most recent draw()
+    const ParticleStats& get_stats() const { return m_last_frame; }
+
+    static const char* get_kernel_name();
+};
+
+#endif // PARTICLE_SYSTEM_H
@@ -0,0 +1,128 @@
+#ifdef LUNAR_PROFILE
+
+#include <algorithm>
+#include <cstdio>
+#include "Profiler.h"
+
+static thread_local int t_ring = -1;
+
+Profiler::Profiler() : m_origin(std::chrono::steady_clock::now())
+{
+    m_trace.reserve(1 << 16);
+}
+
+Profiler& Profiler::get()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::record(const char* name, uint64_t start_ns, uint64_t end_ns)
+{
+    if (t_ring < 0)
+    {
+        int ring = m_thread_count.fetch_add(1);
+        if (ring >= MAX_THREADS)
+        {
+            m_dropped++;
+            return;
+        }
+        t_ring = ring;
+    }
+
+    ProfileEvent event = { name, start_ns, end_ns, t_ring };
+    if (!m_rings[t_ring].push(event)) m_dropped++;
+}
+
+Profiler::ScopeWindow* Profiler::find_scope(const char* name)
+{
+    for (int i = 0; i < m_scope_count; i++)
+    {
+        if (m_scopes[i].name == name) return &m_scopes[i];
+    }
+    if (m_scope_count == MAX_SCOPES) return nullptr;
+
+    ScopeWindow& scope = m_scopes[m_scope_count++];
+    scope.name = name;
+    scope.count = 0;
+    scope.next = 0;
+    return &scope;
+}
+
+void Profiler::collect()
+{
+    int thread_count = std::min(m_thread_count.load(), MAX_THREADS);
+
+    ProfileEvent event;
+    for (int ring = 0; ring < thread_count; ring++)
+    {
+        while (m_rings[ring].pop(event))
+        {
+            if (m_trace.size() < MAX_TRACE_EVENTS) m_trace.push_back(event);
+
+            ScopeWindow* scope = find_scope(event.name);
+            if (!scope) continue;
+
+            scope->samples_ms[scope->next] = (event.end_ns - event.start_ns) / 1e6f;
+            scope->next = (scope->next + 1) % WINDOW;
+            if (scope->count < WINDOW) scope->count++;
+        }
+    }
+}
+
+void Profiler::get_summary(int index, ProfileSummary& summary) const
+{
+    const ScopeWindow& scope = m_scopes[index];
+    summary.name = scope.name;
+    summary.samples = scope.count;
+    summary.min_ms = summary.avg_ms = summary.p99_ms = 0.0f;
+    if (scope.count == 0) return;
+
+    float sorted[WINDOW];
+    std::copy(scope.samples_ms, scope.samples_ms + scope.count, sorted);
+    std::sort(sorted, sorted + scope.count);
+
+    float total = 0.0f;
+    for (int i = 0; i < scope.count; i++) total += sorted[i];
+
+    summary.min_ms = sorted[0];
+    summary.avg_ms = total / scope.count;
+    summary.p99_ms = sorted[(scope.count * 99) / 100];
+}
+
+bool Profiler::write_csv(const char* path) const
+{
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "name,thread,start_us,duration_us\n");
+    for (const ProfileEvent& event : m_trace)
+    {
+        fprintf(file, "%s,%d,%.3f,%.3f\n", event.name, event.thread,
+            event.start_ns / 1000.0, (event.end_ns - event.start_ns) / 1000.0);
+    }
+
+    fclose(file);
+    return true;
+}
+
+bool Profiler::write_trace(const char* path) const
+{
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < m_trace.size(); i++)
+    {
+        const ProfileEvent& event = m_trace[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+            event.name, event.thread, event.start_ns / 1000.0, (event.end_ns - event.start_ns) / 1000.0,
+            i + 1 < m_trace.size() ? "," : "");
+    }
+    fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    fclose(file);
+    return true;
+}
+
+#endif // LUNAR_PROFILE
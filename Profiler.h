@@ -0,0 +1,114 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Scoped frame timers. Build with -DLUNAR_PROFILE to turn them on; without
+// it every PROFILE_* macro expands to nothing and none of the code below
+// is compiled, so an ordinary build carries no trace of the profiler.
+//
+//   PROFILE_SCOPE("update");      times the rest of the enclosing block
+//
+// Each thread records into its own lock-free ring; the main thread drains
+// them once a frame with Profiler::get().collect(), which keeps a rolling
+// window per scope for the overlay and the full event list for the dump.
+
+#ifdef LUNAR_PROFILE
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "SpscRing.h"
+
+struct ProfileEvent
+{
+    const char* name;       // string literal, compared by address
+    uint64_t    start_ns;   // since the profiler started
+    uint64_t    end_ns;
+    int         thread;
+};
+
+struct ProfileSummary
+{
+    const char* name;
+    float min_ms, avg_ms, p99_ms;
+    int   samples;
+};
+
+class Profiler
+{
+public:
+    static constexpr int RING_SIZE = 1 << 14,
+        MAX_THREADS = 4,
+        MAX_SCOPES = 32,
+        WINDOW = 240;               // samples per scope behind the overlay, four seconds of frames
+
+    static constexpr size_t MAX_TRACE_EVENTS = 1 << 20;
+
+private:
+    struct ScopeWindow
+    {
+        const char* name;
+        float samples_ms[WINDOW];
+        int   count, next;
+    };
+
+    std::chrono::steady_clock::time_point m_origin;
+
+    SpscRing<ProfileEvent, RING_SIZE> m_rings[MAX_THREADS];
+    std::atomic<int> m_thread_count{ 0 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+
+    ScopeWindow m_scopes[MAX_SCOPES];
+    int m_scope_count = 0;
+
+    std::vector<ProfileEvent> m_trace;
+
+    Profiler();
+    ScopeWindow* find_scope(const char* name);
+
+public:
+    static Profiler& get();
+
+    uint64_t now_ns() const
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_origin).count();
+    }
+
+    // Any thread; the first call from a thread claims a ring for it
+    void record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+    // Consumer side: call from one thread only
+    void collect();
+
+    int  get_scope_count() const { return m_scope_count; }
+    void get_summary(int scope, ProfileSummary& summary) const;
+    uint64_t get_dropped() const { return m_dropped.load(); }
+
+    // Every collected event, as CSV rows or as Chrome trace-event JSON
+    // (chrome://tracing, Perfetto)
+    bool write_csv(const char* path) const;
+    bool write_trace(const char* path) const;
+};
+
+class ProfileScope
+{
+private:
+    const char* m_name;
+    uint64_t    m_start_ns;
+
+public:
+    explicit ProfileScope(const char* name) : m_name(name), m_start_ns(Profiler::get().now_ns()) {}
+    ~ProfileScope() { Profiler::get().record(m_name, m_start_ns, Profiler::get().now_ns()); }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+
+#else
+
+#define PROFILE_SCOPE(name)
+
+#endif // LUNAR_PROFILE
+
+#endif // PROFILER_H
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cmath>
+#include "Profiler.h"
+#include "SimThread.h"
+
+uint64_t sim_clock_ns()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimThread::start(World* world, InputLog* log)
+{
+    m_world = world;
+    m_log = log;
+
+    // Readers get a valid snapshot before the first tick
+    publish();
+    m_snapshots.update();
+
+    m_running = true;
+    m_thread = std::thread(&SimThread::run, this);
+}
+
+void SimThread::stop()
+{
+    if (!m_running.exchange(false)) return;
+    m_thread.join();
+}
+
+void SimThread::push_event(const KeyEvent& event)
+{
+    if (!m_events.push(event)) m_events_dropped++;
+}
+
+const RenderSnapshot& SimThread::read_latest()
+{
+    m_snapshots.update();
+    return m_snapshots.front();
+}
+
+void SimThread::publish()
+{
+    RenderSnapshot& snapshot = m_snapshots.back();
+    snapshot.lander = m_world->lander;
+    snapshot.previous_position = m_world->previous_position;
+    snapshot.thrusting = m_world->thrusting;
+    snapshot.tick = m_world->tick;
+    snapshot.accumulator = m_world->accumulator;
+    snapshot.published_ns = sim_clock_ns();
+
+    m_snapshots.publish();
+    m_snapshot_count++;
+}
+
+TickInput SimThread::input_for_tick(const World& world, void* context)
+{
+    SimThread& self = *(SimThread*)context;
+
+    // The slice of time this tick stands for; dropped time moves every later tick along
+    uint64_t tick_ns = (uint64_t)(FIXED_TIMESTEP * 1e9f);
+    uint64_t start_ns = self.m_epoch_ns + world.tick * tick_ns + (uint64_t)(world.dropped_time * 1e9f);
+    uint64_t end_ns = start_ns + tick_ns;
+    uint64_t now_ns = sim_clock_ns();
+
+    KeyEvent event;
+    while (self.m_events.peek(event) && event.time_ns < end_ns)
+    {
+        self.m_events.pop(event);
+
+        bool& key = event.key == KEY_LEFT ? self.m_held.left : event.key == KEY_RIGHT ? self.m_held.right : self.m_held.up;
+        key = event.pressed;
+
+        uint64_t latency_ns = now_ns > event.time_ns ? now_ns - event.time_ns : 0;
+        int bucket = (int)(latency_ns / 1000000);
+        self.m_latency_histogram[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1]++;
+        self.m_latency_total_ns += latency_ns;
+        if (latency_ns > self.m_latency_max_ns) self.m_latency_max_ns = latency_ns;
+        if (event.time_ns < start_ns) self.m_late_events++;
+        self.m_key_events++;
+    }
+
+    if (self.m_log) self.m_log->record(world.tick, self.m_held);
+    return self.m_held;
+}
+
+void SimThread::run()
+{
+    uint64_t started_ns = sim_clock_ns();
+    uint64_t last_ns = started_ns;
+    uint64_t last_tick_ns = started_ns;
+    m_epoch_ns = started_ns - m_world->tick * (uint64_t)(FIXED_TIMESTEP * 1e9f);
+
+    while (m_running.load(std::memory_order_acquire))
+    {
+        uint64_t now_ns = sim_clock_ns();
+        float delta_time = (now_ns - last_ns) / 1e9f;
+        last_ns = now_ns;
+
+        int ticks;
+        {
+            // Here rather than in Simulation.cpp, which builds without the profiler
+            PROFILE_SCOPE("simulate");
+            ticks = advance_world(*m_world, delta_time, MAX_SUBSTEPS, input_for_tick, this);
+        }
+        if (ticks > 0)
+        {
+            publish();
+            if (now_ns - last_tick_ns > m_max_gap_ns) m_max_gap_ns = now_ns - last_tick_ns;
+            last_tick_ns = now_ns;
+        }
+
+        uint64_t done_ns = sim_clock_ns();
+        m_busy_ns += done_ns - now_ns;
+
+        // Sleep until the next tick is due
+        float until_next = FIXED_TIMESTEP - m_world->accumulator;
+        uint64_t wake_ns = now_ns + (uint64_t)(until_next * 1e9f);
+        if (wake_ns > done_ns) std::this_thread::sleep_for(std::chrono::nanoseconds(wake_ns - done_ns));
+    }
+
+    m_lifetime_ns = sim_clock_ns() - started_ns;
+}
+
+SimThreadStats SimThread::get_stats() const
+{
+    SimThreadStats stats;
+    stats.busy_fraction = m_lifetime_ns > 0 ? (double)m_busy_ns / m_lifetime_ns : 0.0;
+    stats.ticks = m_world ? m_world->tick : 0;
+    stats.max_tick_gap_ms = m_max_gap_ns / 1e6;
+    stats.snapshots = m_snapshot_count;
+    stats.events_dropped = m_events_dropped.load();
+
+    stats.key_events = m_key_events;
+    stats.late_events = m_late_events;
+    stats.mean_latency_ms = m_key_events > 0 ? m_latency_total_ns / 1e6 / m_key_events : 0.0;
+    stats.max_latency_ms = m_latency_max_ns / 1e6;
+
+    // Upper edge of the bucket holding the 99th percentile
+    stats.p99_latency_ms = 0.0;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS && m_key_events > 0; bucket++)
+    {
+        seen += m_latency_histogram[bucket];
+        if (seen * 100 >= m_key_events * 99)
+        {
+            stats.p99_latency_ms = bucket + 1.0;
+            break;
+        }
+    }
+    return stats;
+}
+
+glm::vec3 get_render_position(const RenderSnapshot& snapshot, uint64_t now_ns)
+{
+    const glm::vec3& current = snapshot.lander.position;
+    const glm::vec3& previous = snapshot.previous_position;
+
+    if (fabs(current.x - previous.x) > WRAP_LIMIT_X) return current;
+
+    float since_publish = now_ns > snapshot.published_ns ? (now_ns - snapshot.published_ns) / 1e9f : 0.0f;
+    float alpha = (snapshot.accumulator + since_publish) / FIXED_TIMESTEP;
+    if (alpha > 1.0f) alpha = 1.0f;
+
+    return previous + (current - previous) * alpha;
+}
@@ -0,0 +1,117 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "Simulation.h"
+#include "InputLog.h"
+#include "SpscRing.h"
+#include "TripleBuffer.h"
+
+// What render() needs from one tick, copied out of the world so the
+// simulation can keep going while a frame is drawn
+struct RenderSnapshot
+{
+    Lander    lander;
+    glm::vec3 previous_position;
+    bool      thrusting;
+    uint32_t  tick;
+    float     accumulator;      // at publish time
+    uint64_t  published_ns;     // SimThread clock
+};
+
+enum InputKey : uint8_t { KEY_LEFT, KEY_RIGHT, KEY_UP };
+
+// One press or release, stamped with when it happened on the sim_clock_ns() clock
+struct KeyEvent
+{
+    uint64_t time_ns;
+    InputKey key;
+    bool     pressed;
+};
+
+struct SimThreadStats
+{
+    double   busy_fraction;     // of the thread's lifetime spent ticking rather than sleeping
+    uint32_t ticks;
+    double   max_tick_gap_ms;   // longest wait between two batches of ticks
+    uint64_t snapshots;
+    uint64_t events_dropped;    // key events lost to a full input queue
+
+    // Input-to-simulation latency: from a key event's timestamp to the
+    // moment the tick that applied it ran
+    uint64_t key_events;
+    uint64_t late_events;       // reached the thread after their own tick had already run
+    double   mean_latency_ms, p99_latency_ms, max_latency_ms;
+};
+
+// Runs the fixed-step loop on its own thread, so a slow swap (vsync) never
+// delays a tick and a slow tick never delays presentation.
+//
+// Key presses and releases come in through an SPSC queue with their
+// timestamps. Each one takes effect on the tick whose time slice it falls
+// in (or the next tick still to run, if it arrives late), and the keys
+// held during a tick are applied, charged and logged once for that tick,
+// whatever the frame rate. After every batch of ticks the thread
+// publishes a RenderSnapshot through a triple buffer; the render thread
+// only ever reads the newest one.
+//
+// While the thread runs it owns the World; touch it again only after stop().
+class SimThread
+{
+private:
+    static constexpr size_t INPUT_QUEUE_SIZE = 256;
+    static constexpr int LATENCY_BUCKETS = 128;      // 1 ms each; the last one also takes anything slower
+
+    World*    m_world = nullptr;
+    InputLog* m_log = nullptr;
+
+    std::thread       m_thread;
+    std::atomic<bool> m_running{ false };
+
+    SpscRing<KeyEvent, INPUT_QUEUE_SIZE> m_events;
+    TripleBuffer<RenderSnapshot>         m_snapshots;
+
+    // Simulation thread only
+    TickInput m_held = { false, false, false };
+    uint64_t  m_epoch_ns = 0;           // when tick 0 began, on sim_clock_ns()
+
+    uint64_t m_key_events = 0,
+        m_late_events = 0,
+        m_latency_total_ns = 0,
+        m_latency_max_ns = 0;
+    uint32_t m_latency_histogram[LATENCY_BUCKETS] = {};
+
+    std::atomic<uint64_t> m_events_dropped{ 0 };
+    uint64_t m_busy_ns = 0,
+        m_lifetime_ns = 0,
+        m_max_gap_ns = 0,
+        m_snapshot_count = 0;
+
+    void run();
+    void publish();
+    static TickInput input_for_tick(const World& world, void* context);
+
+public:
+    // ----- METHODS ----- //
+    void start(World* world, InputLog* log);
+    void stop();
+
+    // Main thread only
+    void push_event(const KeyEvent& event);
+    const RenderSnapshot& read_latest();
+
+    // ----- GETTERS ----- //
+    // Complete after stop()
+    SimThreadStats get_stats() const;
+};
+
+// Nanoseconds on the clock RenderSnapshot::published_ns uses
+uint64_t sim_clock_ns();
+
+// The snapshot's lander position, blended between its last two ticks by
+// how far the clock has moved towards the next one
+glm::vec3 get_render_position(const RenderSnapshot& snapshot, uint64_t now_ns);
+
+#endif // SIM_THREAD_H
@@ -0,0 +1,443 @@
+#include <cmath>
+#include <vector>
+#include "Simulation.h"
+
+bool aabb_overlap(glm::vec3 a_position, float a_width, float a_height,
+    glm::vec3 b_position, float b_width, float b_height)
+{
+    float x_distance = fabs(a_position.x - b_position.x) - ((a_width + b_width) / 2.0f);
+    float y_distance = fabs(a_position.y - b_position.y) - ((a_height + b_height) / 2.0f);
+
+    return x_distance < 0.0f && y_distance < 0.0f;
+}
+
+ContactOutcome classify_contact(bool is_platform, float velocity_y)
+{
+    if (!is_platform) return CONTACT_HIT;
+
+    return velocity_y > LANDING_SPEED_LIMIT ? CONTACT_LANDED : CONTACT_CRASH_LANDED;
+}
+
+// Sum of a ramp's values over count ticks: start - step, start - 2 step, ...
+static float ramp_sum(float start, float step, float count)
+{
+    return count * start - step * count * (count + 1.0f) / 2.0f;
+}
+
+// One step standing for several ticks. Tick by tick, an acceleration left
+// alone ramps down by its per-tick amount, and what an input holds is set
+// again every tick so only ever loses one tick's worth; this sums those
+// ramps over the step in one go instead of walking them.
+static void integrate_ticks(glm::vec3& position, glm::vec3& velocity, glm::vec3& acceleration, float ticks,
+    const TickInput& held)
+{
+    const float damping = (float)HORIZONTAL_DAMPING;
+    glm::vec3 start_velocity = velocity;
+
+    // The lateral engine's push dies away, then drag slows the drift
+    float direction_x = acceleration.x < 0 ? -1.0f : 1.0f;
+    float push_x = fabsf(acceleration.x);
+    float push_ticks;
+    if (held.left || held.right) {
+        push_x = push_x > damping ? push_x - damping : 0.0f;
+        push_ticks = push_x > 0.0f ? ticks : 0.0f;
+        velocity.x += direction_x * push_x * push_ticks * FIXED_TIMESTEP;
+    }
+    else {
+        push_ticks = fminf(ticks, push_x / damping);
+        velocity.x += direction_x * ramp_sum(push_x, damping, push_ticks) * FIXED_TIMESTEP;
+        push_x = fmaxf(push_x - damping * ticks, 0.0f);
+    }
+    acceleration.x = direction_x * push_x;
+
+    float drag = damping * (ticks - push_ticks);
+    if (velocity.x > 0) {
+        velocity.x = fmaxf(velocity.x - drag, 0.0f);
+    }
+    else if (velocity.x < 0) {
+        velocity.x = fminf(velocity.x + drag, 0.0f);
+    }
+
+    // Falls by ACCELERATION_Y_DECAY a tick until past MIN_ACCELERATION_Y,
+    // then alternates between it and one decay below, about this
+    const float settled_y = MIN_ACCELERATION_Y - ACCELERATION_Y_DECAY / 2.0f;
+    float y = acceleration.y > MAX_ACCELERATION_Y ? MAX_ACCELERATION_Y : acceleration.y;
+    if (held.up) {
+        y = y < MIN_ACCELERATION_Y ? MIN_ACCELERATION_Y : y - ACCELERATION_Y_DECAY;
+        velocity.y += y * ticks * FIXED_TIMESTEP;
+    }
+    else {
+        if (y < MIN_ACCELERATION_Y) y = settled_y;
+        float fall_ticks = fminf(ticks, fmaxf((y - settled_y) / ACCELERATION_Y_DECAY, 0.0f));
+        velocity.y += (ramp_sum(y, ACCELERATION_Y_DECAY, fall_ticks) + (ticks - fall_ticks) * settled_y) * FIXED_TIMESTEP;
+        y = fall_ticks < ticks ? settled_y : y - ACCELERATION_Y_DECAY * ticks;
+    }
+    acceleration.y = y;
+
+    // Each tick moves by its own end velocity, so on average the step moves
+    // by the velocity (ticks + 1) / (2 ticks) of the way through the change
+    float along = (ticks + 1.0f) / (2.0f * ticks);
+    position += (start_velocity + (velocity - start_velocity) * along) * (ticks * FIXED_TIMESTEP);
+}
+
+void integrate_lander(glm::vec3& position, glm::vec3& velocity, glm::vec3& acceleration, float delta_time,
+    const TickInput& held)
+{
+    // The damping and decay amounts are per tick, so a shorter step scales
+    // them down (by exactly 1 at FIXED_TIMESTEP)
+    float ticks = delta_time / FIXED_TIMESTEP;
+    if (ticks > 1.0f) {
+        integrate_ticks(position, velocity, acceleration, ticks, held);
+        return;
+    }
+    double damping = HORIZONTAL_DAMPING * ticks;
+    float decay = ACCELERATION_Y_DECAY * ticks;
+
+    if (acceleration.x > 0) {
+        acceleration.x -= damping;
+        if (acceleration.x < 0) {
+            acceleration.x = 0;
+        }
+    }
+    else if (acceleration.x < 0) {
+        acceleration.x += damping;
+        if (acceleration.x > 0) {
+            acceleration.x = 0;
+        }
+    }
+
+    // Limit vertical acceleration to max value
+    if (acceleration.y > MAX_ACCELERATION_Y) {
+        acceleration.y = MAX_ACCELERATION_Y;
+    }
+    if (acceleration.y < MIN_ACCELERATION_Y) {
+        acceleration.y = MIN_ACCELERATION_Y;
+    }
+    else {
+        acceleration.y -= decay;
+    }
+
+    if (acceleration.x == 0) {
+        if (velocity.x > 0) {
+            velocity.x -= damping;
+            if (velocity.x < 0) {
+                velocity.x = 0;
+            }
+        }
+        else if (velocity.x < 0) {
+            velocity.x += damping;
+            if (velocity.x > 0) {
+                velocity.x = 0;
+            }
+        }
+    }
+
+    velocity += acceleration * delta_time;
+    position += velocity * delta_time;
+}
+
+static void touch_down(Lander& lander, bool is_platform)
+{
+    ContactOutcome outcome = classify_contact(is_platform, lander.velocity.y);
+    if (outcome == CONTACT_LANDED) {
+        lander.is_winner = true;
+    }
+    else {
+        lander.is_loser = true;
+        if (outcome == CONTACT_CRASH_LANDED) lander.crash_land = true;
+    }
+}
+
+void step_lander(Lander& lander, const Block* blocks, int block_count, float delta_time)
+{
+    for (int i = 0; i < block_count; i++)
+    {
+        if (aabb_overlap(lander.position, lander.width, lander.height,
+            blocks[i].position, blocks[i].width, blocks[i].height))
+        {
+            touch_down(lander, blocks[i].is_platform);
+            return;
+        }
+    }
+
+    integrate_lander(lander.position, lander.velocity, lander.acceleration, delta_time);
+}
+
+float step_lander(Lander& lander, const Terrain& terrain, float delta_time, const TickInput& held)
+{
+    if (lander.is_winner || lander.is_loser) return -1.0f;
+
+    // Already inside a column (placed there, or wrapped into it)
+    int column = terrain.find_contact(lander.position, lander.width, lander.height);
+    if (column >= 0)
+    {
+        touch_down(lander, terrain.get_kind(column) == SURFACE_PAD);
+        return 0.0f;
+    }
+
+    glm::vec3 start_position = lander.position;
+    glm::vec3 start_velocity = lander.velocity;
+    integrate_lander(lander.position, lander.velocity, lander.acceleration, delta_time, held);
+
+    SweepHit hit;
+    if (!terrain.sweep(start_position, lander.position - start_position, lander.width, lander.height, hit)) return -1.0f;
+
+    // Velocity changes evenly over the step, so this is its value at impact
+    lander.position = start_position + (lander.position - start_position) * hit.time;
+    lander.velocity = start_velocity + (lander.velocity - start_velocity) * hit.time;
+    touch_down(lander, terrain.get_kind(hit.column) == SURFACE_PAD);
+    return hit.time;
+}
+
+void build_wide_blocks(Block* blocks, int screen_count, int pad_index)
+{
+    int block_count = PLATFORM_COUNT * screen_count;
+    int pad = PLATFORM_COUNT * (screen_count - 1) + pad_index;
+
+    // Blocks sit along the bottom of the screen; their collision boxes are
+    // half the size of the 0.5 x 0.5 sprite drawn for them
+    for (int i = 0; i < block_count; i++)
+    {
+        Block& block = blocks[i];
+        block.position = glm::vec3((i - block_count / 2.0) * 0.5, -3.5f, 0.0f);
+        block.is_platform = i == pad;
+        block.width = 0.5f * 0.5f;
+        block.height = block.is_platform ? 0.5f * 0.67f : 0.5f * 0.5f;
+    }
+}
+
+void build_wide_terrain(Terrain& terrain, int screen_count, int pad_index)
+{
+    int block_count = PLATFORM_COUNT * screen_count;
+    std::vector<Block> blocks(block_count);
+    build_wide_blocks(blocks.data(), screen_count, pad_index);
+
+    // Blocks are one block-width apart, so they land on every other column
+    float column_width = blocks[0].width;
+    terrain.reset(blocks[0].position.x - column_width / 2.0f, column_width, 2 * block_count - 1);
+
+    int pad = 0;
+    for (int i = 0; i < block_count; i++)
+    {
+        float half_height = blocks[i].height / 2.0f;
+        terrain.set_column(2 * i, blocks[i].position.y - half_height, blocks[i].position.y + half_height);
+        if (blocks[i].is_platform) pad = i;
+    }
+    terrain.add_pad(2 * pad, 2 * pad);
+}
+
+void build_classic_blocks(Block* blocks, int pad_index)
+{
+    build_wide_blocks(blocks, 1, pad_index);
+}
+
+void build_classic_terrain(Terrain& terrain, int pad_index)
+{
+    build_wide_terrain(terrain, 1, pad_index);
+}
+
+float get_wrap_limit_x(int screen_count)
+{
+    // Each screen added moves both edges out by half a screen
+    return WRAP_LIMIT_X + (screen_count - 1) * SCREEN_SPAN_X / 2.0f;
+}
+
+void reset_world(World& world, const Terrain* terrain, int screen_count)
+{
+    Lander& lander = world.lander;
+    lander.position = glm::vec3(0.0f, 3.0f, 0.0f);
+    lander.velocity = glm::vec3(0.0f);
+    lander.acceleration = glm::vec3(0.0f, -9.8f, 0.0f);
+    lander.width = 0.75f;
+    lander.height = 0.75f;
+    lander.fuel = STARTING_FUEL;
+    lander.depleted = false;
+    lander.is_winner = false;
+    lander.is_loser = false;
+    lander.crash_land = false;
+
+    world.terrain = terrain;
+    world.thrusting = false;
+    world.tick = 0;
+    world.accumulator = 0.0f;
+    world.dropped_time = 0.0f;
+    world.contact_time = -1.0f;
+    world.wrap_limit_x = get_wrap_limit_x(screen_count);
+    world.previous_position = lander.position;
+}
+
+bool apply_input(Lander& lander, const TickInput& input, const LanderTuning& tuning)
+{
+    if (lander.depleted) return false;
+
+    if (input.left)
+    {
+        lander.fuel -= tuning.lateral_fuel_cost;
+        lander.acceleration.x = -tuning.lateral_acceleration;
+    }
+    else if (input.right)
+    {
+        lander.fuel -= tuning.lateral_fuel_cost;
+        lander.acceleration.x = tuning.lateral_acceleration;
+    }
+    if (input.up)
+    {
+        lander.fuel -= tuning.thrust_fuel_cost;
+        lander.acceleration.y = tuning.thrust_acceleration;
+        return true;
+    }
+    return false;
+}
+
+bool apply_input(Lander& lander, const TickInput& input)
+{
+    return apply_input(lander, input, DEFAULT_TUNING);
+}
+
+void apply_input(World& world, const TickInput& input, const LanderTuning& tuning)
+{
+    // A depleted lander keeps whatever flame state it had
+    if (world.lander.depleted) return;
+
+    world.thrusting = apply_input(world.lander, input, tuning);
+}
+
+void apply_input(World& world, const TickInput& input)
+{
+    apply_input(world, input, DEFAULT_TUNING);
+}
+
+static void wrap_and_deplete(Lander& lander, float wrap_limit_x)
+{
+    if (lander.fuel <= 0.0f) {
+        lander.fuel = 0.0f;
+        lander.depleted = true;
+    }
+    // for player moving off screen to the right
+    if (lander.position.x > wrap_limit_x) {
+        lander.position.x = -lander.position.x + WRAP_OFFSET_X;
+    }
+    // for player moving off screen to the left
+    if (lander.position.x < -wrap_limit_x) {
+        lander.position.x = -lander.position.x - WRAP_OFFSET_X;
+    }
+}
+
+void tick_lander(Lander& lander, const Block* blocks, int block_count)
+{
+    wrap_and_deplete(lander, WRAP_LIMIT_X);
+    step_lander(lander, blocks, block_count, FIXED_TIMESTEP);
+}
+
+float tick_lander(Lander& lander, const Terrain& terrain, float wrap_limit_x)
+{
+    wrap_and_deplete(lander, wrap_limit_x);
+    return step_lander(lander, terrain, FIXED_TIMESTEP);
+}
+
+// tick_count ticks in one swept step; with 1 this is exactly a fixed tick
+static void run_ticks(World& world, int tick_count, const TickInput& held)
+{
+    wrap_and_deplete(world.lander, world.wrap_limit_x);
+    float contact = step_lander(world.lander, *world.terrain, tick_count * FIXED_TIMESTEP, held);
+    if (contact >= 0.0f && world.contact_time < 0.0f) world.contact_time = (world.tick + contact * tick_count) * FIXED_TIMESTEP;
+    world.tick += tick_count;
+}
+
+void tick_world(World& world)
+{
+    run_ticks(world, 1, TickInput());
+}
+
+void step_world(World& world, const TickInput& input, const LanderTuning& tuning, int tick_count)
+{
+    // Fuel is charged per tick held, as if the input were sampled every tick
+    LanderTuning costs = tuning;
+    costs.lateral_fuel_cost *= tick_count;
+    costs.thrust_fuel_cost *= tick_count;
+
+    // A depleted lander ignores its input, so holds nothing
+    bool applied = !world.lander.depleted;
+    apply_input(world, input, costs);
+    world.previous_position = world.lander.position;
+    run_ticks(world, tick_count, applied ? input : TickInput());
+}
+
+void step_world(World& world, const TickInput& input, int tick_count)
+{
+    step_world(world, input, DEFAULT_TUNING, tick_count);
+}
+
+int advance_world(World& world, float delta_time, int max_substeps, TickInputFunction input, void* context)
+{
+    delta_time += world.accumulator;
+
+    if (delta_time < FIXED_TIMESTEP)
+    {
+        world.accumulator = delta_time;
+        return 0;
+    }
+
+    int ticks = 0;
+    while (delta_time >= FIXED_TIMESTEP)
+    {
+        if (ticks == max_substeps)
+        {
+            // Keep only the fraction of a tick, so interpolation stays smooth
+            float backlog = floorf(delta_time / FIXED_TIMESTEP) * FIXED_TIMESTEP;
+            world.dropped_time += backlog;
+            delta_time -= backlog;
+            if (delta_time < 0.0f) delta_time = 0.0f;
+            break;
+        }
+
+        if (input) apply_input(world, input(world, context));
+        world.previous_position = world.lander.position;
+        tick_world(world);
+        delta_time -= FIXED_TIMESTEP;
+        ticks++;
+    }
+
+    world.accumulator = delta_time;
+    return ticks;
+}
+
+glm::vec3 get_render_position(const World& world)
+{
+    const glm::vec3& current = world.lander.position;
+    const glm::vec3& previous = world.previous_position;
+
+    if (fabs(current.x - previous.x) > WRAP_LIMIT_X) return current;
+
+    float alpha = world.accumulator / FIXED_TIMESTEP;
+    if (alpha > 1.0f) alpha = 1.0f;
+
+    return previous + (current - previous) * alpha;
+}
+
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t hash_world(const World& world)
+{
+    const Lander& lander = world.lander;
+
+    // Field by field, so struct padding never leaks into the hash
+    uint64_t hash = 14695981039346656037ull;
+    hash = hash_bytes(hash, &world.tick, sizeof(world.tick));
+    hash = hash_bytes(hash, &lander.position.x, 3 * sizeof(float));
+    hash = hash_bytes(hash, &lander.velocity.x, 3 * sizeof(float));
+    hash = hash_bytes(hash, &lander.acceleration.x, 3 * sizeof(float));
+    hash = hash_bytes(hash, &lander.fuel, sizeof(lander.fuel));
+
+    unsigned char flags[5] = { lander.depleted, lander.is_winner, lander.is_loser, lander.crash_land, world.thrusting };
+    return hash_bytes(hash, flags, sizeof(flags));
+}
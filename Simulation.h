@@ -0,0 +1,198 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+// Lander physics, collision and win/lose rules plus the fixed-timestep loop.
+// Nothing in here touches SDL or OpenGL, so it can be built on its own for
+// headless runs (see headless_main.cpp) as well as linked into the game.
+
+#include <cstdint>
+#include <type_traits>
+#include "glm/glm.hpp"
+#include "Terrain.h"
+
+#define FIXED_TIMESTEP 0.0166666f
+#define PLATFORM_COUNT 21
+
+// ----- PHYSICS CONSTANTS ----- //
+constexpr float LANDING_SPEED_LIMIT = -2.0f;    // anything slower than this on a pad is a safe landing
+constexpr double HORIZONTAL_DAMPING = 0.05;     // kept as double, the original maths promoted through it
+
+constexpr float MAX_ACCELERATION_Y = 3.0f,
+MIN_ACCELERATION_Y = -1.0f,
+ACCELERATION_Y_DECAY = 1.0f;
+
+constexpr float LATERAL_ACCELERATION = 1.5f,
+THRUST_ACCELERATION = 2.0f;
+
+// Charged once per tick an engine is held, so the burn rate no longer
+// depends on the frame rate (the amounts were per rendered frame, at 60 Hz)
+constexpr float LATERAL_FUEL_COST = 0.0008f,
+THRUST_FUEL_COST = 0.008f,
+STARTING_FUEL = 100.0f;
+
+constexpr float WRAP_LIMIT_X = 5.5f,
+WRAP_OFFSET_X = 0.5f;
+
+// Width of one screen's row of blocks; wider worlds are a whole number of these
+constexpr float SCREEN_SPAN_X = PLATFORM_COUNT * 0.5f;
+// The widest world the game builds (--screens is clamped to it), and so the
+// widest an input log may claim to be
+constexpr int MAX_SCREEN_COUNT = 10000;
+
+// Fixed ticks one frame may run. After a longer stall the rest of the
+// backlog is dropped instead of making the following frames slower still.
+constexpr int MAX_SUBSTEPS = 5;
+
+// The input-side constants as one value, so tuning tools can fly other
+// settings through the same rules. The game always plays DEFAULT_TUNING.
+struct LanderTuning
+{
+    float lateral_acceleration;
+    float thrust_acceleration;
+    float lateral_fuel_cost;
+    float thrust_fuel_cost;
+    float starting_fuel;
+};
+
+constexpr LanderTuning DEFAULT_TUNING = {
+    LATERAL_ACCELERATION, THRUST_ACCELERATION, LATERAL_FUEL_COST, THRUST_FUEL_COST, STARTING_FUEL
+};
+
+enum ContactOutcome { CONTACT_LANDED, CONTACT_CRASH_LANDED, CONTACT_HIT };
+
+// ----- STATE ----- //
+struct Lander
+{
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 acceleration;
+
+    float width;
+    float height;
+    float fuel;
+
+    bool depleted;
+    bool is_winner;
+    bool is_loser;
+    bool crash_land;
+};
+
+struct Block
+{
+    glm::vec3 position;
+    float width;
+    float height;
+    bool is_platform;
+};
+
+// Everything the fixed-step loop carries from one frame to the next. It is
+// plain data, so copying it is a complete snapshot of the simulation: that
+// is what rollback and look-ahead search rely on. Terrain never changes
+// during a flight, so the world only points at it.
+struct World
+{
+    Lander lander;
+    const Terrain* terrain;
+    bool thrusting;
+    uint32_t tick;      // fixed ticks run since reset_world
+    float accumulator;  // frame time not yet consumed by a fixed tick
+    float dropped_time; // frame time thrown away by the substep cap since reset_world
+    float contact_time; // seconds after reset_world the lander touched down, or -1 while it flies
+    float wrap_limit_x; // the lander wraps to the other side past +/- this
+
+    glm::vec3 previous_position;    // lander position before the latest tick, for interpolation
+};
+
+static_assert(std::is_trivially_copyable<World>::value, "World must stay copyable with memcpy");
+
+struct TickInput
+{
+    bool left;
+    bool right;
+    bool up;
+};
+
+// ----- PHYSICS ----- //
+bool aabb_overlap(glm::vec3 a_position, float a_width, float a_height,
+    glm::vec3 b_position, float b_width, float b_height);
+ContactOutcome classify_contact(bool is_platform, float velocity_y);
+// The damping and decay amounts are per FIXED_TIMESTEP and scale with
+// delta_time; held is the input applied for the whole step, if any (see
+// step_world)
+void integrate_lander(glm::vec3& position, glm::vec3& velocity, glm::vec3& acceleration, float delta_time,
+    const TickInput& held = TickInput());
+
+// Same rules as Entity::update for the player. The Block version scans
+// every block like Entity::update does, and only notices a block once the
+// lander has moved into it.
+void step_lander(Lander& lander, const Block* blocks, int block_count, float delta_time);
+
+// The Terrain version sweeps the lander's move through the columns under
+// it instead, so it cannot pass through a block however fast it goes. On
+// contact the lander stops where it first touched, with the velocity it had
+// at that moment, and that is the speed the landing is judged on. Returns
+// the fraction of delta_time before the touch-down, or -1 without one. A
+// lander that has already touched down stays where it is.
+float step_lander(Lander& lander, const Terrain& terrain, float delta_time, const TickInput& held = TickInput());
+
+// Charges fuel and sets the thrust for one sampled input; returns whether
+// the main engine fired
+bool apply_input(Lander& lander, const TickInput& input);
+bool apply_input(Lander& lander, const TickInput& input, const LanderTuning& tuning);
+
+// Fuel depletion and screen wrap, then step_lander with FIXED_TIMESTEP
+void tick_lander(Lander& lander, const Block* blocks, int block_count);
+float tick_lander(Lander& lander, const Terrain& terrain, float wrap_limit_x = WRAP_LIMIT_X);
+
+// ----- LEVEL ----- //
+// The original level: PLATFORM_COUNT blocks along the bottom of the screen,
+// one of which is the landing pad
+void build_classic_blocks(Block* blocks, int pad_index);
+void build_classic_terrain(Terrain& terrain, int pad_index);
+
+// screen_count classic screens side by side, centred on x = 0, with the
+// pad on the last (rightmost) one; one screen is the classic level.
+// blocks needs PLATFORM_COUNT * screen_count entries, in order of x.
+void build_wide_blocks(Block* blocks, int screen_count, int pad_index);
+void build_wide_terrain(Terrain& terrain, int screen_count, int pad_index);
+
+// Where a lander wraps around a world screen_count screens wide
+float get_wrap_limit_x(int screen_count);
+
+// ----- WORLD ----- //
+// screen_count sets where the lander wraps; it has to match the terrain
+void reset_world(World& world, const Terrain* terrain, int screen_count = 1);
+void apply_input(World& world, const TickInput& input);
+void apply_input(World& world, const TickInput& input, const LanderTuning& tuning);
+void tick_world(World& world);
+
+// One physics step tick_count fixed ticks long, with the input held and
+// charged for all of them, for batch runs that want fewer, larger steps (6
+// ticks is a 0.1 s step). The lander is integrated and swept through the
+// terrain once over the whole step. With 1 it is exactly apply_input then
+// tick_world; longer steps fly close to that, not the same: see
+// swept_collision_bench for how close.
+void step_world(World& world, const TickInput& input, int tick_count);
+void step_world(World& world, const TickInput& input, const LanderTuning& tuning, int tick_count);
+
+// Supplies the input held during the tick about to run (world.tick)
+typedef TickInput (*TickInputFunction)(const World& world, void* context);
+
+// Runs as many fixed ticks as fit into delta_time plus the world's
+// carried-over accumulator, at most max_substeps of them, and returns how
+// many were run. Whole ticks beyond the cap are added to dropped_time; the
+// fraction of a tick left over stays in the accumulator either way.
+// With an input function, its input is applied before every tick.
+int advance_world(World& world, float delta_time, int max_substeps = MAX_SUBSTEPS,
+    TickInputFunction input = nullptr, void* context = nullptr);
+
+// Where to draw the lander: between the last two ticks, accumulator /
+// FIXED_TIMESTEP of the way along. A tick that wrapped the lander around
+// the screen is not blended, or it would be drawn crossing the middle.
+glm::vec3 get_render_position(const World& world);
+
+// FNV-1a over the tick counter, the lander and the flame state. Two builds
+// that agree on this after every tick agree on the whole flight.
+uint64_t hash_world(const World& world);
+
+#endif // SIMULATION_H
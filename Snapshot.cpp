@@ -0,0 +1,23 @@
+#include "Snapshot.h"
+
+void SnapshotRing::initialise(int capacity)
+{
+    m_slots.assign(capacity, Slot());
+    for (Slot& slot : m_slots) slot.used = false;
+}
+
+void SnapshotRing::save(const World& world)
+{
+    Slot& slot = m_slots[world.tick % m_slots.size()];
+    slot.world = world;
+    slot.used = true;
+}
+
+bool SnapshotRing::restore(uint32_t tick, World& world) const
+{
+    const Slot& slot = m_slots[tick % m_slots.size()];
+    if (!slot.used || slot.world.tick != tick) return false;
+
+    world = slot.world;
+    return true;
+}
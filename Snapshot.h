@@ -0,0 +1,38 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+
+// Ring of world snapshots indexed by tick, allocated once up front. A save
+// or restore is one copy of the plain World struct, so rollback can keep a
+// snapshot for every tick and look-ahead search can branch from any of
+// them for the cost of a memcpy.
+class SnapshotRing
+{
+private:
+    struct Slot
+    {
+        World world;
+        bool  used;
+    };
+
+    std::vector<Slot> m_slots;
+
+public:
+    // ----- METHODS ----- //
+    void initialise(int capacity);
+
+    // Stores the world under its current tick, replacing whatever was
+    // saved capacity ticks earlier
+    void save(const World& world);
+
+    // False when the tick was never saved or has since been overwritten
+    bool restore(uint32_t tick, World& world) const;
+
+    // ----- GETTERS ----- //
+    int get_capacity() const { return (int)m_slots.size(); }
+};
+
+#endif // SNAPSHOT_H
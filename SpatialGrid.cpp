@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cmath>
+#include "SpatialGrid.h"
+
+void SpatialGrid::build(const float* min_x, const float* max_x, int count, float cell_width)
+{
+    clear();
+    if (count <= 0 || cell_width <= 0.0f) return;
+
+    float low = min_x[0], high = max_x[0];
+    m_margin = 0.0f;
+    for (int i = 0; i < count; i++)
+    {
+        low = std::min(low, min_x[i]);
+        high = std::max(high, max_x[i]);
+        m_margin = std::max(m_margin, (max_x[i] - min_x[i]) * 0.5f);
+    }
+
+    m_origin_x = low;
+    m_cell_width = cell_width;
+    m_inverse_cell_width = 1.0f / cell_width;
+    int cell_count = (int)floorf((high - low) * m_inverse_cell_width) + 1;
+
+    // Counting sort by cell: count, prefix-sum into starts, then place
+    std::vector<int> cells(count);
+    m_cell_start.assign(cell_count + 1, 0);
+    for (int i = 0; i < count; i++)
+    {
+        float center = (min_x[i] + max_x[i]) * 0.5f;
+        int cell = (int)floorf((center - m_origin_x) * m_inverse_cell_width);
+        cells[i] = std::min(std::max(cell, 0), cell_count - 1);
+        m_cell_start[cells[i] + 1]++;
+    }
+    for (int cell = 0; cell < cell_count; cell++) m_cell_start[cell + 1] += m_cell_start[cell];
+
+    std::vector<int> next(m_cell_start.begin(), m_cell_start.end() - 1);
+    m_items.resize(count);
+    for (int i = 0; i < count; i++) m_items[next[cells[i]]++] = i;
+}
+
+void SpatialGrid::build(const EntityPool& pool, float cell_width)
+{
+    const EntityBody* bodies = pool.get_bodies();
+    const EntitySprite* sprites = pool.get_sprites();
+    int count = pool.get_count();
+
+    std::vector<float> min_x(count), max_x(count);
+    for (int i = 0; i < count; i++)
+    {
+        min_x[i] = bodies[i].position.x - sprites[i].width * 0.5f;
+        max_x[i] = bodies[i].position.x + sprites[i].width * 0.5f;
+    }
+    build(min_x.data(), max_x.data(), count, cell_width);
+}
+
+void SpatialGrid::clear()
+{
+    m_cell_start.clear();
+    m_items.clear();
+    m_margin = 0.0f;
+}
+
+GridSpan SpatialGrid::query(float min_x, float max_x) const
+{
+    int cell_count = get_cell_count();
+    if (cell_count == 0) return { 0, 0 };
+
+    float first = floorf((min_x - m_margin - m_origin_x) * m_inverse_cell_width);
+    float last = floorf((max_x + m_margin - m_origin_x) * m_inverse_cell_width);
+    if (last < 0.0f || first >= (float)cell_count || first > last) return { 0, 0 };
+
+    // Clamped as floats first, so a range far outside the grid cannot overflow an int
+    int first_cell = first < 0.0f ? 0 : (int)first;
+    int last_cell = last >= (float)cell_count ? cell_count - 1 : (int)last;
+
+    return { m_cell_start[first_cell], m_cell_start[last_cell + 1] - m_cell_start[first_cell] };
+}
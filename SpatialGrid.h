@@ -0,0 +1,58 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <vector>
+#include "EntityPool.h"
+
+// A run of consecutive entries of SpatialGrid::get_items()
+struct GridSpan
+{
+    int first;
+    int count;
+};
+
+// Static boxes bucketed by which cell of a row of equal-width cells their
+// centre falls in. Only x is indexed: every level is one screen tall, so
+// that is the only direction a world grows in.
+//
+// Items are stored sorted by cell, keeping their original order within a
+// cell, so whatever a range of x touches is one contiguous span of
+// get_items(), found in constant time however many items there are. Data
+// laid out in get_items() order (a vertex buffer, say) can then be drawn
+// for a view with a single call.
+//
+// Each item sits in exactly one cell; queries widen their range by the
+// widest item's half-width so that boxes reaching in from a neighbouring
+// cell are still found. A span may hold a few items just outside the
+// range, but never misses one inside it.
+class SpatialGrid
+{
+private:
+    float m_origin_x = 0.0f;            // left edge of cell 0
+    float m_cell_width = 1.0f;
+    float m_inverse_cell_width = 1.0f;
+    float m_margin = 0.0f;              // half-width of the widest item
+
+    std::vector<int> m_cell_start;      // get_cell_count() + 1 entries
+    std::vector<int> m_items;
+
+public:
+    // ----- METHODS ----- //
+    // Item i spans min_x[i] to max_x[i]
+    void build(const float* min_x, const float* max_x, int count, float cell_width);
+    // Every entity in the pool, by the extent of its sprite; items are
+    // dense pool indices
+    void build(const EntityPool& pool, float cell_width);
+    void clear();
+
+    // Items that may overlap min_x..max_x
+    GridSpan query(float min_x, float max_x) const;
+
+    // ----- GETTERS ----- //
+    const int* get_items()      const { return m_items.data(); }
+    int        get_item_count() const { return (int)m_items.size(); }
+    int        get_cell_count() const { return m_cell_start.empty() ? 0 : (int)m_cell_start.size() - 1; }
+    float      get_cell_width() const { return m_cell_width; }
+};
+
+#endif // SPATIAL_GRID_H
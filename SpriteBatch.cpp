@@ -0,0 +1,146 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "GlState.h"
+#include "SpriteBatch.h"
+
+void SpriteBatch::initialise(int expected_sprites)
+{
+    m_buffer_bytes = expected_sprites * VERTICES_PER_SPRITE * FLOATS_PER_VERTEX * (int)sizeof(float);
+
+    glGenBuffers(1, &m_vertex_buffer);
+    GlState::get().bind_array_buffer(m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_buffer_bytes, NULL, GL_STREAM_DRAW);
+
+    m_upload.reserve(expected_sprites * VERTICES_PER_SPRITE * FLOATS_PER_VERTEX);
+}
+
+void SpriteBatch::shutdown()
+{
+    GlState::get().forget_buffer(m_vertex_buffer);
+    glDeleteBuffers(1, &m_vertex_buffer);
+    m_vertex_buffer = 0;
+}
+
+void SpriteBatch::begin(ShaderProgram* program)
+{
+    m_program = program;
+    m_bucket_count = 0;
+    m_stats = SpriteBatchStats();
+}
+
+SpriteBatch::Bucket& SpriteBatch::bucket_for(GLuint texture_id)
+{
+    // A frame only ever uses a handful of textures, a linear search is fine
+    for (int i = 0; i < m_bucket_count; i++)
+    {
+        if (m_buckets[i].texture_id == texture_id) return m_buckets[i];
+    }
+
+    if (m_bucket_count == (int)m_buckets.size()) m_buckets.push_back(Bucket());
+
+    Bucket& bucket = m_buckets[m_bucket_count++];
+    bucket.texture_id = texture_id;
+    bucket.vertices.clear();
+    return bucket;
+}
+
+void SpriteBatch::draw(GLuint texture_id, const glm::mat4& model_matrix, const UvRect& uv)
+{
+    Bucket& bucket = bucket_for(texture_id);
+
+    // Corners of the unit quad, transformed by the model matrix (column-major)
+    float x[4], y[4];
+    const float corner_x[4] = { -0.5f, 0.5f, 0.5f, -0.5f };
+    const float corner_y[4] = { -0.5f, -0.5f, 0.5f, 0.5f };
+    for (int i = 0; i < 4; i++)
+    {
+        x[i] = model_matrix[0][0] * corner_x[i] + model_matrix[1][0] * corner_y[i] + model_matrix[3][0];
+        y[i] = model_matrix[0][1] * corner_x[i] + model_matrix[1][1] * corner_y[i] + model_matrix[3][1];
+    }
+
+    // Bottom left, bottom right, top right / bottom left, top right, top left
+    bucket.vertices.insert(bucket.vertices.end(), {
+        x[0], y[0], uv.u0, uv.v1,
+        x[1], y[1], uv.u1, uv.v1,
+        x[2], y[2], uv.u1, uv.v0,
+        x[0], y[0], uv.u0, uv.v1,
+        x[2], y[2], uv.u1, uv.v0,
+        x[3], y[3], uv.u0, uv.v0,
+        });
+
+    m_stats.sprites++;
+}
+
+void SpriteBatch::draw(GLuint texture_id, glm::vec3 position, float width, float height, const UvRect& uv)
+{
+    Bucket& bucket = bucket_for(texture_id);
+
+    float x0 = position.x - width * 0.5f, x1 = position.x + width * 0.5f,
+        y0 = position.y - height * 0.5f, y1 = position.y + height * 0.5f;
+
+    bucket.vertices.insert(bucket.vertices.end(), {
+        x0, y0, uv.u0, uv.v1,
+        x1, y0, uv.u1, uv.v1,
+        x1, y1, uv.u1, uv.v0,
+        x0, y0, uv.u0, uv.v1,
+        x1, y1, uv.u1, uv.v0,
+        x0, y1, uv.u0, uv.v0,
+        });
+
+    m_stats.sprites++;
+}
+
+void SpriteBatch::end()
+{
+    // Lay the buckets out back to back so one upload covers the frame
+    m_upload.clear();
+    for (int i = 0; i < m_bucket_count; i++)
+    {
+        m_upload.insert(m_upload.end(), m_buckets[i].vertices.begin(), m_buckets[i].vertices.end());
+    }
+
+    if (!m_upload.empty())
+    {
+        int bytes = (int)(m_upload.size() * sizeof(float));
+
+        GlState& gl = GlState::get();
+        gl.bind_array_buffer(m_vertex_buffer);
+        if (bytes > m_buffer_bytes) m_buffer_bytes = bytes;
+        // Orphan last frame's storage so the driver never waits on it
+        glBufferData(GL_ARRAY_BUFFER, m_buffer_bytes, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_upload.data());
+        m_stats.bytes_uploaded = bytes;
+
+        gl.set_model_matrix(m_program, glm::mat4(1.0f));
+
+        GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+        glVertexAttribPointer(m_program->get_position_attribute(), 2, GL_FLOAT, false, stride, (const void*)0);
+        glVertexAttribPointer(m_program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride,
+            (const void*)(2 * sizeof(float)));
+        gl.enable_sprite_attribs(m_program);
+
+        int first_vertex = 0;
+        for (int i = 0; i < m_bucket_count; i++)
+        {
+            int vertex_count = (int)m_buckets[i].vertices.size() / FLOATS_PER_VERTEX;
+
+            gl.bind_texture(m_buckets[i].texture_id);
+            gl.draw_arrays(GL_TRIANGLES, first_vertex, vertex_count);
+
+            first_vertex += vertex_count;
+            m_stats.texture_binds++;
+            m_stats.draw_calls++;
+        }
+
+        m_stats.vertices = first_vertex;
+    }
+
+    m_last_frame = m_stats;
+}
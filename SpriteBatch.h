@@ -0,0 +1,77 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <vector>
+#include "glm/glm.hpp"
+#include "ShaderProgram.h"
+
+// UV rectangle inside a texture: u0/v0 is the top-left corner, u1/v1 the
+// bottom-right, matching how the sprites were drawn before batching
+struct UvRect
+{
+    float u0, v0, u1, v1;
+};
+
+constexpr UvRect FULL_TEXTURE = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+struct SpriteBatchStats
+{
+    int sprites;
+    int vertices;
+    int draw_calls;
+    int texture_binds;
+    int bytes_uploaded;
+};
+
+// Collects every sprite of a frame, then draws them with one glDrawArrays
+// per texture out of a single persistent vertex buffer. Model matrices are
+// applied on the CPU while the quads are written, so the shader's model
+// matrix stays at identity for the whole batch.
+//
+// Textures are drawn in the order they were first used this frame; sprites
+// sharing a texture keep their submission order.
+class SpriteBatch
+{
+private:
+    struct Bucket
+    {
+        GLuint texture_id;
+        std::vector<float> vertices;    // x, y, u, v per vertex
+    };
+
+    GLuint m_vertex_buffer = 0;
+    int    m_buffer_bytes = 0;
+
+    ShaderProgram* m_program = nullptr;
+
+    std::vector<Bucket> m_buckets;      // kept across frames so their storage is reused
+    int                 m_bucket_count = 0;
+    std::vector<float>  m_upload;
+
+    SpriteBatchStats m_stats = {};
+    SpriteBatchStats m_last_frame = {};
+
+    Bucket& bucket_for(GLuint texture_id);
+
+public:
+    static constexpr int FLOATS_PER_VERTEX = 4,
+        VERTICES_PER_SPRITE = 6;
+
+    // ----- METHODS ----- //
+    void initialise(int expected_sprites);
+    void shutdown();
+
+    void begin(ShaderProgram* program);
+    void draw(GLuint texture_id, const glm::mat4& model_matrix, const UvRect& uv = FULL_TEXTURE);
+
+    // An unrotated width x height sprite centred on position, without
+    // building a model matrix
+    void draw(GLuint texture_id, glm::vec3 position, float width, float height, const UvRect& uv = FULL_TEXTURE);
+    void end();
+
+    // ----- GETTERS ----- //
+    // Counts for the most recently finished begin()/end() pair
+    const SpriteBatchStats& get_stats() const { return m_last_frame; }
+};
+
+#endif // SPRITE_BATCH_H
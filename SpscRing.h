@@ -0,0 +1,59 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+
+// Fixed-size lock-free queue for exactly one producer thread and one
+// consumer thread. push() fails instead of blocking when the ring is full;
+// nothing is ever allocated after construction.
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+    T m_items[Capacity];
+
+    // Written by one side each, kept on separate cache lines
+    alignas(64) std::atomic<size_t> m_head{ 0 };    // next slot to read
+    alignas(64) std::atomic<size_t> m_tail{ 0 };    // next slot to write
+
+public:
+    // ----- PRODUCER ----- //
+    bool push(const T& item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity) return false;
+
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ----- CONSUMER ----- //
+    bool pop(T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+        item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // The next item pop() would return, left in place
+    bool peek(T& item) const
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+        item = m_items[head & (Capacity - 1)];
+        return true;
+    }
+
+    // Approximate when called while the other side is working
+    size_t size() const { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire); }
+};
+
+#endif // SPSC_RING_H
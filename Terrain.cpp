@@ -0,0 +1,135 @@
+#include <cmath>
+#include "Terrain.h"
+
+void Terrain::reset(float origin_x, float column_width, int column_count)
+{
+    m_origin_x = origin_x;
+    m_column_width = column_width;
+    m_inverse_column_width = 1.0f / column_width;
+
+    m_top.assign(column_count, -INFINITY);
+    m_bottom.assign(column_count, -INFINITY);
+    m_kind.assign(column_count, SURFACE_NONE);
+    m_pads.clear();
+    m_highest_top = -INFINITY;
+}
+
+void Terrain::set_column(int column, float bottom, float top, SurfaceKind kind)
+{
+    m_bottom[column] = bottom;
+    m_top[column] = top;
+    m_kind[column] = kind;
+    if (kind != SURFACE_NONE && top > m_highest_top) m_highest_top = top;
+}
+
+void Terrain::add_pad(int first_column, int last_column)
+{
+    for (int c = first_column; c <= last_column; c++)
+    {
+        if (m_kind[c] != SURFACE_NONE) m_kind[c] = SURFACE_PAD;
+    }
+
+    PadRange pad;
+    pad.first_column = first_column;
+    pad.last_column = last_column;
+    m_pads.push_back(pad);
+}
+
+int Terrain::find_contact(glm::vec3 position, float width, float height) const
+{
+    int column_count = get_column_count();
+    float left = position.x - width / 2.0f;
+    float right = position.x + width / 2.0f;
+
+    // Rejecting far-off boxes first also keeps the float -> int casts below in range
+    if (!(right > m_origin_x && left < m_origin_x + column_count * m_column_width)) return -1;
+
+    // One column of slack on each side; the exact test below decides
+    int first = (int)floorf((left - m_origin_x) * m_inverse_column_width) - 1;
+    int last = (int)floorf((right - m_origin_x) * m_inverse_column_width) + 1;
+    if (first < 0) first = 0;
+    if (last > column_count - 1) last = column_count - 1;
+
+    float box_bottom = position.y - height / 2.0f;
+    float box_top = position.y + height / 2.0f;
+
+    for (int c = first; c <= last; c++)
+    {
+        if (m_kind[c] == SURFACE_NONE) continue;
+
+        float x_distance = fabs(position.x - get_column_center_x(c)) - ((width + m_column_width) / 2.0f);
+        if (x_distance < 0.0f && box_bottom < m_top[c] && box_top > m_bottom[c]) return c;
+    }
+
+    return -1;
+}
+
+// Entry and exit time of a point moving from start by delta through the
+// open interval (low, high), widened into [enter, exit]
+static inline bool clip_axis(float start, float delta, float low, float high, float& enter, float& exit)
+{
+    if (delta == 0.0f) return start > low && start < high;
+
+    float t0 = (low - start) / delta;
+    float t1 = (high - start) / delta;
+    if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+
+    if (t0 > enter) enter = t0;
+    if (t1 < exit) exit = t1;
+    return true;
+}
+
+bool Terrain::sweep(glm::vec3 position, glm::vec3 displacement, float width, float height, SweepHit& hit) const
+{
+    int column_count = get_column_count();
+    float half_width = width / 2.0f, half_height = height / 2.0f;
+
+    if (fminf(position.y, position.y + displacement.y) - half_height >= m_highest_top) return false;
+
+    float left = fminf(position.x, position.x + displacement.x) - half_width;
+    float right = fmaxf(position.x, position.x + displacement.x) + half_width;
+    if (!(right > m_origin_x && left < m_origin_x + column_count * m_column_width)) return false;
+
+    // Every column under the swept footprint, with the same slack as find_contact
+    int first = (int)floorf((left - m_origin_x) * m_inverse_column_width) - 1;
+    int last = (int)floorf((right - m_origin_x) * m_inverse_column_width) + 1;
+    if (first < 0) first = 0;
+    if (last > column_count - 1) last = column_count - 1;
+
+    bool found = false;
+    hit.time = 2.0f;
+
+    // The column grown by the box's half extents against the box's centre
+    for (int c = first; c <= last; c++)
+    {
+        if (m_kind[c] == SURFACE_NONE) continue;
+
+        float center_x = get_column_center_x(c);
+        float reach_x = (width + m_column_width) / 2.0f;
+
+        float enter = -INFINITY, exit = INFINITY;
+        if (!clip_axis(position.x, displacement.x, center_x - reach_x, center_x + reach_x, enter, exit)) continue;
+        if (!clip_axis(position.y, displacement.y, m_bottom[c] - half_height, m_top[c] + half_height, enter, exit)) continue;
+
+        // Overlap is the open interval (enter, exit); it has to start within
+        // the move and actually last
+        if (enter >= exit || exit <= 0.0f || enter > 1.0f) continue;
+
+        float time = enter > 0.0f ? enter : 0.0f;
+        if (time < hit.time)
+        {
+            hit.time = time;
+            hit.column = c;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+float Terrain::get_pad_center_x(int pad) const
+{
+    float left = m_origin_x + m_pads[pad].first_column * m_column_width;
+    float right = m_origin_x + (m_pads[pad].last_column + 1) * m_column_width;
+    return (left + right) / 2.0f;
+}
@@ -0,0 +1,73 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "glm/glm.hpp"
+
+enum SurfaceKind : uint8_t { SURFACE_NONE, SURFACE_ROCK, SURFACE_PAD };
+
+struct PadRange
+{
+    int first_column;
+    int last_column;
+};
+
+struct SweepHit
+{
+    float time;     // fraction of the displacement covered before contact, 0..1
+    int   column;
+};
+
+// Level geometry as a row of equal-width columns. Each column is solid from
+// its bottom up to its top (bottom may be -INFINITY for ground that goes all
+// the way down), so a box only ever needs to look at the few columns under
+// its own footprint, however wide the level is.
+class Terrain
+{
+private:
+    float m_origin_x = 0.0f;        // left edge of column 0
+    float m_column_width = 1.0f;
+    float m_inverse_column_width = 1.0f;
+
+    std::vector<float> m_top;
+    std::vector<float> m_bottom;
+    std::vector<SurfaceKind> m_kind;
+
+    std::vector<PadRange> m_pads;
+
+    float m_highest_top = -INFINITY;    // lets sweep() skip a box flying above everything
+
+public:
+    // ----- METHODS ----- //
+    void reset(float origin_x, float column_width, int column_count);
+    void set_column(int column, float bottom, float top, SurfaceKind kind = SURFACE_ROCK);
+    void add_pad(int first_column, int last_column);
+
+    // Leftmost solid column overlapping the box, or -1. Only the columns
+    // under the footprint are visited, so the cost does not grow with the
+    // column count.
+    int find_contact(glm::vec3 position, float width, float height) const;
+
+    // Earliest contact of a box moving in a straight line from position by
+    // displacement, found exactly rather than by testing where it ends up,
+    // so nothing thin is skipped however far it moves. Boxes merely touching
+    // a column do not count (as in find_contact) unless they move into it;
+    // one already overlapping hits at time 0. Ties go to the leftmost column.
+    bool sweep(glm::vec3 position, glm::vec3 displacement, float width, float height, SweepHit& hit) const;
+
+    // ----- GETTERS ----- //
+    int         get_column_count()        const { return (int)m_kind.size(); }
+    float       get_origin_x()            const { return m_origin_x; }
+    float       get_column_width()        const { return m_column_width; }
+    float       get_top(int column)       const { return m_top[column]; }
+    float       get_bottom(int column)    const { return m_bottom[column]; }
+    SurfaceKind get_kind(int column)      const { return m_kind[column]; }
+    float       get_column_center_x(int column) const { return m_origin_x + (column + 0.5f) * m_column_width; }
+
+    const std::vector<PadRange>& get_pads() const { return m_pads; }
+    float get_pad_center_x(int pad) const;
+};
+
+#endif // TERRAIN_H
@@ -0,0 +1,349 @@
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <sys/stat.h>
+#include "stb_image.h"
+#include "TextureAtlas.h"
+
+static const char ATLAS_CACHE_MAGIC[4] = { 'L', 'L', 'A', '1' };
+static const char ATLAS_INDEX_SUFFIX[] = ".index";
+
+static bool stat_file(const char* path, long long& size, long long& mtime)
+{
+    struct stat info;
+    if (stat(path, &info) != 0) return false;
+
+    size = (long long)info.st_size;
+    mtime = (long long)info.st_mtime;
+    return true;
+}
+
+static int next_power_of_two(int value)
+{
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+bool TextureAtlas::build(const char* const* paths, int count)
+{
+    begin_build(paths, count);
+    for (int i = 0; i < count; i++)
+    {
+        if (!decode(i)) break;
+    }
+    return pack();
+}
+
+void TextureAtlas::begin_build(const char* const* paths, int count)
+{
+    free_images();
+    m_images.assign(count, Image());
+    m_entries.assign(count, Entry());
+
+    for (int i = 0; i < count; i++)
+    {
+        m_images[i].pixels = NULL;
+        m_entries[i].path = paths[i];
+    }
+}
+
+bool TextureAtlas::decode(int index)
+{
+    Image& image = m_images[index];
+    Entry& entry = m_entries[index];
+
+    int number_of_components;
+    image.pixels = stbi_load(entry.path.c_str(), &image.width, &image.height, &number_of_components, STBI_rgb_alpha);
+    if (image.pixels == NULL) return false;
+
+    if (!stat_file(entry.path.c_str(), entry.source_size, entry.source_mtime)) {
+        entry.source_size = entry.source_mtime = -1;
+    }
+    entry.width = image.width;
+    entry.height = image.height;
+    return true;
+}
+
+void TextureAtlas::free_images()
+{
+    for (Image& image : m_images)
+    {
+        if (image.pixels != NULL) stbi_image_free(image.pixels);
+    }
+    m_images.clear();
+}
+
+bool TextureAtlas::pack()
+{
+    std::vector<Image>& images = m_images;
+    int count = (int)images.size();
+
+    int widest = 0;
+    long long area = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (images[i].pixels == NULL)
+        {
+            free_images();
+            return false;
+        }
+
+        widest = std::max(widest, images[i].width + 2 * PADDING);
+        area += (long long)(images[i].width + 2 * PADDING) * (images[i].height + 2 * PADDING);
+    }
+
+    // ----- PACKING ----- //
+    // Shelves, tallest images first, in a power-of-two wide strip
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return images[a].height > images[b].height; });
+
+    m_width = next_power_of_two(std::max(widest, (int)ceil(sqrt((double)area))));
+
+    int shelf_x = 0, shelf_y = 0, shelf_height = 0;
+    for (int k = 0; k < count; k++)
+    {
+        Entry& entry = m_entries[order[k]];
+        int padded_width = entry.width + 2 * PADDING;
+        int padded_height = entry.height + 2 * PADDING;
+
+        if (shelf_x + padded_width > m_width)
+        {
+            shelf_y += shelf_height;
+            shelf_x = 0;
+            shelf_height = 0;
+        }
+
+        entry.x = shelf_x + PADDING;
+        entry.y = shelf_y + PADDING;
+        shelf_x += padded_width;
+        shelf_height = std::max(shelf_height, padded_height);
+    }
+    m_height = next_power_of_two(shelf_y + shelf_height);
+
+    // ----- BLITTING ----- //
+    m_mapped_pixels = nullptr;
+    m_pixels.assign((size_t)m_width * m_height * 4, 0);
+    for (int i = 0; i < count; i++)
+    {
+        const Entry& entry = m_entries[i];
+
+        // The padding repeats the edge pixels so filtering never picks up a neighbour
+        for (int y = -PADDING; y < entry.height + PADDING; y++)
+        {
+            int source_y = std::min(std::max(y, 0), entry.height - 1);
+            for (int x = -PADDING; x < entry.width + PADDING; x++)
+            {
+                int source_x = std::min(std::max(x, 0), entry.width - 1);
+                memcpy(&m_pixels[((size_t)(entry.y + y) * m_width + entry.x + x) * 4],
+                    &images[i].pixels[((size_t)source_y * entry.width + source_x) * 4], 4);
+            }
+        }
+    }
+
+    free_images();
+    return true;
+}
+
+bool TextureAtlas::save_cache(const char* cache_path) const
+{
+    FILE* file = fopen(cache_path, "wb");
+    if (file == NULL) return false;
+
+    int32_t header[3] = { m_width, m_height, (int32_t)m_entries.size() };
+    bool ok = fwrite(ATLAS_CACHE_MAGIC, sizeof(ATLAS_CACHE_MAGIC), 1, file) == 1 &&
+        fwrite(header, sizeof(header), 1, file) == 1;
+
+    for (size_t i = 0; ok && i < m_entries.size(); i++)
+    {
+        const Entry& entry = m_entries[i];
+        int32_t path_length = (int32_t)entry.path.size();
+        int64_t source[2] = { entry.source_size, entry.source_mtime };
+        int32_t rect[4] = { entry.x, entry.y, entry.width, entry.height };
+
+        ok = fwrite(&path_length, sizeof(path_length), 1, file) == 1 &&
+            fwrite(entry.path.data(), 1, path_length, file) == (size_t)path_length &&
+            fwrite(source, sizeof(source), 1, file) == 1 &&
+            fwrite(rect, sizeof(rect), 1, file) == 1;
+    }
+
+    ok = ok && fwrite(m_pixels.data(), 1, m_pixels.size(), file) == m_pixels.size();
+
+    fclose(file);
+    if (!ok) remove(cache_path);
+    return ok;
+}
+
+bool TextureAtlas::load_cache(const char* cache_path, const char* const* paths, int count)
+{
+    FILE* file = fopen(cache_path, "rb");
+    if (file == NULL) return false;
+
+    char magic[4];
+    int32_t header[3];
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1 && memcmp(magic, ATLAS_CACHE_MAGIC, sizeof(magic)) == 0 &&
+        fread(header, sizeof(header), 1, file) == 1 && header[2] == count &&
+        header[0] > 0 && header[1] > 0 && header[0] <= 16384 && header[1] <= 16384;
+
+    std::vector<Entry> entries(ok ? count : 0);
+    for (int i = 0; ok && i < count; i++)
+    {
+        int32_t path_length;
+        int64_t source[2];
+        int32_t rect[4];
+
+        ok = fread(&path_length, sizeof(path_length), 1, file) == 1 && path_length >= 0 && path_length < 4096;
+        if (!ok) break;
+
+        entries[i].path.resize(path_length);
+        ok = fread(&entries[i].path[0], 1, path_length, file) == (size_t)path_length &&
+            fread(source, sizeof(source), 1, file) == 1 &&
+            fread(rect, sizeof(rect), 1, file) == 1;
+        if (!ok) break;
+
+        // Stale if the list changed or any source image was touched since packing
+        long long size, mtime;
+        ok = entries[i].path == paths[i] && stat_file(paths[i], size, mtime) &&
+            size == source[0] && mtime == source[1];
+
+        entries[i].source_size = source[0];
+        entries[i].source_mtime = source[1];
+        entries[i].x = rect[0];
+        entries[i].y = rect[1];
+        entries[i].width = rect[2];
+        entries[i].height = rect[3];
+    }
+
+    std::vector<unsigned char> pixels;
+    if (ok)
+    {
+        pixels.resize((size_t)header[0] * header[1] * 4);
+        ok = fread(pixels.data(), 1, pixels.size(), file) == pixels.size();
+    }
+
+    fclose(file);
+    if (!ok) return false;
+
+    m_width = header[0];
+    m_height = header[1];
+    m_entries.swap(entries);
+    m_pixels.swap(pixels);
+    m_mapped_pixels = nullptr;
+    return true;
+}
+
+bool TextureAtlas::save_pack(AssetPackWriter& writer, const char* name) const
+{
+    // Same entry layout as the cache, minus the source stamps: a pack is
+    // rebuilt by hand, not checked against the loose files
+    std::vector<unsigned char> index;
+    auto append = [&index](const void* data, size_t size) {
+        index.insert(index.end(), (const unsigned char*)data, (const unsigned char*)data + size);
+    };
+
+    int32_t count = (int32_t)m_entries.size();
+    append(&count, sizeof(count));
+    for (const Entry& entry : m_entries)
+    {
+        int32_t rect[4] = { entry.x, entry.y, entry.width, entry.height };
+        int32_t path_length = (int32_t)entry.path.size();
+        append(rect, sizeof(rect));
+        append(&path_length, sizeof(path_length));
+        append(entry.path.data(), entry.path.size());
+    }
+
+    std::string index_name = std::string(name) + ATLAS_INDEX_SUFFIX;
+    return writer.add_texture(name, m_width, m_height, m_pixels.data()) &&
+        writer.add_raw(index_name.c_str(), index.data(), index.size());
+}
+
+bool TextureAtlas::load_pack(const AssetPack& pack, const char* name, const char* const* paths, int count)
+{
+    std::string index_name = std::string(name) + ATLAS_INDEX_SUFFIX;
+    const AssetPackEntry* texture = pack.find(name);
+    const AssetPackEntry* index = pack.find(index_name.c_str());
+    if (texture == nullptr || index == nullptr || texture->type != ASSET_TEXTURE) return false;
+
+    const unsigned char* read = pack.get_data(*index);
+    const unsigned char* end = read + index->size;
+    auto take = [&read, end](void* data, size_t size) {
+        if ((size_t)(end - read) < size) return false;
+        memcpy(data, read, size);
+        read += size;
+        return true;
+    };
+
+    int32_t stored_count;
+    bool ok = take(&stored_count, sizeof(stored_count)) && stored_count == count;
+
+    std::vector<Entry> entries(ok ? count : 0);
+    for (int i = 0; ok && i < count; i++)
+    {
+        int32_t rect[4], path_length;
+        ok = take(rect, sizeof(rect)) && take(&path_length, sizeof(path_length)) &&
+            path_length >= 0 && (size_t)(end - read) >= (size_t)path_length;
+        if (!ok) break;
+
+        // Built from a different list of images
+        entries[i].path.assign((const char*)read, path_length);
+        read += path_length;
+        ok = entries[i].path == paths[i] && rect[0] >= 0 && rect[1] >= 0 && rect[2] > 0 && rect[3] > 0 &&
+            rect[0] + rect[2] <= texture->width && rect[1] + rect[3] <= texture->height;
+
+        entries[i].source_size = entries[i].source_mtime = -1;
+        entries[i].x = rect[0];
+        entries[i].y = rect[1];
+        entries[i].width = rect[2];
+        entries[i].height = rect[3];
+    }
+    if (!ok) return false;
+
+    m_width = texture->width;
+    m_height = texture->height;
+    m_entries.swap(entries);
+    std::vector<unsigned char>().swap(m_pixels);
+    m_mapped_pixels = pack.get_data(*texture);
+    return true;
+}
+
+GLuint TextureAtlas::upload()
+{
+    const unsigned char* pixels = m_mapped_pixels != nullptr ? m_mapped_pixels : m_pixels.data();
+
+    glGenTextures(1, &m_texture_id);
+    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    std::vector<unsigned char>().swap(m_pixels);
+    m_mapped_pixels = nullptr;
+    return m_texture_id;
+}
+
+UvRect TextureAtlas::get_rect(int index) const
+{
+    const Entry& entry = m_entries[index];
+
+    UvRect rect;
+    rect.u0 = (float)entry.x / m_width;
+    rect.v0 = (float)entry.y / m_height;
+    rect.u1 = (float)(entry.x + entry.width) / m_width;
+    rect.v1 = (float)(entry.y + entry.height) / m_height;
+    return rect;
+}
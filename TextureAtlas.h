@@ -0,0 +1,90 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <string>
+#include <vector>
+#include "AssetPack.h"
+#include "SpriteBatch.h"
+
+// Packs every sprite image into one RGBA texture at startup, so a frame
+// binds a single texture and the sprite batch draws it in one call.
+//
+// The packed pixels can be written to a cache file next to the assets.
+// The cache records the size and modification time of every source image
+// and is only used while all of them still match, so later launches skip
+// PNG decoding entirely. An asset pack can carry the packed atlas too, and
+// then the pixels are uploaded straight from the pack's mapping.
+class TextureAtlas
+{
+private:
+    struct Entry
+    {
+        std::string path;
+        long long   source_size;
+        long long   source_mtime;
+        int x, y, width, height;    // in pixels, without padding
+    };
+
+    struct Image
+    {
+        int width, height;
+        unsigned char* pixels;
+    };
+
+    int m_width = 0,
+        m_height = 0;
+    std::vector<unsigned char> m_pixels;
+    const unsigned char* m_mapped_pixels = nullptr;     // inside an AssetPack, used instead of m_pixels
+    std::vector<Entry> m_entries;
+    std::vector<Image> m_images;        // decoded sources waiting for pack()
+
+    GLuint m_texture_id = 0;
+
+    void free_images();
+
+public:
+    static constexpr int PADDING = 1;   // border pixels duplicated around each sprite
+
+    ~TextureAtlas() { free_images(); }
+
+    // ----- METHODS ----- //
+    // Decodes the images (in the given order) and packs them
+    bool build(const char* const* paths, int count);
+
+    // build() in three steps, so the images can be decoded on several
+    // threads: begin_build() sets up one slot per path, decode() may then
+    // run for different indices at the same time, and pack() runs once
+    // every decode() has returned. pack() fails if any of them did.
+    void begin_build(const char* const* paths, int count);
+    bool decode(int index);
+    bool pack();
+
+    bool load_cache(const char* cache_path, const char* const* paths, int count);
+    bool save_cache(const char* cache_path) const;
+
+    // The pixels as a texture entry called name, and the sprite rectangles
+    // as a raw entry called name.index
+    bool save_pack(AssetPackWriter& writer, const char* name) const;
+    // Nothing is copied: the pack has to stay open until upload()
+    bool load_pack(const AssetPack& pack, const char* name, const char* const* paths, int count);
+
+    // Creates the GL texture; the CPU copy of the pixels (or the reference
+    // into the pack) is released afterwards
+    GLuint upload();
+
+    // ----- GETTERS ----- //
+    GLuint get_texture_id() const { return m_texture_id; }
+    int    get_width()      const { return m_width; }
+    int    get_height()     const { return m_height; }
+
+    // Width * height * 4 bytes of RGBA until upload(), null afterwards
+    const unsigned char* get_pixels() const
+    {
+        return m_mapped_pixels != nullptr ? m_mapped_pixels : m_pixels.empty() ? nullptr : m_pixels.data();
+    }
+
+    // UV rectangle of the index-th image passed to build()/load_cache()
+    UvRect get_rect(int index) const;
+};
+
+#endif // TEXTURE_ATLAS_H
@@ -0,0 +1,49 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Hands the newest value from one writer thread to one reader thread
+// without locks and without either side ever waiting. The writer fills
+// back() and publishes it; the reader calls update() and then reads
+// front(), which stays untouched until its next update(). Values the
+// reader never got round to are simply skipped.
+template <typename T>
+class TripleBuffer
+{
+private:
+    static constexpr uint8_t INDEX_MASK = 3,
+        FRESH = 4;                      // set while the middle buffer holds an unread value
+
+    T m_buffers[3];
+
+    uint8_t m_back = 0;                 // writer only
+    alignas(64) std::atomic<uint8_t> m_middle{ 1 };
+    alignas(64) uint8_t m_front = 2;    // reader only
+
+public:
+    // ----- WRITER ----- //
+    T& back() { return m_buffers[m_back]; }
+
+    void publish()
+    {
+        uint8_t previous = m_middle.exchange((uint8_t)(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    // ----- READER ----- //
+    // Returns whether front() changed
+    bool update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+
+        uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return m_buffers[m_front]; }
+};
+
+#endif // TRIPLE_BUFFER_H
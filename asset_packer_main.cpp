@@ -0,0 +1,61 @@
+/**
+* Asset packer.
+*
+* Builds the game's asset pack (see AssetPack.h): the sprite atlas, decoded
+* and packed ahead of time, and every other file in GameAssets.h stored as
+* it is. Files that are missing are skipped with a note, so a checkout
+* without the audio still gets a pack. Run it from the game's working
+* directory whenever an asset changes; the game prefers the pack over the
+* loose files while it exists.
+*
+* Builds from AssetPack.cpp and TextureAtlas.cpp plus a translation unit
+* with STB_IMAGE_IMPLEMENTATION, linking against SDL2 and OpenGL.
+*
+*   asset_packer [output]     (default assets.pack)
+**/
+#include <cstdio>
+#include "AssetPack.h"
+#include "GameAssets.h"
+#include "TextureAtlas.h"
+
+int main(int argc, char* argv[])
+{
+    const char* output = argc > 1 ? argv[1] : ASSET_PACK_FILEPATH;
+
+    TextureAtlas atlas;
+    if (!atlas.build(ATLAS_SOURCES, ATLAS_SPRITE_COUNT))
+    {
+        printf("could not decode the atlas images\n");
+        return 1;
+    }
+
+    AssetPackWriter writer;
+    if (!atlas.save_pack(writer, ATLAS_PACK_NAME))
+    {
+        printf("could not add the atlas\n");
+        return 1;
+    }
+    printf("%-36s %dx%d atlas of %d images\n", ATLAS_PACK_NAME, atlas.get_width(), atlas.get_height(), ATLAS_SPRITE_COUNT);
+
+    for (int i = 0; i < PACKED_FILE_COUNT; i++)
+    {
+        bool added = writer.add_file(PACKED_FILES[i]);
+        printf("%-36s %s\n", PACKED_FILES[i], added ? "stored" : "missing, skipped");
+    }
+
+    if (!writer.save(output))
+    {
+        printf("could not write %s\n", output);
+        return 1;
+    }
+
+    AssetPack pack;
+    if (!pack.open(output))
+    {
+        printf("%s does not read back\n", output);
+        return 1;
+    }
+
+    printf("wrote %s: %d entries\n", output, pack.get_entry_count());
+    return 0;
+}
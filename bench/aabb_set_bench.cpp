@@ -0,0 +1,151 @@
+/**
+* One box against many: AabbSet's kernels vs. the aabb_overlap loop.
+*
+* For 21 boxes (the classic level's blocks), 1000 and 100000 (scattered
+* boxes), times a batch of query boxes through the scalar loop step_lander
+* uses (aabb_overlap over an array of Blocks) and through every AabbSet
+* kernel this CPU can run, both for the first hit and for the full hit
+* mask. Every kernel must return the same first hit and the same mask as
+* the loop, query for query.
+*
+*   aabb_set_bench [query_count]
+*
+* Build with -O2 (no -m flags: the kernels are picked at run time) together
+* with ../AabbSet.cpp, ../Simulation.cpp and ../Terrain.cpp.
+**/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../AabbSet.h"
+#include "../Simulation.h"
+
+static uint32_t g_seed = 777;
+
+static float random_range(float low, float high)
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return low + (high - low) * (float)(g_seed >> 8) / (float)(1u << 24);
+}
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    int query_count = argc > 1 ? atoi(argv[1]) : 2000;
+    const int box_counts[] = { 21, 1000, 100000 };
+    bool ok = true;
+
+    AabbKernel best = get_best_aabb_kernel();
+    printf("best kernel on this CPU: %s\n\n", get_aabb_kernel_name(best));
+    printf("%8s %-8s %16s %16s %12s\n", "boxes", "kernel", "first ns/query", "mask ns/query", "hits/query");
+
+    for (int box_count : box_counts)
+    {
+        // ----- BOXES ----- //
+        std::vector<Block> blocks(box_count);
+        float extent = box_count == 21 ? 5.5f : sqrtf((float)box_count) * 0.5f;
+        if (box_count == 21)
+        {
+            build_classic_blocks(blocks.data(), 7);
+        }
+        else
+        {
+            for (Block& block : blocks)
+            {
+                block.position = glm::vec3(random_range(-extent, extent), random_range(-extent, extent), 0.0f);
+                block.width = random_range(0.1f, 0.5f);
+                block.height = random_range(0.1f, 0.5f);
+                block.is_platform = false;
+            }
+        }
+
+        AabbSet set;
+        set.reserve(box_count);
+        for (const Block& block : blocks) set.add(block.position, block.width, block.height);
+
+        // Landers scattered over the same area, so some queries hit and most miss
+        std::vector<glm::vec3> queries(query_count);
+        for (glm::vec3& query : queries)
+        {
+            query = glm::vec3(random_range(-extent, extent), random_range(box_count == 21 ? -4.0f : -extent, extent), 0.0f);
+        }
+        const float size = 0.75f;
+
+        // ----- SCALAR LOOP ----- //
+        std::vector<int> expected_first(query_count);
+        std::vector<uint64_t> expected_mask((size_t)query_count * set.get_mask_words(), 0);
+        long long hits = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int q = 0; q < query_count; q++)
+        {
+            expected_first[q] = -1;
+            for (int i = 0; i < box_count; i++)
+            {
+                if (aabb_overlap(queries[q], size, size, blocks[i].position, blocks[i].width, blocks[i].height))
+                {
+                    expected_first[q] = i;
+                    break;
+                }
+            }
+        }
+        double loop_first_ns = elapsed_ns(start) / query_count;
+
+        start = std::chrono::steady_clock::now();
+        for (int q = 0; q < query_count; q++)
+        {
+            uint64_t* mask = &expected_mask[(size_t)q * set.get_mask_words()];
+            for (int i = 0; i < box_count; i++)
+            {
+                if (aabb_overlap(queries[q], size, size, blocks[i].position, blocks[i].width, blocks[i].height))
+                {
+                    mask[i / 64] |= 1ull << (i % 64);
+                    hits++;
+                }
+            }
+        }
+        double loop_mask_ns = elapsed_ns(start) / query_count;
+
+        printf("%8d %-8s %16.1f %16.1f %12.2f\n", box_count, "loop", loop_first_ns, loop_mask_ns, (double)hits / query_count);
+
+        // ----- KERNELS ----- //
+        std::vector<uint64_t> mask(set.get_mask_words());
+        for (int kernel = AABB_SCALAR; kernel <= best; kernel++)
+        {
+            set_aabb_kernel((AabbKernel)kernel);
+
+            int sink = 0;
+            start = std::chrono::steady_clock::now();
+            for (int q = 0; q < query_count; q++) sink += set.find_first(queries[q], size, size);
+            double first_ns = elapsed_ns(start) / query_count;
+
+            start = std::chrono::steady_clock::now();
+            for (int q = 0; q < query_count; q++) sink += set.find_all(queries[q], size, size, mask.data());
+            double mask_ns = elapsed_ns(start) / query_count;
+
+            // Correctness outside the timed loops
+            int wrong = 0;
+            for (int q = 0; q < query_count; q++)
+            {
+                if (set.find_first(queries[q], size, size) != expected_first[q]) wrong++;
+                set.find_all(queries[q], size, size, mask.data());
+                for (int w = 0; w < set.get_mask_words(); w++)
+                {
+                    if (mask[w] != expected_mask[(size_t)q * set.get_mask_words() + w]) { wrong++; break; }
+                }
+            }
+            if (wrong) ok = false;
+
+            printf("%8s %-8s %16.1f %16.1f %12s   %.1fx / %.1fx%s (sink %d)\n", "", get_aabb_kernel_name((AabbKernel)kernel),
+                first_ns, mask_ns, "", loop_first_ns / first_ns, loop_mask_ns / mask_ns, wrong ? "  WRONG" : "", sink);
+        }
+        set_aabb_kernel(best);
+    }
+
+    printf("\nkernels %s the scalar loop\n", ok ? "agree with" : "DISAGREE with");
+    return ok ? 0 : 1;
+}
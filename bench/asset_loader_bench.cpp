@@ -0,0 +1,214 @@
+/**
+* Startup asset loading: blocking vs. on the AssetLoader's workers.
+*
+* Loads the sprite atlas the way initialise() used to (every PNG decoded in
+* turn, then packed, all before the first frame) and the way it does now
+* (one decode task per image on the worker pool, a pack task once they are
+* all in, the GL-thread side pumped once per simulated 16 ms frame). Cold
+* runs decode the PNGs, warm runs read the atlas cache. For each it reports
+* when the first frame could be shown and when loading was done, and it
+* checks that the parallel build packs exactly the same atlas.
+*
+* The asset set is the game's five images, repeated to make the decode
+* work large enough to split. Pass the assets directory (default
+* ../assets) and optionally the repeat count and the worker count.
+*
+* Build with -O2 together with ../AssetLoader.cpp, ../TextureAtlas.cpp,
+* ../AssetPack.cpp, ../JobSystem.cpp, ../GlState.cpp and
+* ../ShaderProgram.cpp, plus a translation unit with
+* STB_IMAGE_IMPLEMENTATION, linking against SDL2 and OpenGL.
+**/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../AssetLoader.h"
+#include "../JobSystem.h"
+#include "../TextureAtlas.h"
+
+static const char* const SOURCE_NAMES[] = { "block.png", "platform.png", "font1.png", "lunarLander.png", "flame.png" };
+static const int SOURCE_COUNT = 5;
+static const double FRAME_MS = 1000.0 / 60.0;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool same_file(const char* a, const char* b)
+{
+    FILE* file_a = fopen(a, "rb");
+    FILE* file_b = fopen(b, "rb");
+    bool same = file_a != NULL && file_b != NULL;
+
+    while (same)
+    {
+        int byte_a = fgetc(file_a), byte_b = fgetc(file_b);
+        same = byte_a == byte_b;
+        if (byte_a == EOF) break;
+    }
+
+    if (file_a) fclose(file_a);
+    if (file_b) fclose(file_b);
+    return same;
+}
+
+// ----- LOADER TASKS ----- //
+// The same chain main.cpp runs: cache read, or decodes followed by a pack
+struct Load
+{
+    AssetLoader*       loader;
+    TextureAtlas*      atlas;
+    const char* const* paths;
+    int                count;
+    const char*        cache_path;
+    int                decodes_left;
+    bool               done, ok;
+};
+
+struct Decode
+{
+    Load* load;
+    int   index;
+};
+
+static bool decode_task(void* context)
+{
+    Decode* decode = (Decode*)context;
+    return decode->load->atlas->decode(decode->index);
+}
+
+static bool pack_task(void* context)
+{
+    Load* load = (Load*)context;
+    return load->atlas->pack() && load->atlas->save_cache(load->cache_path);
+}
+
+static bool cache_task(void* context)
+{
+    Load* load = (Load*)context;
+    return load->atlas->load_cache(load->cache_path, load->paths, load->count);
+}
+
+static void on_ready(bool ok, void* context)
+{
+    Load* load = (Load*)context;
+    load->done = true;
+    load->ok = ok;
+}
+
+static void on_decoded(bool ok, void* context)
+{
+    Load* load = ((Decode*)context)->load;
+    if (--load->decodes_left == 0) load->loader->submit(pack_task, on_ready, load);
+}
+
+struct Timing
+{
+    double first_frame_ms, loaded_ms;
+    int    frames;
+    bool   ok;
+};
+
+// Frames are simulated: pump, then sleep out the rest of the 16 ms
+static Timing run_async(AssetLoader& loader, TextureAtlas& atlas, const std::vector<const char*>& paths,
+    const char* cache_path, bool warm)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    Load load = { &loader, &atlas, paths.data(), (int)paths.size(), cache_path, (int)paths.size(), false, false };
+    std::vector<Decode> decodes(paths.size());
+
+    if (warm) {
+        loader.submit(cache_task, on_ready, &load);
+    }
+    else {
+        atlas.begin_build(paths.data(), (int)paths.size());
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            decodes[i] = { &load, (int)i };
+            loader.submit(decode_task, on_decoded, &decodes[i]);
+        }
+    }
+
+    Timing timing = { -1.0, -1.0, 0, false };
+    while (!load.done)
+    {
+        auto frame_start = std::chrono::steady_clock::now();
+        loader.pump(2.0);
+        timing.frames++;
+        if (timing.first_frame_ms < 0.0) timing.first_frame_ms = elapsed_ms(start);
+
+        double left = FRAME_MS - elapsed_ms(frame_start);
+        if (!load.done && left > 0.0) std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(left));
+    }
+    timing.loaded_ms = elapsed_ms(start);
+    timing.ok = load.ok;
+    return timing;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string directory = argc > 1 ? argv[1] : "../assets";
+    int repeats = argc > 2 ? atoi(argv[2]) : 8;
+    int core_count = get_core_count();
+    int workers = argc > 3 ? atoi(argv[3]) : (core_count > 1 ? core_count - 1 : 1);
+
+    std::vector<std::string> names;
+    for (int r = 0; r < repeats; r++)
+    {
+        for (int i = 0; i < SOURCE_COUNT; i++) names.push_back(directory + "/" + SOURCE_NAMES[i]);
+    }
+    std::vector<const char*> paths;
+    for (const std::string& name : names) paths.push_back(name.c_str());
+
+    const char* blocking_cache = "asset_loader_bench_blocking.cache";
+    const char* async_cache = "asset_loader_bench_async.cache";
+
+    printf("%d images, %d workers (%d cores)\n\n", (int)paths.size(), workers, core_count);
+
+    // ----- BLOCKING ----- //
+    // Everything happens before the first frame, so both times are the same
+    auto start = std::chrono::steady_clock::now();
+    TextureAtlas blocking;
+    bool built = blocking.build(paths.data(), (int)paths.size()) && blocking.save_cache(blocking_cache);
+    double blocking_cold = elapsed_ms(start);
+    if (!built) {
+        printf("could not load the images from %s\n", directory.c_str());
+        return 1;
+    }
+
+    start = std::chrono::steady_clock::now();
+    TextureAtlas blocking_warm_atlas;
+    bool cached = blocking_warm_atlas.load_cache(blocking_cache, paths.data(), (int)paths.size());
+    double blocking_warm = elapsed_ms(start);
+
+    // ----- ASYNC ----- //
+    AssetLoader loader;
+    loader.initialise(workers);
+
+    TextureAtlas async_atlas;
+    Timing cold = run_async(loader, async_atlas, paths, async_cache, false);
+    TextureAtlas async_warm_atlas;
+    Timing warm = run_async(loader, async_warm_atlas, paths, async_cache, true);
+
+    AssetLoaderStats stats = loader.get_stats();
+    loader.shutdown();
+
+    printf("%-22s %16s %16s %8s\n", "", "first frame (ms)", "loaded (ms)", "frames");
+    printf("%-22s %16.2f %16.2f %8d\n", "blocking, cold", blocking_cold, blocking_cold, 0);
+    printf("%-22s %16.2f %16.2f %8d\n", "blocking, warm", blocking_warm, blocking_warm, 0);
+    printf("%-22s %16.2f %16.2f %8d\n", "worker pool, cold", cold.first_frame_ms, cold.loaded_ms, cold.frames);
+    printf("%-22s %16.2f %16.2f %8d\n", "worker pool, warm", warm.first_frame_ms, warm.loaded_ms, warm.frames);
+    printf("\nworker time %.2f ms over %d tasks, GL-thread time %.3f ms (longest %.3f ms)\n",
+        stats.work_ms, stats.completed, stats.ready_ms, stats.longest_ready_ms);
+
+    bool same = cold.ok && warm.ok && cached && same_file(blocking_cache, async_cache);
+    printf("parallel atlas matches the sequential one: %s\n", same ? "yes" : "NO");
+
+    remove(blocking_cache);
+    remove(async_cache);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+/**
+* Atlas loading: loose PNGs vs. the atlas cache vs. the mapped asset pack.
+*
+* Builds a cache and a pack from the game's atlas images, then loads the
+* atlas each way and reads every pixel once, the way glTexImage2D would:
+*
+*   decode  - the PNGs, decoded and packed (5 opens)
+*   cache   - the atlas cache, read into memory (1 open, 5 stats)
+*   pack    - the asset pack, mapped and read in place (1 open)
+*
+* Each runs warm (files in the page cache) and, on Linux, cold (the files
+* evicted from the page cache first, as on a first launch or a network
+* filesystem). Reports time and page faults per load, and checks that the
+* pack holds the same rectangles and, byte for byte, the same pixels as
+* the cache.
+*
+* Run from the game's working directory (the one holding assets/).
+*
+* Build with -O2 together with ../AssetPack.cpp, ../TextureAtlas.cpp and
+* ../ShaderProgram.cpp, plus a translation unit with
+* STB_IMAGE_IMPLEMENTATION, linking against SDL2 and OpenGL.
+**/
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "../AssetPack.h"
+#include "../GameAssets.h"
+#include "../TextureAtlas.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+static const char* const CACHE_PATH = "asset_pack_bench.cache";
+static const char* const PACK_PATH = "asset_pack_bench.pack";
+static const int RUNS = 5;
+
+enum Mode { MODE_DECODE, MODE_CACHE, MODE_PACK, MODE_COUNT };
+static const char* const MODE_NAMES[MODE_COUNT] = { "decode", "cache", "pack" };
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Drops a file's pages from the page cache; false where that is not possible
+static bool evict(const char* path)
+{
+#ifdef __linux__
+    int file = open(path, O_RDONLY);
+    if (file < 0) return false;
+
+    fdatasync(file);
+    bool ok = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(file);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+static void page_faults(long& minor, long& major)
+{
+#ifdef __linux__
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    minor = usage.ru_minflt;
+    major = usage.ru_majflt;
+#else
+    minor = major = 0;
+#endif
+}
+
+// Stands in for the upload: every pixel byte is read once
+static unsigned touch(const unsigned char* pixels, size_t size)
+{
+    unsigned sum = 0;
+    for (size_t i = 0; i < size; i += 64) sum += pixels[i];
+    return sum;
+}
+
+struct Result
+{
+    double ms;
+    long   minor_faults, major_faults;
+};
+
+static Result load(Mode mode, bool cold, unsigned& checksum)
+{
+    if (cold)
+    {
+        for (int i = 0; i < ATLAS_SPRITE_COUNT; i++) evict(ATLAS_SOURCES[i]);
+        evict(CACHE_PATH);
+        evict(PACK_PATH);
+    }
+
+    long minor_before, major_before;
+    page_faults(minor_before, major_before);
+    auto start = std::chrono::steady_clock::now();
+
+    TextureAtlas atlas;
+    AssetPack pack;
+    bool ok;
+    switch (mode) {
+    case MODE_DECODE: ok = atlas.build(ATLAS_SOURCES, ATLAS_SPRITE_COUNT); break;
+    case MODE_CACHE:  ok = atlas.load_cache(CACHE_PATH, ATLAS_SOURCES, ATLAS_SPRITE_COUNT); break;
+    default:
+        ok = pack.open(PACK_PATH) && atlas.load_pack(pack, ATLAS_PACK_NAME, ATLAS_SOURCES, ATLAS_SPRITE_COUNT);
+        break;
+    }
+    if (ok) checksum = touch(atlas.get_pixels(), (size_t)atlas.get_width() * atlas.get_height() * 4);
+
+    Result result;
+    result.ms = elapsed_ms(start);
+    page_faults(result.minor_faults, result.major_faults);
+    result.minor_faults -= minor_before;
+    result.major_faults -= major_before;
+    if (!ok) result.ms = -1.0;
+    return result;
+}
+
+static bool same_pixels()
+{
+    TextureAtlas cached, packed;
+    AssetPack pack;
+    bool ok = cached.load_cache(CACHE_PATH, ATLAS_SOURCES, ATLAS_SPRITE_COUNT) &&
+        pack.open(PACK_PATH) && packed.load_pack(pack, ATLAS_PACK_NAME, ATLAS_SOURCES, ATLAS_SPRITE_COUNT) &&
+        cached.get_width() == packed.get_width() && cached.get_height() == packed.get_height();
+
+    for (int i = 0; ok && i < ATLAS_SPRITE_COUNT; i++)
+    {
+        UvRect a = cached.get_rect(i), b = packed.get_rect(i);
+        ok = a.u0 == b.u0 && a.v0 == b.v0 && a.u1 == b.u1 && a.v1 == b.v1;
+    }
+
+    return ok && memcmp(cached.get_pixels(), packed.get_pixels(), (size_t)cached.get_width() * cached.get_height() * 4) == 0;
+}
+
+int main()
+{
+    TextureAtlas atlas;
+    AssetPackWriter writer;
+    if (!atlas.build(ATLAS_SOURCES, ATLAS_SPRITE_COUNT) || !atlas.save_cache(CACHE_PATH) ||
+        !atlas.save_pack(writer, ATLAS_PACK_NAME) || !writer.save(PACK_PATH))
+    {
+        printf("could not build the atlas; run from the directory holding assets/\n");
+        return 1;
+    }
+
+    bool same = same_pixels();
+    bool can_evict = evict(PACK_PATH);
+    printf("%dx%d atlas, best of %d loads\n\n", atlas.get_width(), atlas.get_height(), RUNS);
+    printf("%-8s %-6s %10s %14s %14s\n", "source", "cache", "ms", "minor faults", "major faults");
+
+    for (int cold = 0; cold < (can_evict ? 2 : 1); cold++)
+    {
+        for (int mode = 0; mode < MODE_COUNT; mode++)
+        {
+            Result best = { 1e9, 0, 0 };
+            for (int run = 0; run < RUNS; run++)
+            {
+                unsigned checksum = 0;
+                Result result = load((Mode)mode, cold != 0, checksum);
+                if (result.ms >= 0.0 && result.ms < best.ms) best = result;
+            }
+            printf("%-8s %-6s %10.3f %14ld %14ld\n", MODE_NAMES[mode], cold ? "cold" : "warm",
+                best.ms, best.minor_faults, best.major_faults);
+        }
+    }
+    if (!can_evict) printf("(cold runs need posix_fadvise; skipped)\n");
+
+    printf("\npack matches the cache (rects and pixels): %s\n", same ? "yes" : "NO");
+
+    remove(CACHE_PATH);
+    remove(PACK_PATH);
+    return same ? 0 : 1;
+}
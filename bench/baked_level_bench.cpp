@@ -0,0 +1,120 @@
+/**
+* Baked static level vs. drawing every block as a sprite.
+*
+* For levels of 21, 1000 and 100000 blocks, compares the per-frame CPU
+* cost of the terrain through SpriteBatch (a quad written per block per
+* frame, then uploaded) with the baked level, which writes and uploads
+* nothing and issues one draw call. Also times building the level (blocks,
+* terrain and bake) against loading the saved bake, and checks that the
+* loaded terrain and vertex count match what was baked.
+*
+* Only the CPU side is measured, so no GL context is created.
+*
+* Build with -O2 together with ../BakedLevel.cpp, ../SpatialGrid.cpp,
+* ../EntityPool.cpp, ../Arena.cpp, ../Terrain.cpp, ../SpriteBatch.cpp,
+* ../GlState.cpp and ../ShaderProgram.cpp, linking against SDL2 and OpenGL.
+**/
+#include <chrono>
+#include <cstdio>
+#include "../BakedLevel.h"
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A row of blocks one block-width apart, as the classic level lays them out,
+// with every tenth block a pad
+static void build_level(EntityPool& pool, Terrain& terrain, int block_count)
+{
+    const float size = 0.5f;
+    terrain.reset(-size / 4.0f, size / 2.0f, 2 * block_count - 1);
+
+    for (int i = 0; i < block_count; i++)
+    {
+        bool pad = i % 10 == 3;
+        EntityBody body = { glm::vec3(i * size, -3.5f, 0.0f), glm::vec3(0.0f), size / 4.0f, size / 4.0f };
+        EntitySprite sprite = { 1, pad ? UvRect{ 0.5f, 0.0f, 1.0f, 0.5f } : UvRect{ 0.0f, 0.0f, 0.5f, 0.5f },
+            size, size, PLATFORM };
+        pool.create(body, sprite);
+
+        terrain.set_column(2 * i, -3.5f - size / 4.0f, -3.5f + size / 4.0f);
+        if (pad) terrain.add_pad(2 * i, 2 * i);
+    }
+}
+
+static bool same_terrain(const Terrain& a, const Terrain& b)
+{
+    if (a.get_column_count() != b.get_column_count() || a.get_pads().size() != b.get_pads().size()) return false;
+    for (int i = 0; i < a.get_column_count(); i++)
+    {
+        if (a.get_kind(i) != b.get_kind(i)) return false;
+        if (a.get_kind(i) != SURFACE_NONE && (a.get_top(i) != b.get_top(i) || a.get_bottom(i) != b.get_bottom(i))) return false;
+    }
+    return true;
+}
+
+int main()
+{
+    const int block_counts[] = { 21, 1000, 100000 };
+    const char* path = "baked_level_bench.bake";
+    bool ok = true;
+
+    printf("%8s %16s %14s %10s %12s %12s %10s\n", "blocks", "sprites ms/frame", "bytes/frame", "baked", "build ms",
+        "load ms", "file KB");
+
+    for (int block_count : block_counts)
+    {
+        Arena arena;
+        arena.initialise(EntityPool::get_arena_bytes(block_count));
+        const UvRect rects[2] = { { 0.0f, 0.0f, 0.5f, 0.5f }, { 0.5f, 0.0f, 1.0f, 0.5f } };
+        uint64_t key = BakedLevel::make_key(block_count, 1, rects, 2);
+
+        // ----- BUILD ----- //
+        auto start = std::chrono::steady_clock::now();
+        EntityPool pool;
+        pool.initialise(arena, block_count);
+        Terrain terrain;
+        build_level(pool, terrain, block_count);
+        BakedLevel baked;
+        ok &= baked.bake(pool, terrain);
+        double build_ms = elapsed_ms(start);
+
+        ok &= baked.save(path, key);
+        FILE* file = fopen(path, "rb");
+        fseek(file, 0, SEEK_END);
+        long file_bytes = ftell(file);
+        fclose(file);
+
+        // ----- LOAD ----- //
+        start = std::chrono::steady_clock::now();
+        BakedLevel loaded;
+        bool load_ok = loaded.load(path, key);
+        double load_ms = elapsed_ms(start);
+
+        ok &= load_ok && loaded.get_vertex_count() == baked.get_vertex_count() &&
+            same_terrain(loaded.get_terrain(), terrain) && !loaded.load(path, key + 1);
+
+        // ----- PER FRAME ----- //
+        // What the sprite path does on the CPU each frame before its upload
+        SpriteBatch batch;
+        int frames = block_count >= 100000 ? 20 : 2000;
+        start = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; f++)
+        {
+            batch.begin(NULL);
+            pool.render(&batch);
+        }
+        double sprite_ms = elapsed_ms(start) / frames;
+        int bytes = block_count * SpriteBatch::VERTICES_PER_SPRITE * SpriteBatch::FLOATS_PER_VERTEX * (int)sizeof(float);
+
+        printf("%8d %16.4f %14d %10s %12.3f %12.3f %10.1f\n", block_count, sprite_ms, bytes, "1 draw", build_ms,
+            load_ms, file_bytes / 1024.0);
+
+        arena.shutdown();
+    }
+    remove(path);
+
+    printf("\nbake round trip %s\n", ok ? "matches" : "DIFFERS");
+    return ok ? 0 : 1;
+}
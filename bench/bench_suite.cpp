@@ -0,0 +1,349 @@
+/**
+* Benchmark suite for the core hot paths.
+*
+*   entity_update/N       Entity::update for one lander against N collidables
+*   check_collision       Entity::check_collision, one pair per op
+*   text_vertices/N       draw_text's vertex generation for an N-character string
+*   png_decode/<asset>    stbi_load of each sprite, as the atlas build does
+*                         before packing
+*   update_minute         a simulated minute of the game loop: per-frame input
+*                         and advance_world over jittered 60 Hz frame times
+*
+* Every benchmark reports ns/op and heap allocations/op (global operator new
+* is counted). Results go to stdout and, with --out, to a JSON file; with
+* --baseline they are compared against an earlier --out file and the run
+* fails with a non-zero exit if any benchmark got slower than the tolerance
+* allows or allocates more than it used to.
+*
+*   bench_suite [--out results.json] [--baseline baseline.json]
+*               [--tolerance 0.25] [--filter substring]
+*
+* Run from the repository root (the PNG benchmarks read assets/). Build with
+* -O2 together with ../Entity.cpp, ../Simulation.cpp, ../Terrain.cpp,
+* ../HudText.cpp, ../SpriteBatch.cpp, ../GlState.cpp and
+* ../ShaderProgram.cpp, linking against SDL2 and OpenGL.
+**/
+#define STB_IMAGE_IMPLEMENTATION
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+#include "../Entity.h"
+#include "../HudText.h"
+#include "../Simulation.h"
+
+static long long g_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    g_allocations++;
+    void* pointer = malloc(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept { free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { free(pointer); }
+
+struct BenchResult
+{
+    std::string name;
+    double ns_per_op;
+    double allocs_per_op;
+};
+
+static std::vector<BenchResult> g_results;
+static const char* g_filter = NULL;
+static volatile float g_sink = 0.0f;
+
+// Runs body(ops) in growing batches until a batch takes at least 50 ms, then
+// keeps the best of five such batches
+template <typename Body>
+static void run(const std::string& name, Body body)
+{
+    if (g_filter && name.find(g_filter) == std::string::npos) return;
+
+    body(1);
+
+    long long ops = 1;
+    double best_ns = 0.0, allocs_per_op = 0.0;
+    for (int round = 0; round < 5; )
+    {
+        long long allocations = g_allocations;
+        auto start = std::chrono::steady_clock::now();
+        body(ops);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        allocations = g_allocations - allocations;
+
+        if (ns < 50e6)
+        {
+            ops *= ns < 5e6 ? 10 : 2;
+            continue;
+        }
+
+        if (round == 0 || ns / ops < best_ns) best_ns = ns / ops;
+        allocs_per_op = (double)allocations / ops;
+        round++;
+    }
+
+    g_results.push_back({ name, best_ns, allocs_per_op });
+    printf("%-28s %14.1f ns/op %10.2f allocs/op\n", name.c_str(), best_ns, allocs_per_op);
+}
+
+// ----- BENCHMARKS ----- //
+static void bench_entity_update(int collidable_count)
+{
+    // Collidables sit well below the lander so every update scans all of them
+    std::vector<Entity> collidables(collidable_count);
+    for (int i = 0; i < collidable_count; i++)
+    {
+        collidables[i].set_position(glm::vec3((i % 41) * 0.25f - 5.0f, -50.0f - (i / 41) * 0.5f, 0.0f));
+        collidables[i].set_width(0.25f);
+        collidables[i].set_height(0.25f);
+    }
+
+    Entity lander(0, 5.0f, glm::vec3(0.0f, -9.8f, 0.0f), 0.75f, 0.75f, PLAYER);
+
+    run("entity_update/" + std::to_string(collidable_count), [&](long long ops) {
+        for (long long op = 0; op < ops; op++)
+        {
+            if ((op & 1023) == 0)
+            {
+                lander.set_position(glm::vec3(0.0f, 3.0f, 0.0f));
+                lander.set_velocity(glm::vec3(0.0f));
+            }
+            lander.update(FIXED_TIMESTEP, NULL, collidables.data(), collidable_count);
+        }
+        g_sink = g_sink + lander.get_position().y;
+    });
+}
+
+static void bench_check_collision()
+{
+    const int entity_count = 1024;
+    std::vector<Entity> entities(entity_count);
+    uint32_t seed = 7;
+    for (Entity& entity : entities)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        entity.set_position(glm::vec3((seed >> 8) % 1000 * 0.01f - 5.0f, (seed >> 18) % 750 * 0.01f - 3.75f, 0.0f));
+        entity.set_width(0.5f);
+        entity.set_height(0.5f);
+    }
+
+    run("check_collision", [&](long long ops) {
+        int hits = 0;
+        for (long long op = 0; op < ops; op++)
+        {
+            int i = (int)(op & (entity_count - 1));
+            hits += entities[i].check_collision(&entities[(i + 1 + (op >> 10)) & (entity_count - 1)]);
+        }
+        g_sink = g_sink + (float)hits;
+    });
+}
+
+static void bench_text_vertices(int length)
+{
+    std::string text;
+    for (int i = 0; i < length; i++) text += (char)('A' + i % 26);
+
+    // Fresh vectors per call, exactly as draw_text does
+    run("text_vertices/" + std::to_string(length), [&](long long ops) {
+        for (long long op = 0; op < ops; op++)
+        {
+            std::vector<float> vertices;
+            std::vector<float> texture_coordinates;
+            build_text_vertices(vertices, texture_coordinates, text, 0.2f, 0.001f, FULL_TEXTURE);
+            g_sink = g_sink + vertices.back();
+        }
+    });
+}
+
+static void bench_png_decode(const char* name, const char* path)
+{
+    int width, height, components;
+    unsigned char* probe = stbi_load(path, &width, &height, &components, STBI_rgb_alpha);
+    if (!probe)
+    {
+        printf("%-28s skipped, cannot read %s\n", name, path);
+        return;
+    }
+    stbi_image_free(probe);
+
+    run(std::string("png_decode/") + name, [&](long long ops) {
+        for (long long op = 0; op < ops; op++)
+        {
+            unsigned char* image = stbi_load(path, &width, &height, &components, STBI_rgb_alpha);
+            g_sink = g_sink + image[0];
+            stbi_image_free(image);
+        }
+    });
+}
+
+static void bench_update_minute()
+{
+    const int frame_count = 60 * 60;
+
+    Terrain terrain;
+    build_classic_terrain(terrain, 7);
+
+    // Frame times of a 60 Hz display with some jitter, and a pilot that
+    // keeps the lander airborne for the whole minute
+    std::vector<float> frame_times(frame_count);
+    uint32_t seed = 11;
+    for (float& frame_time : frame_times)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        frame_time = 1.0f / 60.0f + ((int)((seed >> 16) % 2001) - 1000) * 0.000002f;
+    }
+
+    run("update_minute", [&](long long ops) {
+        for (long long op = 0; op < ops; op++)
+        {
+            World world;
+            reset_world(world, &terrain);
+            for (int frame = 0; frame < frame_count; frame++)
+            {
+                TickInput input;
+                input.left = (frame / 90) % 2 == 0;
+                input.right = !input.left;
+                input.up = world.lander.velocity.y < 0.0f && world.lander.position.y < 2.0f;
+                apply_input(world, input);
+                advance_world(world, frame_times[frame]);
+            }
+            g_sink = g_sink + world.lander.position.y;
+        }
+    });
+}
+
+// ----- RESULTS ----- //
+static bool write_json(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < g_results.size(); i++)
+    {
+        const BenchResult& result = g_results[i];
+        fprintf(file, "    { \"name\": \"%s\", \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f }%s\n",
+            result.name.c_str(), result.ns_per_op, result.allocs_per_op, i + 1 < g_results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    fclose(file);
+    return true;
+}
+
+// Reads back what write_json wrote: one benchmark object per line
+static bool read_json(const char* path, std::vector<BenchResult>& results)
+{
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    char line[512];
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[256];
+        double ns_per_op, allocs_per_op;
+        if (sscanf(line, " { \"name\": \"%255[^\"]\", \"ns_per_op\": %lf, \"allocs_per_op\": %lf", name, &ns_per_op, &allocs_per_op) == 3)
+        {
+            results.push_back({ name, ns_per_op, allocs_per_op });
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+static int compare_with_baseline(const char* path, double tolerance)
+{
+    std::vector<BenchResult> baseline;
+    if (!read_json(path, baseline))
+    {
+        printf("cannot read baseline %s\n", path);
+        return 1;
+    }
+
+    int regressions = 0;
+    printf("\nagainst %s (tolerance %.0f%%):\n", path, tolerance * 100.0);
+
+    for (const BenchResult& result : g_results)
+    {
+        const BenchResult* previous = NULL;
+        for (const BenchResult& candidate : baseline)
+        {
+            if (candidate.name == result.name) previous = &candidate;
+        }
+        if (!previous)
+        {
+            printf("  %-28s new\n", result.name.c_str());
+            continue;
+        }
+
+        double change = previous->ns_per_op > 0.0 ? result.ns_per_op / previous->ns_per_op - 1.0 : 0.0;
+        bool slower = change > tolerance;
+        bool allocates_more = result.allocs_per_op > previous->allocs_per_op + 0.005;
+
+        printf("  %-28s %+7.1f%% time, %.2f -> %.2f allocs/op%s\n", result.name.c_str(), change * 100.0,
+            previous->allocs_per_op, result.allocs_per_op,
+            slower || allocates_more ? "   <-- REGRESSION" : "");
+        if (slower || allocates_more) regressions++;
+    }
+
+    if (regressions)
+    {
+        printf("\nFAIL: %d benchmark(s) regressed against %s\n", regressions, path);
+        return 1;
+    }
+    printf("\nno regressions\n");
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* out_path = NULL;
+    const char* baseline_path = NULL;
+    double tolerance = 0.25;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--out") == 0) out_path = argv[i + 1];
+        else if (strcmp(argv[i], "--baseline") == 0) baseline_path = argv[i + 1];
+        else if (strcmp(argv[i], "--tolerance") == 0) tolerance = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--filter") == 0) g_filter = argv[i + 1];
+        else
+        {
+            printf("unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    const int collidable_counts[] = { 1, PLATFORM_COUNT, 100, 1000 };
+    for (int count : collidable_counts) bench_entity_update(count);
+
+    bench_check_collision();
+
+    const int text_lengths[] = { 4, 15, 64 };
+    for (int length : text_lengths) bench_text_vertices(length);
+
+    bench_png_decode("lander", "assets/lunarLander.png");
+    bench_png_decode("block", "assets/block.png");
+    bench_png_decode("platform", "assets/platform.png");
+    bench_png_decode("font", "assets/font1.png");
+    bench_png_decode("flame", "assets/flame.png");
+
+    bench_update_minute();
+
+    if (out_path && !write_json(out_path))
+    {
+        printf("cannot write %s\n", out_path);
+        return 1;
+    }
+
+    return baseline_path ? compare_with_baseline(baseline_path, tolerance) : 0;
+}
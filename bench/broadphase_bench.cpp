@@ -0,0 +1,177 @@
+/**
+* Sweep-and-prune broadphase vs. testing every pair.
+*
+* Scatters landers over an area that grows with their count (so density
+* stays constant), lets them drift for a number of ticks and times the
+* broadphase update against the all-pairs O(N^2) loop. Where the all-pairs
+* loop is run, the touching pair counts must agree.
+*
+* First checks the cases where endpoints share a value: zero-width boxes,
+* boxes that only touch and boxes stacked on one another, each added in
+* both orders and updated again after a move.
+*
+* Build with -O2 together with ../Broadphase.cpp, ../Simulation.cpp and
+* ../Terrain.cpp.
+**/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../Broadphase.h"
+#include "../Simulation.h"
+
+static uint32_t g_seed = 2024;
+
+static float random_range(float low, float high)
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return low + (high - low) * (float)(g_seed >> 8) / (float)(1u << 24);
+}
+
+struct EdgeCase
+{
+    const char* name;
+    std::vector<float> x;       // centres on one row, all one unit high
+    std::vector<float> width;
+};
+
+static int count_touching(const Broadphase& broadphase, const std::vector<glm::vec3>& position,
+    const std::vector<float>& width)
+{
+    int touching = 0;
+    for (const BodyPair& pair : broadphase.get_pairs())
+    {
+        if (aabb_overlap(position[pair.a], width[pair.a], 1.0f, position[pair.b], width[pair.b], 1.0f)) touching++;
+    }
+    return touching;
+}
+
+static bool check_edge_case(const EdgeCase& edge_case)
+{
+    int body_count = (int)edge_case.x.size();
+    std::vector<glm::vec3> position(body_count);
+    for (int i = 0; i < body_count; i++) position[i] = glm::vec3(edge_case.x[i], 0.0f, 0.0f);
+
+    int expected = 0;
+    for (int a = 0; a < body_count; a++)
+        for (int b = a + 1; b < body_count; b++)
+            if (aabb_overlap(position[a], edge_case.width[a], 1.0f, position[b], edge_case.width[b], 1.0f)) expected++;
+
+    bool agreed = true;
+    for (int reversed = 0; reversed < 2; reversed++)
+    {
+        // Bodies are indexed in case order either way, only added in reverse
+        Broadphase broadphase;
+        for (int i = 0; i < body_count; i++) broadphase.add_body(glm::vec3(0.0f), 0.0f, 1.0f);
+        for (int n = 0; n < body_count; n++)
+        {
+            int i = reversed ? body_count - 1 - n : n;
+            broadphase.move_body(i, position[i], edge_case.width[i], 1.0f);
+        }
+        broadphase.update();
+        if (count_touching(broadphase, position, edge_case.width) != expected) agreed = false;
+
+        // The same layout a quarter unit to the right, sorted from the last
+        std::vector<glm::vec3> moved = position;
+        for (int i = 0; i < body_count; i++)
+        {
+            moved[i].x += 0.25f;
+            broadphase.move_body(i, moved[i], edge_case.width[i], 1.0f);
+        }
+        broadphase.update();
+        if (count_touching(broadphase, moved, edge_case.width) != expected) agreed = false;
+    }
+
+    printf("  %-28s %2d touching %s\n", edge_case.name, expected, agreed ? "ok" : "DISAGREES with the all-pairs loop");
+    return agreed;
+}
+
+int main()
+{
+    const int body_counts[] = { 100, 1000, 4000, 20000, 100000 };
+    const int tick_count = 60;
+    const float size = 0.75f;
+
+    // Every centre and edge below is exact in float, so touching is exact
+    const EdgeCase edge_cases[] = {
+        { "zero-width beside a box",     { 0.0f, 2.0f },             { 0.0f, 1.0f } },
+        { "zero-width inside a box",     { 0.0f, 0.0f },             { 0.0f, 2.0f } },
+        { "zero-width on box edges",     { 1.0f, 0.5f, 1.5f },       { 0.0f, 1.0f, 1.0f } },
+        { "zero-width at one x",         { 1.0f, 1.0f, 1.0f },       { 0.0f, 0.0f, 0.0f } },
+        { "boxes touching in a row",     { 0.0f, 1.0f, 2.0f, 3.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+        { "boxes stacked on one another", { 0.0f, 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+    };
+    int failures = 0;
+    printf("shared endpoints:\n");
+    for (const EdgeCase& edge_case : edge_cases)
+    {
+        if (!check_edge_case(edge_case)) failures++;
+    }
+    printf("\n");
+
+    printf("%8s %12s %12s %14s %14s\n", "bodies", "pairs/tick", "swaps/tick", "sap ms/tick", "n^2 ms/tick");
+
+    for (int body_count : body_counts)
+    {
+        float extent = sqrtf((float)body_count) * 4.0f;
+
+        std::vector<glm::vec3> position(body_count), velocity(body_count);
+        Broadphase broadphase;
+        for (int i = 0; i < body_count; i++)
+        {
+            position[i] = glm::vec3(random_range(0.0f, extent), random_range(0.0f, extent), 0.0f);
+            velocity[i] = glm::vec3(random_range(-0.05f, 0.05f), random_range(-0.05f, 0.05f), 0.0f);
+            broadphase.add_body(position[i], size, size);
+        }
+        broadphase.update();
+
+        bool run_all_pairs = body_count <= 4000;
+        double sap_ms = 0.0, all_pairs_ms = 0.0;
+        long long pairs = 0, swaps = 0, mismatches = 0;
+
+        for (int t = 0; t < tick_count; t++)
+        {
+            for (int i = 0; i < body_count; i++)
+            {
+                position[i] += velocity[i];
+                broadphase.move_body(i, position[i], size, size);
+            }
+
+            broadphase.update();
+            sap_ms += broadphase.get_stats().update_ms;
+            swaps += broadphase.get_stats().swap_count;
+
+            int touching = 0;
+            const std::vector<BodyPair>& candidates = broadphase.get_pairs();
+            for (size_t p = 0; p < candidates.size(); p++)
+            {
+                if (aabb_overlap(position[candidates[p].a], size, size, position[candidates[p].b], size, size)) touching++;
+            }
+            pairs += touching;
+
+            if (run_all_pairs)
+            {
+                auto start = std::chrono::steady_clock::now();
+                int brute_touching = 0;
+                for (int a = 0; a < body_count; a++)
+                    for (int b = a + 1; b < body_count; b++)
+                        if (aabb_overlap(position[a], size, size, position[b], size, size)) brute_touching++;
+                all_pairs_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                if (brute_touching != touching) mismatches++;
+            }
+        }
+
+        if (run_all_pairs) {
+            printf("%8d %12.1f %12.1f %14.3f %14.3f\n", body_count, (double)pairs / tick_count,
+                (double)swaps / tick_count, sap_ms / tick_count, all_pairs_ms / tick_count);
+        }
+        else {
+            printf("%8d %12.1f %12.1f %14.3f %14s\n", body_count, (double)pairs / tick_count,
+                (double)swaps / tick_count, sap_ms / tick_count, "-");
+        }
+        if (mismatches) printf("  %lld ticks disagreed with the all-pairs loop\n", mismatches);
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+/**
+* View culling: drawing the blocks a camera sees vs. the whole level.
+*
+* Bakes levels 1, 10, 100, 1000 and 10000 screens wide, then sweeps a
+* Camera from one end to the other over 200 frames drawn into an 800x600
+* framebuffer on an offscreen EGL context. Each frame draws the level once
+* through the grid query for the camera's view and once with a range
+* covering the whole world, waiting for the GPU each time so its share of
+* the work is counted. Reports the time per frame of each, the average
+* number of blocks each drew, and the cost of the grid query on its own.
+*
+* The culled columns should stay flat as the level grows; the whole-level
+* ones grow with it.
+*
+* Build with -O2 together with ../BakedLevel.cpp, ../SpatialGrid.cpp,
+* ../Camera.cpp, ../EntityPool.cpp, ../Arena.cpp, ../Terrain.cpp,
+* ../SpriteBatch.cpp, ../GlState.cpp, ../Simulation.cpp,
+* ../OffscreenContext.cpp and ../ShaderProgram.cpp, linking against SDL2,
+* OpenGL and EGL.
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "glm/gtc/matrix_transform.hpp"
+#include "../BakedLevel.h"
+#include "../Camera.h"
+#include "../GameAssets.h"
+#include "../OffscreenContext.h"
+#include "../Simulation.h"
+
+static const int FRAMES = 200,
+    WIDTH = 800,
+    HEIGHT = 600;
+static const float VIEW_HALF_WIDTH = 5.0f;
+
+static volatile long long g_sink = 0;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool bake_level(BakedLevel& level, Arena& arena, int screen_count)
+{
+    int block_count = PLATFORM_COUNT * screen_count;
+    arena.initialise(EntityPool::get_arena_bytes(block_count));
+    EntityPool pool;
+    pool.initialise(arena, block_count);
+
+    std::vector<Block> blocks(block_count);
+    build_wide_blocks(blocks.data(), screen_count, 1);
+    for (int i = 0; i < block_count; i++)
+    {
+        EntityBody body = { blocks[i].position, glm::vec3(0.0f), blocks[i].width / 2.0f, blocks[i].height / 2.0f };
+        EntitySprite sprite = { 0, FULL_TEXTURE, 0.5f, 0.5f, PLATFORM };
+        pool.create(body, sprite);
+    }
+
+    Terrain terrain;
+    build_wide_terrain(terrain, screen_count, 1);
+    if (!level.bake(pool, terrain)) return false;
+    level.upload(0);
+    return true;
+}
+
+int main()
+{
+    const int screen_counts[] = { 1, 10, 100, 1000, 10000 };
+
+    OffscreenContext context;
+    if (!context.initialise())
+    {
+        printf("could not create an offscreen OpenGL context\n");
+        return 1;
+    }
+
+    ShaderProgram program;
+    program.load(V_SHADER_PATH, F_SHADER_PATH);
+    program.set_projection_matrix(glm::ortho(-VIEW_HALF_WIDTH, VIEW_HALF_WIDTH, -3.75f, 3.75f, -1.0f, 1.0f));
+    glUseProgram(program.get_program_id());
+
+    GLuint framebuffer, colour_buffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &colour_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colour_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colour_buffer);
+    glViewport(0, 0, WIDTH, HEIGHT);
+
+    printf("%s, %d frames at %dx%d\n\n", context.get_renderer(), FRAMES, WIDTH, HEIGHT);
+    printf("%8s %10s | %12s %10s | %12s %10s | %10s\n", "screens", "blocks", "culled ms", "drawn", "whole ms",
+        "drawn", "query ns");
+
+    for (int screen_count : screen_counts)
+    {
+        Arena arena;
+        BakedLevel level;
+        if (!bake_level(level, arena, screen_count))
+        {
+            printf("could not bake a level %d screens wide\n", screen_count);
+            return 1;
+        }
+
+        float world_limit = get_wrap_limit_x(screen_count) - WRAP_OFFSET_X;
+        Camera camera;
+        camera.initialise(VIEW_HALF_WIDTH, 1.5f);
+        camera.set_bounds(-world_limit, world_limit);
+
+        double culled_ms = 0.0, whole_ms = 0.0;
+        long long culled_blocks = 0, whole_blocks = 0;
+        for (int frame = 0; frame < FRAMES; frame++)
+        {
+            camera.move_to(-world_limit + 2.0f * world_limit * frame / (FRAMES - 1));
+            program.set_view_matrix(camera.get_view_matrix());
+
+            auto start = std::chrono::steady_clock::now();
+            glClear(GL_COLOR_BUFFER_BIT);
+            culled_blocks += level.draw(&program, camera.get_min_x(), camera.get_max_x());
+            glFinish();
+            culled_ms += elapsed_ms(start);
+
+            start = std::chrono::steady_clock::now();
+            glClear(GL_COLOR_BUFFER_BIT);
+            whole_blocks += level.draw(&program, -world_limit - 1.0f, world_limit + 1.0f);
+            glFinish();
+            whole_ms += elapsed_ms(start);
+        }
+
+        // The query alone is too quick to time one at a time
+        SpatialGrid grid;
+        std::vector<float> min_x(level.get_block_count()), max_x(level.get_block_count());
+        std::vector<Block> blocks(level.get_block_count());
+        build_wide_blocks(blocks.data(), screen_count, 1);
+        for (int i = 0; i < level.get_block_count(); i++)
+        {
+            min_x[i] = blocks[i].position.x - blocks[i].width * 0.5f;
+            max_x[i] = blocks[i].position.x + blocks[i].width * 0.5f;
+        }
+        grid.build(min_x.data(), max_x.data(), level.get_block_count(), BakedLevel::CELL_WIDTH);
+
+        const int queries = 1000000;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; i++)
+        {
+            float x = -world_limit + 2.0f * world_limit * (i % 4096) / 4095.0f;
+            g_sink = g_sink + grid.query(x - VIEW_HALF_WIDTH, x + VIEW_HALF_WIDTH).count;
+        }
+        double query_ns = elapsed_ms(start) * 1e6 / queries;
+
+        printf("%8d %10d | %12.3f %10lld | %12.3f %10lld | %10.1f\n", screen_count, level.get_block_count(),
+            culled_ms / FRAMES, culled_blocks / FRAMES, whole_ms / FRAMES, whole_blocks / FRAMES, query_ns);
+
+        level.shutdown();
+        arena.shutdown();
+    }
+
+    glDeleteRenderbuffers(1, &colour_buffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    context.shutdown();
+    return 0;
+}
@@ -0,0 +1,176 @@
+/**
+* Pooled hot/cold entity storage vs. an array of Entity.
+*
+* With 100k entities, times:
+*
+*   integrate   one semi-implicit Euler step over every entity, reading and
+*               writing position and velocity: EntityPool's packed bodies
+*               against the same step through Entity's getters and setters
+*   lookup      resolving random handles to bodies
+*   churn       destroying every other entity and creating as many again
+*   reset       dropping the whole level: new/delete[] of the Entity array
+*               against an arena rewind plus EntityPool::initialise
+*
+* and checks that handles to destroyed entities, and every handle from
+* before a reset, stop resolving.
+*
+* Build with -O2 together with ../Arena.cpp, ../EntityPool.cpp,
+* ../Entity.cpp, ../Simulation.cpp, ../Terrain.cpp, ../SpriteBatch.cpp,
+* ../GlState.cpp and ../ShaderProgram.cpp, linking against SDL2 and OpenGL.
+**/
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "../EntityPool.h"
+
+static uint32_t g_seed = 99;
+
+static uint32_t next_random()
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static EntityBody make_body(int i)
+{
+    EntityBody body = { glm::vec3((float)(i % 1000), (float)(i / 1000), 0.0f), glm::vec3(0.1f, 0.0f, 0.0f), 0.125f, 0.125f };
+    return body;
+}
+
+int main()
+{
+    const int entity_count = 100000;
+    const int repetitions = 50;
+    const float delta_time = 1.0f / 60.0f;
+    const glm::vec3 gravity(0.0f, -9.8f, 0.0f);
+    const EntitySprite sprite = { 1, FULL_TEXTURE, 0.5f, 0.5f, PLATFORM };
+    bool ok = true;
+
+    printf("%d entities: sizeof(Entity) %zu bytes, sizeof(EntityBody) %zu, sizeof(EntitySprite) %zu\n\n",
+        entity_count, sizeof(Entity), sizeof(EntityBody), sizeof(EntitySprite));
+
+    Arena arena;
+    arena.initialise(EntityPool::get_arena_bytes(entity_count));
+    EntityPool pool;
+    pool.initialise(arena, entity_count);
+
+    std::vector<EntityHandle> handles(entity_count);
+    for (int i = 0; i < entity_count; i++) handles[i] = pool.create(make_body(i), sprite);
+
+    Entity* entities = new Entity[entity_count];
+    for (int i = 0; i < entity_count; i++)
+    {
+        entities[i].set_position(make_body(i).position);
+        entities[i].set_velocity(make_body(i).velocity);
+    }
+
+    // ----- INTEGRATE ----- //
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++)
+    {
+        EntityBody* bodies = pool.get_bodies();
+        for (int i = 0, count = pool.get_count(); i < count; i++)
+        {
+            bodies[i].velocity += gravity * delta_time;
+            bodies[i].position += bodies[i].velocity * delta_time;
+        }
+    }
+    double pool_ms = elapsed_ms(start) / repetitions;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++)
+    {
+        for (int i = 0; i < entity_count; i++)
+        {
+            Entity& entity = entities[i];
+            entity.set_velocity(entity.get_velocity() + gravity * delta_time);
+            entity.set_position(entity.get_position() + entity.get_velocity() * delta_time);
+        }
+    }
+    double entity_ms = elapsed_ms(start) / repetitions;
+
+    float sink = 0.0f;
+    for (int i = 0; i < entity_count; i += 1000) sink += pool.get_bodies()[i].position.y + entities[i].get_position().y;
+
+    printf("%-10s %10s %12s\n", "", "pool ms", "Entity[] ms");
+    printf("%-10s %10.3f %12.3f   (%.1fx)\n", "integrate", pool_ms, entity_ms, entity_ms / pool_ms);
+
+    // ----- LOOKUP ----- //
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++)
+    {
+        for (int i = 0; i < entity_count; i++)
+        {
+            EntityBody* body = pool.get_body(handles[next_random() % entity_count]);
+            sink += body->half_width;
+        }
+    }
+    printf("%-10s %10.3f %12s   (%.1f ns per handle)\n", "lookup", elapsed_ms(start) / repetitions, "-",
+        elapsed_ms(start) * 1e6 / repetitions / entity_count);
+
+    // ----- CHURN ----- //
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < entity_count; i += 2) ok &= pool.destroy(handles[i]);
+    double destroy_ms = elapsed_ms(start);
+
+    for (int i = 0; i < entity_count; i += 2)
+    {
+        if (pool.is_alive(handles[i]) || pool.destroy(handles[i])) ok = false;
+    }
+    for (int i = 1; i < entity_count; i += 2)
+    {
+        EntityBody* body = pool.get_body(handles[i]);
+        if (!body || body->half_width != 0.125f) ok = false;
+    }
+
+    start = std::chrono::steady_clock::now();
+    std::vector<EntityHandle> stale(handles);
+    for (int i = 0; i < entity_count; i += 2) handles[i] = pool.create(make_body(i), sprite);
+    double create_ms = elapsed_ms(start);
+
+    // Recycled slots must not revive the handles that used to own them
+    for (int i = 0; i < entity_count; i += 2)
+    {
+        if (pool.is_alive(stale[i]) || !pool.is_alive(handles[i])) ok = false;
+    }
+    if (pool.get_count() != entity_count || pool.is_alive(NULL_ENTITY)) ok = false;
+
+    printf("%-10s %10.3f %12s   (destroy %d %.3f ms, create %d %.3f ms)\n", "churn", destroy_ms + create_ms, "-",
+        entity_count / 2, destroy_ms, entity_count / 2, create_ms);
+
+    // ----- RESET ----- //
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++)
+    {
+        arena.rewind();
+        pool.initialise(arena, entity_count);
+    }
+    double rewind_ms = elapsed_ms(start) / repetitions;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; r++)
+    {
+        delete[] entities;
+        entities = new Entity[entity_count];
+    }
+    double reallocate_ms = elapsed_ms(start) / repetitions;
+
+    printf("%-10s %10.5f %12.3f\n", "reset", rewind_ms, reallocate_ms);
+
+    for (int i = 0; i < entity_count; i++)
+    {
+        if (pool.is_alive(handles[i])) ok = false;
+    }
+    if (pool.get_count() != 0 || arena.get_high_water() > arena.get_capacity()) ok = false;
+
+    delete[] entities;
+    arena.shutdown();
+
+    printf("\nhandles %s (sink %.1f)\n", ok ? "behave" : "MISBEHAVE", sink);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/**
+* Frame readback: synchronous glReadPixels vs. the FrameCapture PBO ring.
+*
+* Draws 300 frames of 20000 particles into an 800x600 framebuffer on an
+* offscreen EGL context and saves every one to a raw stream in the
+* directory given (default /tmp). The baseline does it all on the GL
+* thread: glReadPixels straight into client memory (waiting for the frame
+* to finish drawing, then for the copy) and the write. Then FrameCapture
+* does it with rings of 1 to 4 pixel buffer objects and its writer thread.
+* For each it reports the GL thread's time per frame spent capturing, the
+* frame rate, and how often a map found its transfer unfinished.
+*
+* On Mesa's llvmpipe the copy into a pixel buffer is done by the CPU when
+* glReadPixels is called, and rendering runs on the CPU's other cores, so
+* the overlap a deeper ring buys there depends on how many cores there are.
+*
+* Build with -O2 together with ../FrameCapture.cpp, ../OffscreenContext.cpp,
+* ../ParticleSystem.cpp, ../Arena.cpp, ../GlState.cpp and
+* ../ShaderProgram.cpp, linking against SDL2, OpenGL and EGL.
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "glm/gtc/matrix_transform.hpp"
+#include "../FrameCapture.h"
+#include "../GameAssets.h"
+#include "../OffscreenContext.h"
+#include "../ParticleSystem.h"
+
+static const int FRAMES = 300,
+    WIDTH = 800,
+    HEIGHT = 600,
+    PARTICLES = 20000;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Scene
+{
+    ShaderProgram program;
+    Arena arena;
+    ParticleSystem particles;
+    ParticleSpawn spawn;
+};
+
+static void draw(Scene& scene)
+{
+    scene.particles.emit(scene.spawn, PARTICLES - scene.particles.get_count());
+    scene.particles.update(1.0f / 60.0f);
+
+    glClear(GL_COLOR_BUFFER_BIT);
+    scene.particles.draw(&scene.program);
+}
+
+// What capturing costs the GL thread per frame, outside of draw(): here the
+// readback, the wait for the frame it reads and the write
+static void run_sync(Scene& scene, GLuint framebuffer, const char* directory)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frames.rgba", directory);
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        printf("could not write to %s\n", path);
+        return;
+    }
+
+    size_t row_bytes = (size_t)WIDTH * 4;
+    std::vector<unsigned char> pixels(row_bytes * HEIGHT);
+    double readback_ms = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        draw(scene);
+
+        auto read_start = std::chrono::steady_clock::now();
+        glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        for (int y = HEIGHT - 1; y >= 0; y--) fwrite(pixels.data() + row_bytes * y, 1, row_bytes, file);
+        readback_ms += elapsed_ms(read_start);
+    }
+    fclose(file);
+    double total_ms = elapsed_ms(start);
+
+    printf("%-16s | %8.3f ms | %8.1f fps | %8s\n", "synchronous", readback_ms / FRAMES, FRAMES * 1000.0 / total_ms, "-");
+}
+
+static void run_ring(Scene& scene, int ring_size, const char* directory)
+{
+    FrameCapture capture;
+    if (!capture.initialise(WIDTH, HEIGHT, directory, CAPTURE_RAW, ring_size))
+    {
+        printf("could not set up a capture into %s\n", directory);
+        return;
+    }
+
+    double end_frame_ms = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        capture.begin_frame();
+        draw(scene);
+
+        auto read_start = std::chrono::steady_clock::now();
+        capture.end_frame();
+        end_frame_ms += elapsed_ms(read_start);
+    }
+    capture.finish();
+    double total_ms = elapsed_ms(start);
+    capture.shutdown();
+
+    FrameCaptureStats stats = capture.get_stats();
+    char name[32];
+    snprintf(name, sizeof(name), "ring of %d", ring_size);
+    printf("%-16s | %8.3f ms | %8.1f fps | %5d/%d%s\n", name, end_frame_ms / FRAMES, FRAMES * 1000.0 / total_ms,
+        stats.readback_stalls, stats.captured, stats.writer_waits > 0 ? "  (waited on the writer)" : "");
+}
+
+int main(int argc, char* argv[])
+{
+    const char* directory = argc > 1 ? argv[1] : "/tmp";
+
+    OffscreenContext context;
+    if (!context.initialise())
+    {
+        printf("could not create an offscreen OpenGL context\n");
+        return 1;
+    }
+
+    Scene scene;
+    scene.program.load(V_SHADER_PATH, F_SHADER_PATH);
+    scene.program.set_projection_matrix(glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f));
+    scene.program.set_view_matrix(glm::mat4(1.0f));
+    glClearColor(0.0f, 0.0f, 0.5f, 1.0f);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    scene.arena.initialise(ParticleSystem::get_arena_bytes(PARTICLES));
+    scene.particles.initialise(scene.arena, PARTICLES);
+    scene.particles.create_buffers();
+    scene.particles.set_texture(0);
+    scene.particles.add_sprite(FULL_TEXTURE);
+    scene.spawn = { glm::vec3(0.0f), 4.0f, glm::vec3(0.0f), glm::vec3(2.0f, 2.0f, 0.0f),
+        1.0f, 0.5f, 0.2f, -1.6f, 0 };
+
+    // The synchronous path reads from a framebuffer of its own
+    GLuint framebuffer, colour_buffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &colour_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colour_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colour_buffer);
+    glViewport(0, 0, WIDTH, HEIGHT);
+
+    printf("%s, %d frames of %d particles at %dx%d\n\n", context.get_renderer(), FRAMES, PARTICLES, WIDTH, HEIGHT);
+    printf("%-16s | %11s | %12s | %8s\n", "capture", "GL thread", "throughput", "stalls");
+
+    run_sync(scene, framebuffer, directory);
+    for (int ring_size = 1; ring_size <= 4; ring_size++) run_ring(scene, ring_size, directory);
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frames.rgba", directory);
+    remove(path);
+
+    glDeleteRenderbuffers(1, &colour_buffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    scene.particles.shutdown();
+    scene.arena.shutdown();
+    context.shutdown();
+    return 0;
+}
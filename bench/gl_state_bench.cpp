@@ -0,0 +1,173 @@
+/**
+* GL state cache: the calls GlState drops, and what that saves.
+*
+* Draws 200 frames of the game's unbatched path, 2000 sprites one at a time
+* through Entity::render (a run on one texture, then a run on another), and
+* a HUD of four text runs, into an 800x600 framebuffer on an offscreen EGL
+* context. Runs once with GlState's caching off, so every bind, program
+* switch, matrix upload and attribute enable reaches the driver, and once
+* with it on. Reports each kind of call issued and elided per frame, the
+* CPU time per frame spent issuing the calls, and the time per frame up to
+* and including glFinish.
+*
+* Mesa checks for redundant state itself, so on llvmpipe most of a dropped
+* call's cost is the trip into the driver; drivers that validate state at
+* draw time pay more for each change.
+*
+* Build with -O2 together with ../GlState.cpp, ../Entity.cpp,
+* ../SpriteBatch.cpp, ../HudText.cpp, ../Simulation.cpp, ../Terrain.cpp,
+* ../OffscreenContext.cpp and ../ShaderProgram.cpp, linking against SDL2,
+* OpenGL and EGL.
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "glm/gtc/matrix_transform.hpp"
+#include "../Entity.h"
+#include "../GameAssets.h"
+#include "../GlState.h"
+#include "../HudText.h"
+#include "../OffscreenContext.h"
+
+static const int FRAMES = 200,
+    WIDTH = 800,
+    HEIGHT = 600,
+    SPRITES = 2000;
+
+static const char* CALL_NAMES[CALL_KIND_COUNT] = { "use program", "bind texture", "bind buffer", "attrib array", "uniform" };
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static GLuint create_texture(unsigned char red, unsigned char green, unsigned char blue)
+{
+    unsigned char pixel[4] = { red, green, blue, 255 };
+
+    GLuint texture_id;
+    glGenTextures(1, &texture_id);
+    GlState::get().bind_texture(texture_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    return texture_id;
+}
+
+struct Scene
+{
+    ShaderProgram program;
+    std::vector<Entity> sprites;
+    HudText hud;
+};
+
+static void draw(Scene& scene)
+{
+    glClear(GL_COLOR_BUFFER_BIT);
+    GlState::get().set_view_matrix(&scene.program, glm::mat4(1.0f));
+    for (Entity& sprite : scene.sprites) sprite.render(&scene.program);
+    scene.hud.draw(&scene.program);
+}
+
+static void run(Scene& scene, bool caching)
+{
+    GlState& gl = GlState::get();
+    gl.set_caching(caching);
+    gl.begin_frame();
+
+    // Sums over every frame after the first, which sets up what the rest reuse
+    GlStateStats total = {};
+    double submit_ms = 0.0, total_ms = 0.0;
+    for (int frame = 0; frame <= FRAMES; frame++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        draw(scene);
+        double draw_ms = elapsed_ms(start);
+        glFinish();
+        double frame_ms = elapsed_ms(start);
+
+        gl.begin_frame();
+        if (frame == 0) continue;
+        submit_ms += draw_ms;
+        total_ms += frame_ms;
+
+        const GlStateStats& stats = gl.get_stats();
+        for (int kind = 0; kind < CALL_KIND_COUNT; kind++)
+        {
+            total.issued[kind] += stats.issued[kind];
+            total.elided[kind] += stats.elided[kind];
+        }
+        total.draw_calls += stats.draw_calls;
+    }
+
+    printf("caching %s: %.3f ms issuing, %.3f ms to glFinish per frame, %d draws\n", caching ? "on" : "off",
+        submit_ms / FRAMES, total_ms / FRAMES, total.draw_calls / FRAMES);
+    for (int kind = 0; kind < CALL_KIND_COUNT; kind++)
+    {
+        printf("  %-14s %8d issued %8d elided\n", CALL_NAMES[kind], total.issued[kind] / FRAMES,
+            total.elided[kind] / FRAMES);
+    }
+    printf("  %-14s %8d issued %8d elided\n\n", "total", total.get_issued() / FRAMES, total.get_elided() / FRAMES);
+}
+
+int main()
+{
+    OffscreenContext context;
+    if (!context.initialise())
+    {
+        printf("could not create an offscreen OpenGL context\n");
+        return 1;
+    }
+
+    Scene scene;
+    scene.program.load(V_SHADER_PATH, F_SHADER_PATH);
+    GlState& gl = GlState::get();
+    gl.use_program(&scene.program);
+    gl.set_projection_matrix(&scene.program, glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f));
+
+    GLuint framebuffer, colour_buffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(1, &colour_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colour_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colour_buffer);
+    glViewport(0, 0, WIDTH, HEIGHT);
+    glClearColor(0.0f, 0.0f, 0.5f, 1.0f);
+
+    GLuint block_texture = create_texture(128, 128, 128),
+        lander_texture = create_texture(255, 255, 255);
+
+    // Blocks in rows along the bottom, then landers scattered above
+    scene.sprites.reserve(SPRITES);
+    for (int i = 0; i < SPRITES; i++)
+    {
+        bool block = i < SPRITES / 2;
+        Entity sprite(block ? block_texture : lander_texture, 1.0f, glm::vec3(0.0f), 0.25f, 0.25f, PLATFORM);
+        float x = -4.875f + 0.25f * (i % 40),
+            y = block ? -3.625f + 0.25f * (i / 40) : -1.0f + 0.05f * (i % 97);
+        sprite.set_position(glm::vec3(x, y, 0.0f));
+        sprite.update(0.0f, NULL, NULL, 0);
+        scene.sprites.push_back(sprite);
+    }
+
+    scene.hud.set_font(lander_texture, FULL_TEXTURE);
+    int runs[4];
+    for (int i = 0; i < 4; i++) runs[i] = scene.hud.add_run(16, 0.2f, 0.01f, glm::vec3(-4.5f, 2.5f - 0.25f * i, 0.0f));
+    scene.hud.initialise();
+    for (int i = 0; i < 4; i++) scene.hud.set_text(runs[i], "Fuel: 100.000");
+
+    printf("%s, %d frames of %d sprites at %dx%d\n\n", context.get_renderer(), FRAMES, SPRITES, WIDTH, HEIGHT);
+    run(scene, false);
+    run(scene, true);
+
+    scene.hud.shutdown();
+    glDeleteRenderbuffers(1, &colour_buffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    context.shutdown();
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+* Heap allocations and CPU time of the HUD text per frame.
+*
+* Replays a descent's worth of changing fuel and velocity readouts through
+* the old path (std::to_string, substr and a fresh vertex vector per string,
+* as draw_text does) and through HudText. Global operator new is counted;
+* the HudText path must not allocate at all, and the program fails if it
+* does. Only the CPU side is measured, so no GL context is created.
+*
+* Also checks that format_hud_number prints exactly what
+* std::to_string(value).substr(0, 4) printed.
+*
+* Build with -O2 together with ../HudText.cpp, ../GlState.cpp and
+* ../ShaderProgram.cpp, linking against OpenGL.
+**/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include "../HudText.h"
+
+static long long g_allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    g_allocations++;
+    void* pointer = malloc(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept { free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { free(pointer); }
+
+// What draw_text does on the CPU: fresh vectors for every string
+static float draw_text_vertices(const std::string& text, float font_size, float spacing)
+{
+    std::vector<float> vertices;
+    std::vector<float> texture_coordinates;
+    build_text_vertices(vertices, texture_coordinates, text, font_size, spacing, FULL_TEXTURE);
+
+    return vertices.empty() ? 0.0f : vertices[0] + texture_coordinates[0];
+}
+
+int main()
+{
+    const int frame_count = 200000;
+
+    // ----- FORMAT CHECK ----- //
+    int mismatches = 0;
+    for (int i = -200000; i <= 200000; i += 7)
+    {
+        float value = i * 0.00137f;
+        char text[HudText::NUMBER_LENGTH + 1];
+        format_hud_number(text, value);
+        if (std::to_string(value).substr(0, HudText::NUMBER_LENGTH) != text) mismatches++;
+    }
+    printf("format mismatches:   %d\n", mismatches);
+
+    // ----- OLD PATH ----- //
+    float sink = 0.0f;
+    long long before = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frame_count; frame++)
+    {
+        float fuel = 100.0f - frame * 0.008f;
+        float velocity = -0.01f * (frame % 500);
+
+        std::string fuel_text = std::to_string(fuel);
+        sink += draw_text_vertices("Fuel: " + fuel_text.substr(0, 4), 0.2f, 0.001f);
+
+        std::string velocity_text = std::to_string(velocity);
+        sink += draw_text_vertices("Velocity: " + velocity_text.substr(0, 4), 0.2f, 0.001f);
+    }
+
+    double old_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    long long old_allocations = g_allocations - before;
+
+    // ----- HUD TEXT ----- //
+    HudText hud;
+    hud.set_font(0, FULL_TEXTURE);
+    int fuel_label = hud.add_run(6, 0.2f, 0.001f, glm::vec3(-4.5f, 2.25f, 0.0f));
+    int fuel_run = hud.add_run(HudText::NUMBER_LENGTH, 0.2f, 0.001f, hud.get_position_after(fuel_label, 6));
+    int velocity_label = hud.add_run(10, 0.2f, 0.001f, glm::vec3(-4.5f, 2.5f, 0.0f));
+    int velocity_run = hud.add_run(HudText::NUMBER_LENGTH, 0.2f, 0.001f, hud.get_position_after(velocity_label, 10));
+    hud.set_text(fuel_label, "Fuel: ");
+    hud.set_text(velocity_label, "Velocity: ");
+
+    before = g_allocations;
+    start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frame_count; frame++)
+    {
+        float fuel = 100.0f - frame * 0.008f;
+        float velocity = -0.01f * (frame % 500);
+
+        hud.set_number(fuel_run, fuel);
+        hud.set_number(velocity_run, velocity);
+    }
+
+    double hud_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    long long hud_allocations = g_allocations - before;
+
+    printf("%-12s %14s %14s\n", "path", "allocs/frame", "ns/frame");
+    printf("%-12s %14.2f %14.1f\n", "draw_text", (double)old_allocations / frame_count, old_ns / frame_count);
+    printf("%-12s %14.2f %14.1f\n", "HudText", (double)hud_allocations / frame_count, hud_ns / frame_count);
+    printf("(sink %f)\n", sink);
+
+    if (hud_allocations != 0 || mismatches != 0)
+    {
+        printf("FAIL: HudText allocated %lld times\n", hud_allocations);
+        return 1;
+    }
+    return 0;
+}
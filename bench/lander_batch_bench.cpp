@@ -0,0 +1,118 @@
+/**
+* LanderBatch vs. the scalar step.
+*
+* Flies the same random landers through the same random inputs once with
+* tick_lander() one lander at a time and once with LanderBatch::tick(), then
+* reports the time per lander-tick for both and checks that the final
+* states match bit for bit.
+*
+*   lander_batch_bench [lander_count] [tick_count]
+*
+* Build with -O2 -ffp-contract=off (plus -mavx2 for the AVX2 kernel)
+* together with ../Simulation.cpp, ../Terrain.cpp, ../Broadphase.cpp and
+* ../LanderBatch.cpp.
+**/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "../LanderBatch.h"
+
+static uint32_t g_seed = 12345;
+
+static float random_range(float low, float high)
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return low + (high - low) * (float)(g_seed >> 8) / (float)(1u << 24);
+}
+
+static TickInput random_input(int lander, int tick)
+{
+    uint32_t hash = (uint32_t)lander * 2654435761u ^ (uint32_t)tick * 2246822519u;
+    hash ^= hash >> 15;
+    hash *= 2654435761u;
+
+    TickInput input;
+    input.left = (hash & 7) == 0;
+    input.right = (hash & 7) == 1;
+    input.up = ((hash >> 4) & 3) == 0;
+    return input;
+}
+
+static bool same_bits(float a, float b) { return memcmp(&a, &b, sizeof(float)) == 0; }
+
+int main(int argc, char* argv[])
+{
+    int lander_count = argc > 1 ? atoi(argv[1]) : 16384;
+    int tick_count = argc > 2 ? atoi(argv[2]) : 600;
+
+    Block blocks[PLATFORM_COUNT];
+    build_classic_blocks(blocks, 10);
+
+    World world;
+    reset_world(world, NULL);
+
+    std::vector<Lander> landers(lander_count);
+    for (int i = 0; i < lander_count; i++)
+    {
+        Lander& lander = landers[i];
+        lander = world.lander;
+        lander.position = glm::vec3(random_range(-5.4f, 5.4f), random_range(-2.5f, 3.5f), 0.0f);
+        lander.velocity = glm::vec3(random_range(-1.0f, 1.0f), random_range(-3.0f, 1.0f), 0.0f);
+        lander.acceleration = glm::vec3(random_range(-1.5f, 1.5f), random_range(-9.8f, 3.5f), 0.0f);
+        lander.fuel = random_range(0.0f, 1.0f);
+    }
+
+    LanderBatch batch;
+    batch.reserve(lander_count);
+    for (int i = 0; i < lander_count; i++) batch.add(landers[i]);
+
+    std::vector<std::vector<TickInput> > inputs(tick_count, std::vector<TickInput>(lander_count));
+    for (int t = 0; t < tick_count; t++)
+        for (int i = 0; i < lander_count; i++) inputs[t][i] = random_input(i, t);
+
+    // ----- SCALAR ----- //
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < tick_count; t++)
+    {
+        for (int i = 0; i < lander_count; i++)
+        {
+            apply_input(landers[i], inputs[t][i]);
+            tick_lander(landers[i], blocks, PLATFORM_COUNT);
+        }
+    }
+    double scalar_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // ----- BATCH ----- //
+    start = std::chrono::steady_clock::now();
+    for (int t = 0; t < tick_count; t++)
+    {
+        batch.tick(inputs[t].data(), blocks, PLATFORM_COUNT);
+    }
+    double batch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // ----- CHECK ----- //
+    int mismatches = 0, finished = 0;
+    for (int i = 0; i < lander_count; i++)
+    {
+        Lander a = landers[i], b = batch.get(i);
+        bool same = same_bits(a.position.x, b.position.x) && same_bits(a.position.y, b.position.y) &&
+            same_bits(a.velocity.x, b.velocity.x) && same_bits(a.velocity.y, b.velocity.y) &&
+            same_bits(a.acceleration.x, b.acceleration.x) && same_bits(a.acceleration.y, b.acceleration.y) &&
+            same_bits(a.fuel, b.fuel) && a.depleted == b.depleted && a.is_winner == b.is_winner &&
+            a.is_loser == b.is_loser && a.crash_land == b.crash_land;
+
+        if (!same) mismatches++;
+        if (a.is_winner || a.is_loser) finished++;
+    }
+
+    double lander_ticks = (double)lander_count * tick_count;
+    printf("landers: %d, ticks: %d, kernel: %s\n", lander_count, tick_count, LanderBatch::get_kernel_name());
+    printf("scalar:   %8.2f ns/lander-tick\n", scalar_seconds * 1e9 / lander_ticks);
+    printf("batch:    %8.2f ns/lander-tick\n", batch_seconds * 1e9 / lander_ticks);
+    printf("speed-up: %8.2fx\n", batch_seconds > 0.0 ? scalar_seconds / batch_seconds : 0.0);
+    printf("finished: %d, mismatches: %d\n", finished, mismatches);
+
+    return mismatches == 0 ? 0 : 1;
+}
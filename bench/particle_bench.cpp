@@ -0,0 +1,142 @@
+/**
+* Particle system vs. one Entity per particle.
+*
+* For 1000, 10000 and 100000 live particles, times a frame of the pooled
+* SoA ParticleSystem (update: integrate and swap-remove the expired ones;
+* build: write the quads for its single draw call) against the old way of
+* showing a sprite, an Entity run through Entity::update and drawn through
+* the SpriteBatch. The pool is kept full by re-emitting whatever expired,
+* so removal is measured at a steady churn rate.
+*
+* Only the CPU side is measured, so no GL context is created. The
+* integrator is picked at compile time; build once with -mavx2 and once
+* without to compare the AVX2 and SSE2 kernels.
+*
+* Build with -O2 together with ../ParticleSystem.cpp, ../Arena.cpp,
+* ../Entity.cpp, ../SpriteBatch.cpp, ../Simulation.cpp, ../Terrain.cpp,
+* ../GlState.cpp and ../ShaderProgram.cpp, linking against SDL2 and OpenGL.
+**/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "../Entity.h"
+#include "../ParticleSystem.h"
+
+static const int FRAMES = 200;
+static const float FRAME_TIME = 1.0f / 60.0f;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Exhaust-like particles living 0.5 to 1.5 s, so about 1/60 of the pool
+// expires every frame
+static ParticleSpawn make_spawn()
+{
+    ParticleSpawn spawn;
+    spawn.position = glm::vec3(0.0f, 2.0f, 0.0f);
+    spawn.position_jitter = 0.1f;
+    spawn.velocity = glm::vec3(0.0f, -2.0f, 0.0f);
+    spawn.velocity_jitter = glm::vec3(1.0f, 0.5f, 0.0f);
+    spawn.lifetime = 1.0f;
+    spawn.lifetime_jitter = 0.5f;
+    spawn.size = 0.1f;
+    spawn.gravity = -1.6f;
+    spawn.sprite = 0;
+    return spawn;
+}
+
+struct FrameTimes
+{
+    double update_ms, build_ms;
+};
+
+static double median(std::vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+static FrameTimes run_pool(int count, int& dropped)
+{
+    Arena arena;
+    arena.initialise(ParticleSystem::get_arena_bytes(count));
+
+    ParticleSystem particles;
+    particles.initialise(arena, count);
+    particles.add_sprite(FULL_TEXTURE);
+
+    ParticleSpawn spawn = make_spawn();
+    particles.emit(spawn, count);
+
+    std::vector<double> update_samples, build_samples;
+    dropped = 0;
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        particles.emit(spawn, count - particles.get_count());
+        particles.update(FRAME_TIME);
+        particles.draw(nullptr);
+
+        const ParticleStats& stats = particles.get_stats();
+        update_samples.push_back(stats.update_ms);
+        build_samples.push_back(stats.build_ms);
+        dropped += stats.dropped;
+    }
+
+    arena.shutdown();
+    return { median(update_samples), median(build_samples) };
+}
+
+// What a sprite cost before: Entity::update for the model matrix, then a
+// quad through the batch (the batch's GL upload is left out)
+static FrameTimes run_entities(int count)
+{
+    std::vector<Entity> entities(count);
+    for (int i = 0; i < count; i++)
+    {
+        entities[i].set_position(glm::vec3(0.0f, 2.0f, 0.0f));
+        entities[i].set_velocity(glm::vec3(0.0f, -2.0f, 0.0f));
+        entities[i].set_acceleration(glm::vec3(0.0f, -1.6f, 0.0f));
+        entities[i].set_width(0.1f);
+        entities[i].set_height(0.1f);
+    }
+
+    SpriteBatch batch;
+    std::vector<double> update_samples, build_samples;
+    for (int frame = 0; frame < FRAMES / 10; frame++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (Entity& entity : entities) entity.update(FRAME_TIME, NULL, NULL, 0);
+        update_samples.push_back(elapsed_ms(start));
+
+        start = std::chrono::steady_clock::now();
+        batch.begin(nullptr);
+        for (Entity& entity : entities) entity.render(&batch);
+        build_samples.push_back(elapsed_ms(start));
+    }
+
+    return { median(update_samples), median(build_samples) };
+}
+
+int main()
+{
+    const int counts[] = { 1000, 10000, 100000 };
+
+    printf("integrator: %s, median of %d frames\n\n", ParticleSystem::get_kernel_name(), FRAMES);
+    printf("%8s | %12s %12s | %12s %12s | %8s\n", "live", "pool update", "pool build", "entity upd", "entity build", "speedup");
+
+    for (int count : counts)
+    {
+        int dropped;
+        FrameTimes pool = run_pool(count, dropped);
+        FrameTimes entity = run_entities(count);
+
+        printf("%8d | %9.3f ms %9.3f ms | %9.3f ms %9.3f ms | %7.1fx%s\n", count, pool.update_ms, pool.build_ms,
+            entity.update_ms, entity.build_ms, (entity.update_ms + entity.build_ms) / (pool.update_ms + pool.build_ms),
+            dropped > 0 ? "  (dropped spawns)" : "");
+    }
+
+    return 0;
+}
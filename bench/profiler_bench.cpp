@@ -0,0 +1,62 @@
+/**
+* Cost of a PROFILE_SCOPE.
+*
+* Times an empty loop and the same loop with a PROFILE_SCOPE in its body,
+* collecting every few thousand iterations as the game does once a frame,
+* and prints the summary and dropped-event count the overlay would show.
+* Built without -DLUNAR_PROFILE the scope compiles to nothing and both
+* loops should cost the same.
+*
+* Build with -O2 (with or without -DLUNAR_PROFILE) together with
+* ../Profiler.cpp.
+**/
+#include <chrono>
+#include <cstdio>
+#include "../Profiler.h"
+
+static volatile int g_sink = 0;
+
+int main()
+{
+    const int iterations = 5000000;
+#ifdef LUNAR_PROFILE
+    const int frame_length = 4096;
+#endif
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) g_sink = g_sink + i;
+    double empty_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        {
+            PROFILE_SCOPE("iteration");
+            g_sink = g_sink + i;
+        }
+#ifdef LUNAR_PROFILE
+        if (i % frame_length == frame_length - 1) Profiler::get().collect();
+#endif
+    }
+    double scoped_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    printf("profiling:      %s\n",
+#ifdef LUNAR_PROFILE
+        "on"
+#else
+        "off (compiled away)"
+#endif
+    );
+    printf("empty loop:     %.2f ns/iteration\n", empty_ns / iterations);
+    printf("with scope:     %.2f ns/iteration (including collect)\n", scoped_ns / iterations);
+
+#ifdef LUNAR_PROFILE
+    Profiler::get().collect();
+    ProfileSummary summary;
+    Profiler::get().get_summary(0, summary);
+    printf("%s: min %.6f avg %.6f p99 %.6f ms over the last %d, %llu dropped\n", summary.name,
+        summary.min_ms, summary.avg_ms, summary.p99_ms, summary.samples,
+        (unsigned long long)Profiler::get().get_dropped());
+#endif
+    return 0;
+}
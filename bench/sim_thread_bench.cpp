@@ -0,0 +1,177 @@
+/**
+* Simulation on the main thread vs. on its own thread.
+*
+* A stand-in frame loop samples an input, "renders" by sleeping for a
+* fixed time (a slow swap or vsync wait) and repeats for a few seconds.
+* Sequentially the ticks can only run between frames, so they come in
+* bursts as far apart as the frames; with SimThread they keep their own
+* 60 Hz cadence whatever the frame takes. Reports the longest gap between
+* ticks, the tick count, both threads' utilisation and the key event to
+* tick latency, then replays the input log the simulation thread wrote
+* and checks it reaches the same final state.
+*
+* First, on a virtual clock, shows the fuel burnt holding thrust for two
+* seconds at several frame rates, charged per frame (the old
+* process_input) and per tick.
+*
+*   sim_thread_bench [render_ms] [seconds]
+*
+* Build with -O2 -pthread together with ../Simulation.cpp, ../Terrain.cpp,
+* ../InputLog.cpp, ../SimThread.cpp and ../Profiler.cpp.
+**/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "../SimThread.h"
+
+static TickInput held_thrust(const World&, void*)
+{
+    TickInput input = { false, false, true };
+    return input;
+}
+
+static TickInput pilot(uint32_t frame)
+{
+    TickInput input;
+    input.left = (frame / 30) % 2 == 0;
+    input.right = !input.left;
+    input.up = (frame % 3) != 0;
+    return input;
+}
+
+int main(int argc, char* argv[])
+{
+    int render_ms = argc > 1 ? atoi(argv[1]) : 40;
+    double seconds = argc > 2 ? atof(argv[2]) : 3.0;
+
+    Terrain terrain;
+    build_classic_terrain(terrain, 7);
+
+    World world;
+
+    // ----- FUEL BURN ----- //
+    printf("fuel burnt holding thrust for 2 s\n%10s %12s %12s\n", "frame rate", "per frame", "per tick");
+    const float frame_rates[] = { 30.0f, 60.0f, 144.0f };
+    for (float frame_rate : frame_rates)
+    {
+        float burnt[2];
+        for (int per_tick = 0; per_tick < 2; per_tick++)
+        {
+            reset_world(world, &terrain);
+            world.lander.position.y = 1000.0f;
+            for (int frame = 0; frame < (int)(2.0f * frame_rate); frame++)
+            {
+                if (!per_tick) apply_input(world, held_thrust(world, NULL));
+                advance_world(world, 1.0f / frame_rate, MAX_SUBSTEPS, per_tick ? held_thrust : NULL, NULL);
+            }
+            burnt[per_tick] = STARTING_FUEL - world.lander.fuel;
+        }
+        printf("%7.0f Hz %12.3f %12.3f\n", frame_rate, burnt[0], burnt[1]);
+    }
+    printf("\n");
+
+    // ----- SEQUENTIAL ----- //
+    reset_world(world, &terrain);
+    world.lander.position.y = 1000.0f;      // keep flying for the whole run
+
+    uint64_t start_ns = sim_clock_ns(), last_ns = start_ns, last_tick_ns = start_ns, max_gap_ns = 0, busy_ns = 0;
+    for (uint32_t frame = 0; sim_clock_ns() - start_ns < seconds * 1e9; frame++)
+    {
+        uint64_t now_ns = sim_clock_ns();
+        apply_input(world, pilot(frame));
+        if (advance_world(world, (now_ns - last_ns) / 1e9f) > 0)
+        {
+            if (now_ns - last_tick_ns > max_gap_ns) max_gap_ns = now_ns - last_tick_ns;
+            last_tick_ns = now_ns;
+        }
+        last_ns = now_ns;
+        busy_ns += sim_clock_ns() - now_ns;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(render_ms));
+    }
+    double elapsed_ns = (double)(sim_clock_ns() - start_ns);
+
+    printf("render %d ms per frame, %.1f s\n", render_ms, seconds);
+    printf("%-12s %14s %8s %18s\n", "", "max tick gap", "ticks", "simulation busy");
+    printf("%-12s %11.1f ms %8u %17.2f%%\n", "sequential", max_gap_ns / 1e6, world.tick, 100.0 * busy_ns / elapsed_ns);
+
+    // ----- PIPELINED ----- //
+    reset_world(world, &terrain);
+    world.lander.position.y = 1000.0f;
+
+    InputLog log;
+    log.begin(0);
+
+    SimThread sim_thread;
+    sim_thread.start(&world, &log);
+
+    start_ns = sim_clock_ns();
+    uint64_t main_busy_ns = 0;
+    float sink = 0.0f;
+    TickInput previous = { false, false, false };
+    uint32_t seed = 5;
+    for (uint32_t frame = 0; sim_clock_ns() - start_ns < seconds * 1e9; frame++)
+    {
+        uint64_t frame_start_ns = sim_clock_ns();
+
+        // Key changes, stamped somewhere during the previous frame like SDL events
+        TickInput input = pilot(frame);
+        const bool changed[3] = { input.left != previous.left, input.right != previous.right, input.up != previous.up };
+        const bool pressed[3] = { input.left, input.right, input.up };
+        for (int key = 0; key < 3; key++)
+        {
+            if (!changed[key]) continue;
+            seed = seed * 1664525u + 1013904223u;
+            KeyEvent event;
+            event.time_ns = frame_start_ns - (uint64_t)((seed >> 8) % (render_ms * 1000)) * 1000;
+            event.key = (InputKey)key;
+            event.pressed = pressed[key];
+            sim_thread.push_event(event);
+        }
+        previous = input;
+
+        const RenderSnapshot& snapshot = sim_thread.read_latest();
+        sink += get_render_position(snapshot, sim_clock_ns()).y;
+        main_busy_ns += sim_clock_ns() - frame_start_ns;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(render_ms));
+    }
+    elapsed_ns = (double)(sim_clock_ns() - start_ns);
+
+    sim_thread.stop();
+    SimThreadStats stats = sim_thread.get_stats();
+
+    printf("%-12s %11.1f ms %8u %17.2f%%   (main thread busy %.3f%%, %llu snapshots, %llu events dropped)\n",
+        "pipelined", stats.max_tick_gap_ms, stats.ticks, 100.0 * stats.busy_fraction, 100.0 * main_busy_ns / elapsed_ns,
+        (unsigned long long)stats.snapshots, (unsigned long long)stats.events_dropped);
+    printf("key latency: %llu events, mean %.2f ms, p99 %.0f ms, max %.2f ms, %llu after their tick\n",
+        (unsigned long long)stats.key_events, stats.mean_latency_ms, stats.p99_latency_ms, stats.max_latency_ms,
+        (unsigned long long)stats.late_events);
+
+    // The world's lander was moved off the ground by hand, so replay from the same start
+    uint64_t final_hash = hash_world(world);
+    log.finish(world.tick, final_hash);
+
+    World replayed;
+    reset_world(replayed, &terrain);
+    replayed.lander.position.y = 1000.0f;
+
+    InputLogCursor cursor;
+    InputRecord record;
+    bool pending = log.next_record(cursor, record);
+    while (true)
+    {
+        while (pending && record.tick == replayed.tick)
+        {
+            apply_input(replayed, record.input);
+            pending = log.next_record(cursor, record);
+        }
+        if (replayed.tick >= log.get_end_tick()) break;
+        tick_world(replayed);
+    }
+
+    bool match = hash_world(replayed) == final_hash;
+    printf("input log replay %s (sink %.1f)\n", match ? "matches" : "DOES NOT MATCH", sink);
+    return match ? 0 : 1;
+}
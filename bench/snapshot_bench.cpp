@@ -0,0 +1,145 @@
+/**
+* World snapshot and restore latency.
+*
+* Times SnapshotRing::save and ::restore on a live flight, then checks the
+* two uses they exist for:
+*
+*   rollback    - save every tick, restore an earlier one, re-simulate the
+*                 same inputs and land on the same state hash
+*   look-ahead  - branch several candidate inputs from one tick, run each a
+*                 second ahead, restore in between, and report the cost
+*
+* Build with -O2 together with ../Simulation.cpp, ../Terrain.cpp and
+* ../Snapshot.cpp.
+**/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "../Snapshot.h"
+
+static TickInput scripted_input(uint32_t tick)
+{
+    TickInput input;
+    input.left = (tick / 40) % 3 == 0;
+    input.right = (tick / 40) % 3 == 1;
+    input.up = (tick / 7) % 2 == 0;
+    return input;
+}
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    const int ring_capacity = 600;          // ten seconds of rollback at 60 ticks a second
+    const int repetitions = 10000000;
+    bool ok = true;
+
+    Terrain terrain;
+    build_classic_terrain(terrain, 7);
+
+    World world;
+    reset_world(world, &terrain);
+
+    SnapshotRing ring;
+    ring.initialise(ring_capacity);
+
+    printf("sizeof(World): %zu bytes\n", sizeof(World));
+
+    // ----- LATENCY ----- //
+    for (int i = 0; i < 90; i++)
+    {
+        apply_input(world, scripted_input(world.tick));
+        tick_world(world);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++)
+    {
+        world.tick = (uint32_t)i;           // a different slot every time, like a running game
+        ring.save(world);
+    }
+    double save_ns = elapsed_ns(start) / repetitions;
+
+    World restored;
+    uint64_t sink = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; i++)
+    {
+        uint32_t tick = (uint32_t)(repetitions - 1 - (i % ring_capacity));
+        sink += ring.restore(tick, restored) ? restored.tick : 0;
+    }
+    double restore_ns = elapsed_ns(start) / repetitions;
+
+    printf("save:           %.2f ns\n", save_ns);
+    printf("restore:        %.2f ns (sink %llu)\n", restore_ns, (unsigned long long)sink);
+
+    // ----- ROLLBACK ----- //
+    reset_world(world, &terrain);
+    ring.initialise(ring_capacity);
+
+    for (int i = 0; i < 240; i++)
+    {
+        ring.save(world);
+        apply_input(world, scripted_input(world.tick));
+        tick_world(world);
+    }
+    uint64_t straight_hash = hash_world(world);
+
+    ring.restore(120, world);
+    while (world.tick < 240)
+    {
+        apply_input(world, scripted_input(world.tick));
+        tick_world(world);
+    }
+    bool rollback_matches = hash_world(world) == straight_hash;
+    // Same slot as tick 120, but a tick that was never saved
+    bool stale_rejected = !ring.restore(120 + ring_capacity, restored);
+    ok = ok && rollback_matches && stale_rejected;
+
+    printf("rollback:       re-simulated 120 ticks, hash %s\n", rollback_matches ? "matches" : "DIFFERS");
+
+    // ----- LOOK-AHEAD ----- //
+    const int branch_ticks = 60, search_count = 10000;
+    const TickInput candidates[] = {
+        { false, false, false }, { false, false, true }, { true, false, true }, { false, true, true },
+    };
+    const int candidate_count = sizeof(candidates) / sizeof(candidates[0]);
+
+    ring.restore(200, world);
+    uint64_t root_hash = hash_world(world);
+    World root = world;
+
+    float best_speed = 0.0f;
+    start = std::chrono::steady_clock::now();
+    for (int search = 0; search < search_count; search++)
+    {
+        for (int c = 0; c < candidate_count; c++)
+        {
+            world = root;
+            for (int t = 0; t < branch_ticks; t++)
+            {
+                apply_input(world, candidates[c]);
+                tick_world(world);
+            }
+            if (world.lander.velocity.y < best_speed) best_speed = world.lander.velocity.y;
+        }
+    }
+    double search_us = elapsed_ns(start) / search_count / 1000.0;
+
+    world = root;
+    bool root_intact = hash_world(world) == root_hash;
+    ok = ok && root_intact;
+
+    printf("look-ahead:     %d branches x %d ticks in %.2f us per search, root %s (best vy %.3f)\n",
+        candidate_count, branch_ticks, search_us, root_intact ? "intact" : "CHANGED", best_speed);
+
+    if (!ok)
+    {
+        printf("FAIL\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+* Swept terrain collision and 0.1 s physics steps.
+*
+*   tunnelling   drops a lander straight down onto a block at increasing
+*                speeds and reports which collision test still catches it:
+*                the Block overlap test (as Entity::update) or the sweep
+*                step_lander does against the Terrain, in 60 Hz ticks and
+*                in one 0.1 s step
+*   autopilot    evaluates the same episodes deciding every tick at 60 Hz,
+*                every 6 ticks at 60 Hz, and once per 0.1 s step. The first
+*                two differ by the cost of deciding less often; the last two
+*                by the cost of the larger step, which has to stay within
+*                the tolerances below
+*
+* Build with -O2 together with ../Simulation.cpp, ../Terrain.cpp,
+* ../Evaluator.cpp and ../JobSystem.cpp; link with -pthread.
+**/
+#include <cmath>
+#include <cstdio>
+#include "../Evaluator.h"
+
+// How far 0.1 s steps may move the autopilot's results from 60 Hz ticks
+// with the same decisions
+static const double LANDED_TOLERANCE = 1.0,      // percentage points
+    IMPACT_TOLERANCE = 0.01,                        // m/s, mean impact speed
+    CONTACT_TOLERANCE = 0.05;                       // s, mean contact time
+
+int main()
+{
+    bool ok = true;
+
+    Terrain terrain;
+    build_classic_terrain(terrain, 7);
+    Block blocks[PLATFORM_COUNT];
+    build_classic_blocks(blocks, 7);
+
+    // ----- TUNNELLING ----- //
+    // One tick from just above block 3; its top is at -3.375 and the lander
+    // is 0.75 high, so contact is at y = -3.0
+    printf("%10s %16s %16s %16s %14s\n", "speed m/s", "overlap test", "sweep", "sweep, 0.1 s", "contact y");
+    const float speeds[] = { 10.0f, 40.0f, 60.0f, 80.0f, 120.0f, 500.0f };
+    for (float speed : speeds)
+    {
+        World world;
+        reset_world(world, &terrain);
+        Lander lander = world.lander;
+        lander.position = glm::vec3(blocks[3].position.x, -2.95f, 0.0f);
+        lander.velocity = glm::vec3(0.0f, -speed, 0.0f);
+        lander.acceleration = glm::vec3(0.0f, -1.0f, 0.0f);
+
+        // Two ticks each: the overlap test only reacts on the tick after
+        Lander overlap = lander, swept = lander, coarse = lander;
+        for (int t = 0; t < 2; t++)
+        {
+            step_lander(overlap, blocks, PLATFORM_COUNT, FIXED_TIMESTEP);
+            step_lander(swept, terrain, FIXED_TIMESTEP);
+        }
+        step_lander(coarse, terrain, 6 * FIXED_TIMESTEP);
+
+        bool overlap_caught = overlap.is_loser || overlap.is_winner;
+        bool swept_caught = swept.is_loser || swept.is_winner;
+        bool coarse_caught = coarse.is_loser || coarse.is_winner;
+        if (!swept_caught || fabsf(swept.position.y + 3.0f) > 1e-4f) ok = false;
+        if (!coarse_caught || fabsf(coarse.position.y + 3.0f) > 1e-4f) ok = false;
+
+        printf("%10.0f %16s %16s %16s %14.5f\n", speed, overlap_caught ? "hit" : "passed through",
+            swept_caught ? "hit" : "passed through", coarse_caught ? "hit" : "passed through", swept.position.y);
+    }
+
+    // ----- AUTOPILOT ----- //
+    EvaluationConfig config;
+    config.seed = 1;
+    config.episode_count = 100000;
+    config.max_ticks = 3600;
+    config.tuning = DEFAULT_TUNING;
+    config.controller = find_controller("autopilot");
+
+    printf("\n%8s %8s %10s %10s %16s %16s %10s\n", "decide", "step", "landed", "hit", "impact m/s", "contact s", "ms");
+    const int runs[][2] = { { 1, 1 }, { 6, 1 }, { 6, 6 } };    // decision ticks, step ticks
+    double landed[3], impact[3], contact[3];
+    for (int run = 0; run < 3; run++)
+    {
+        config.decision_ticks = runs[run][0];
+        config.step_ticks = runs[run][1];
+        EvaluationResult result = evaluate(config, 1);
+        double touched_down = (double)(result.episodes - result.timed_out);
+        landed[run] = 100.0 * result.landed / result.episodes;
+        impact[run] = result.impact_speed / touched_down;
+        contact[run] = result.contact_time / touched_down;
+        printf("%8d %8d %9.2f%% %9.2f%% %16.4f %16.4f %10.0f\n", runs[run][0], runs[run][1], landed[run],
+            100.0 * result.hit / result.episodes, impact[run], contact[run], result.run_ms);
+    }
+
+    bool within = fabs(landed[2] - landed[1]) <= LANDED_TOLERANCE && fabs(impact[2] - impact[1]) <= IMPACT_TOLERANCE &&
+        fabs(contact[2] - contact[1]) <= CONTACT_TOLERANCE;
+    printf("\n0.1 s steps vs 60 Hz: landed %+.2f points, impact %+.4f m/s, contact %+.4f s, %s\n",
+        landed[2] - landed[1], impact[2] - impact[1], contact[2] - contact[1],
+        within ? "within tolerance" : "OUT OF TOLERANCE");
+    printf("swept collision %s\n", ok ? "agrees" : "DISAGREES");
+    return ok && within ? 0 : 1;
+}
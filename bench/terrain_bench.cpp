@@ -0,0 +1,74 @@
+/**
+* Terrain column lookup vs. a linear block scan.
+*
+* Builds levels of increasing width (every other column a block, like the
+* classic level) and times one collision query per lander position, both
+* with Terrain::find_contact and by scanning every Block with aabb_overlap
+* the way Entity::update does.
+*
+* Build with -O2 together with ../Simulation.cpp and ../Terrain.cpp.
+**/
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "../Simulation.h"
+
+int main()
+{
+    const int level_columns[] = { 41, 1001, 100001 };
+    const int query_count = 2000000;
+
+    printf("%10s %16s %16s\n", "columns", "terrain ns/query", "blocks ns/query");
+
+    for (int columns : level_columns)
+    {
+        Terrain terrain;
+        terrain.reset(-columns * 0.125f, 0.25f, columns);
+
+        std::vector<Block> blocks;
+        for (int c = 0; c < columns; c += 2)
+        {
+            terrain.set_column(c, -3.625f, -3.375f);
+
+            Block block;
+            block.position = glm::vec3(terrain.get_column_center_x(c), -3.5f, 0.0f);
+            block.width = 0.25f;
+            block.height = 0.25f;
+            block.is_platform = false;
+            blocks.push_back(block);
+        }
+
+        // Landers spread across the whole level, half of them low enough to touch
+        float level_width = columns * 0.25f;
+        long long sink = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < query_count; i++)
+        {
+            glm::vec3 position(-level_width / 2.0f + level_width * (i % 9973) / 9973.0f, (i & 1) ? -3.2f : 0.0f, 0.0f);
+            sink += terrain.find_contact(position, 0.75f, 0.75f);
+        }
+        double terrain_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // The scan gets far fewer queries on wide levels, it would take minutes otherwise
+        int scan_count = query_count / (columns / 41);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < scan_count; i++)
+        {
+            glm::vec3 position(-level_width / 2.0f + level_width * (i % 9973) / 9973.0f, (i & 1) ? -3.2f : 0.0f, 0.0f);
+            for (size_t b = 0; b < blocks.size(); b++)
+            {
+                if (aabb_overlap(position, 0.75f, 0.75f, blocks[b].position, blocks[b].width, blocks[b].height)) {
+                    sink += (long long)b;
+                    break;
+                }
+            }
+        }
+        double block_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%10d %16.2f %16.2f\n", columns, terrain_seconds * 1e9 / query_count, block_seconds * 1e9 / scan_count);
+        if (sink == 42) printf("\n");
+    }
+
+    return 0;
+}
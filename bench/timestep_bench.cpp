@@ -0,0 +1,134 @@
+/**
+* Fixed-timestep loop: stall recovery and motion smoothness.
+*
+* Runs advance_world on a virtual clock, so the numbers do not depend on
+* the machine. Every tick is charged a simulated cost and every frame a
+* render cost; a frame lasts until the next vsync or until its work is
+* done, whichever is later.
+*
+*   stall      a 1 s hitch, then frames until the loop is back to one
+*              frame per vsync, the worst frame after the hitch, the
+*              frame-time standard deviation over the following two
+*              seconds and the time dropped, with and without the
+*              MAX_SUBSTEPS cap
+*   judder     how evenly the lander appears to move at refresh rates that
+*              do not divide 60 Hz, drawing the latest tick vs. the
+*              interpolated position (spread of the apparent speed from
+*              frame to frame)
+*
+* Build with -O2 together with ../Simulation.cpp and ../Terrain.cpp.
+**/
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../Simulation.h"
+
+static void run_stall(const Terrain& terrain, float tick_cost, int max_substeps)
+{
+    const float vsync = 1.0f / 60.0f, render_cost = 0.002f, stall = 1.0f;
+    const int stall_frame = 60, frame_limit = 3000;
+
+    World world;
+    reset_world(world, &terrain);
+    world.lander.position.y = 1000.0f;      // far above the ground, so the flight never ends
+
+    float frame_time = vsync;
+    int recovered_after = -1;
+    float worst = 0.0f;
+    std::vector<float> after_stall;
+
+    for (int frame = 0; frame < frame_limit; frame++)
+    {
+        int ticks = advance_world(world, frame_time, max_substeps);
+
+        float work = ticks * tick_cost + render_cost;
+        if (frame == stall_frame) work += stall;
+        frame_time = work > vsync ? work : vsync;
+
+        if (frame > stall_frame)
+        {
+            if (frame_time > worst) worst = frame_time;
+            if ((int)after_stall.size() < 120) after_stall.push_back(frame_time);
+            if (recovered_after < 0 && frame_time <= vsync && world.accumulator < FIXED_TIMESTEP)
+            {
+                recovered_after = frame - stall_frame;
+            }
+        }
+    }
+
+    double mean = 0.0, variance = 0.0;
+    for (float time : after_stall) mean += time;
+    mean /= after_stall.size();
+    for (float time : after_stall) variance += (time - mean) * (time - mean);
+    variance /= after_stall.size();
+
+    char recovered[32];
+    if (recovered_after < 0) snprintf(recovered, sizeof(recovered), "never");
+    else snprintf(recovered, sizeof(recovered), "%d", recovered_after);
+
+    printf("%9.0f %10s %16s %12.1f %14.2f %10.3f\n", tick_cost * 1000.0f,
+        max_substeps == INT_MAX ? "none" : "MAX_SUBSTEPS", recovered, worst * 1000.0f,
+        sqrt(variance) * 1000.0, world.dropped_time);
+}
+
+static void run_judder(const Terrain& terrain, float refresh_rate)
+{
+    const int frame_count = 600;
+    float frame_time = 1.0f / refresh_rate;
+
+    World world;
+    reset_world(world, &terrain);
+    world.lander.position.y = 1000.0f;
+
+    std::vector<float> latest, interpolated;
+    for (int frame = 0; frame < frame_count; frame++)
+    {
+        advance_world(world, frame_time);
+        latest.push_back(world.lander.position.y);
+        interpolated.push_back(get_render_position(world).y);
+    }
+
+    // Apparent speed per frame against a smooth local average of it
+    double spreads[2];
+    const std::vector<float>* tracks[2] = { &latest, &interpolated };
+    for (int t = 0; t < 2; t++)
+    {
+        const std::vector<float>& y = *tracks[t];
+        double total = 0.0, mean_speed = 0.0;
+        int count = 0;
+        for (int i = 60; i + 2 < frame_count; i++)
+        {
+            double speed = (y[i] - y[i - 1]) / frame_time;
+            double local = (y[i + 2] - y[i - 2]) / (4.0 * frame_time);
+            total += (speed - local) * (speed - local);
+            mean_speed += fabs(local);
+            count++;
+        }
+        spreads[t] = 100.0 * sqrt(total / count) / (mean_speed / count);
+    }
+
+    printf("%8.0f Hz %17.1f%% %17.1f%%\n", refresh_rate, spreads[0], spreads[1]);
+}
+
+int main()
+{
+    Terrain terrain;
+    build_classic_terrain(terrain, 7);
+
+    printf("stall of 1 s at 60 Hz, 2 ms render\n");
+    printf("%9s %10s %16s %12s %14s %10s\n", "tick ms", "cap", "frames to 60 Hz", "worst ms", "stddev ms (2s)", "dropped s");
+    const float tick_costs[] = { 0.002f, 0.008f, 0.012f, 0.014f };
+    for (float tick_cost : tick_costs)
+    {
+        run_stall(terrain, tick_cost, INT_MAX);
+        run_stall(terrain, tick_cost, MAX_SUBSTEPS);
+    }
+
+    printf("\napparent speed spread, frame to frame\n");
+    printf("%11s %18s %18s\n", "refresh", "latest tick", "interpolated");
+    const float refresh_rates[] = { 50.0f, 60.0f, 75.0f, 90.0f, 144.0f };
+    for (float refresh_rate : refresh_rates) run_judder(terrain, refresh_rate);
+
+    return 0;
+}
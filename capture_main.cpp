@@ -0,0 +1,286 @@
+/**
+* Flight video capture.
+*
+* Replays an input log recorded by the game (see InputLog.h) and renders
+* the flight the way the game draws it, without a window: the frames go
+* into an offscreen framebuffer on an EGL context (OffscreenContext.h),
+* which on a machine without a display or GPU is Mesa's llvmpipe. They are
+* read back through a ring of pixel buffer objects and written out on a
+* writer thread (FrameCapture.h), either as one stream of raw RGBA frames
+* or as a numbered PNG per frame.
+*
+* One frame is drawn every --every ticks (default 1, a 60 fps video). Run it
+* from the game's working directory; the output directory has to exist.
+* A raw stream turns into a video with
+*
+*   ffmpeg -f rawvideo -pix_fmt rgba -s 800x600 -r 60 -i frames.rgba flight.mp4
+*
+* Builds from FlightScene.cpp, FrameCapture.cpp, OffscreenContext.cpp,
+* BakedLevel.cpp, SpatialGrid.cpp, Camera.cpp, EntityPool.cpp, Entity.cpp,
+* Arena.cpp, SpriteBatch.cpp, ParticleSystem.cpp, HudText.cpp,
+* TextureAtlas.cpp, AssetPack.cpp, GlState.cpp, Simulation.cpp, Terrain.cpp,
+* InputLog.cpp and ShaderProgram.cpp plus a translation unit with
+* STB_IMAGE_IMPLEMENTATION, linking against SDL2, OpenGL and EGL.
+*
+*   capture [--png] [--every ticks] <log> <output directory>
+**/
+#define GL_SILENCE_DEPRECATION
+#define GL_GLEXT_PROTOTYPES 1
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "glm/gtc/matrix_transform.hpp"
+#include "AssetPack.h"
+#include "BakedLevel.h"
+#include "Camera.h"
+#include "Entity.h"
+#include "EntityPool.h"
+#include "FlightScene.h"
+#include "FrameCapture.h"
+#include "GameAssets.h"
+#include "GlState.h"
+#include "InputLog.h"
+#include "OffscreenContext.h"
+#include "ShaderProgram.h"
+#include "Simulation.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+
+// The game's window (see main.cpp); what it shows is in FlightScene.h
+constexpr int FRAME_WIDTH = 800,
+FRAME_HEIGHT = 600;
+constexpr char ATLAS_CACHE_FILEPATH[] = "assets/atlas.cache";
+
+struct Scene
+{
+    ShaderProgram program;
+    TextureAtlas atlas;
+    AssetPack pack;
+    GLuint atlas_texture_id;
+
+    Arena level_arena;
+    EntityPool blocks;
+    BakedLevel level;
+    Camera camera;
+
+    Entity player;
+    SpriteBatch batch;
+
+    FlightEffects effects;
+    FlightHud hud;
+};
+
+// Same order as the game: the pack, then the cache, then the PNGs
+bool load_atlas(Scene& scene)
+{
+    bool loaded = (scene.pack.open(ASSET_PACK_FILEPATH) &&
+        scene.atlas.load_pack(scene.pack, ATLAS_PACK_NAME, ATLAS_SOURCES, ATLAS_SPRITE_COUNT)) ||
+        scene.atlas.load_cache(ATLAS_CACHE_FILEPATH, ATLAS_SOURCES, ATLAS_SPRITE_COUNT) ||
+        scene.atlas.build(ATLAS_SOURCES, ATLAS_SPRITE_COUNT);
+    if (!loaded) return false;
+
+    scene.atlas_texture_id = scene.atlas.upload();
+    GlState::get().invalidate();
+    scene.pack.close();
+    return true;
+}
+
+void set_up_scene(Scene& scene, const Terrain& terrain, int level_number, int screen_count)
+{
+    scene.program.load(V_SHADER_PATH, F_SHADER_PATH);
+    GlState& gl = GlState::get();
+    gl.use_program(&scene.program);
+    gl.set_projection_matrix(&scene.program, glm::ortho(-VIEW_HALF_WIDTH, VIEW_HALF_WIDTH, -VIEW_HALF_HEIGHT, VIEW_HALF_HEIGHT, -1.0f, 1.0f));
+    gl.set_view_matrix(&scene.program, glm::mat4(1.0f));
+
+    glClearColor(BG_RED, BG_GREEN, BG_BLUE, BG_OPACITY);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // ----- LEVEL ----- //
+    scene.level_arena.initialise(EntityPool::get_arena_bytes(PLATFORM_COUNT * screen_count));
+    create_level_blocks(scene.blocks, scene.level_arena, screen_count, level_number, scene.atlas_texture_id, &scene.atlas);
+    scene.level.bake(scene.blocks, terrain);
+    scene.level.upload(scene.atlas_texture_id);
+    set_up_camera(scene.camera, screen_count);
+
+    // ----- LANDER ----- //
+    scene.player = Entity(scene.atlas_texture_id, 5.0f, glm::vec3(0.0f, -9.8f, 0.0f), 0.75f, 0.75f, PLAYER);
+    scene.player.set_uv_rect(scene.atlas.get_rect(ATLAS_LANDER));
+    scene.batch.initialise(1);
+
+    // ----- PARTICLES ----- //
+    scene.effects.initialise();
+    scene.effects.set_sprites(scene.atlas_texture_id, scene.atlas);
+
+    // ----- HUD ----- //
+    scene.hud.initialise(scene.atlas_texture_id, scene.atlas.get_rect(ATLAS_FONT));
+}
+
+void shut_down_scene(Scene& scene)
+{
+    scene.hud.shutdown();
+    scene.effects.shutdown();
+    scene.batch.shutdown();
+    scene.level.shutdown();
+    scene.level_arena.shutdown();
+    scene.program.cleanup();
+}
+
+// The game's render(), minus the swap
+void draw_frame(Scene& scene, const World& world)
+{
+    GlState& gl = GlState::get();
+    gl.begin_frame();
+
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    const Lander& lander = world.lander;
+    scene.player.set_position(lander.position);
+    scene.player.update(0.0f, NULL, NULL, 0);
+
+    scene.camera.follow(lander.position);
+    gl.set_view_matrix(&scene.program, scene.camera.get_view_matrix());
+
+    scene.level.draw(&scene.program, scene.camera.get_min_x(), scene.camera.get_max_x());
+    scene.effects.draw(&scene.program);
+
+    scene.batch.begin(&scene.program);
+    scene.player.render(&scene.batch);
+    scene.batch.end();
+
+    gl.set_view_matrix(&scene.program, glm::mat4(1.0f));
+
+    scene.hud.draw(&scene.program, lander);
+}
+
+int main(int argc, char* argv[])
+{
+    FrameCaptureFormat format = CAPTURE_RAW;
+    int every = 1;
+    int arg = 1;
+    for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++)
+    {
+        if (strcmp(argv[arg], "--png") == 0) format = CAPTURE_PNG;
+        else if (strcmp(argv[arg], "--every") == 0 && arg + 1 < argc) every = atoi(argv[++arg]);
+        else break;
+    }
+    if (argc - arg != 2 || every < 1)
+    {
+        printf("usage: capture [--png] [--every ticks] <log> <output directory>\n");
+        return 1;
+    }
+    const char* log_path = argv[arg];
+    const char* directory = argv[arg + 1];
+
+    InputLog log;
+    if (!log.load(log_path))
+    {
+        printf("%s: could not read input log\n", log_path);
+        return 1;
+    }
+
+    OffscreenContext context;
+    if (!context.initialise())
+    {
+        printf("could not create an offscreen OpenGL context\n");
+        return 1;
+    }
+
+    FrameCapture capture;
+    if (!capture.initialise(FRAME_WIDTH, FRAME_HEIGHT, directory, format))
+    {
+        printf("could not set up the capture into %s\n", directory);
+        context.shutdown();
+        return 1;
+    }
+
+    Scene scene;
+    if (!load_atlas(scene))
+    {
+        printf("could not load the atlas\n");
+        capture.shutdown();
+        context.shutdown();
+        return 1;
+    }
+
+    // The level comes from the seed, the same draw replay_input_log() makes
+    srand(log.get_seed());
+    int level_number = rand() % 20 + 1;
+    int screen_count = log.get_screen_count();
+    Terrain terrain;
+    build_wide_terrain(terrain, screen_count, level_number);
+
+    set_up_scene(scene, terrain, level_number, screen_count);
+
+    World world;
+    reset_world(world, &scene.level.get_terrain(), screen_count);
+
+    InputLogCursor cursor;
+    InputRecord record;
+    bool pending = log.next_record(cursor, record);
+
+    auto start = std::chrono::steady_clock::now();
+    int frames = 0;
+
+    while (true)
+    {
+        while (pending && record.tick == world.tick)
+        {
+            apply_input(world, record.input);
+            pending = log.next_record(cursor, record);
+        }
+
+        if (world.tick % every == 0)
+        {
+            // As the game spawns them, stepped by the ticks since the last frame
+            float frame_time = frames > 0 ? every * FIXED_TIMESTEP : 0.0f;
+            scene.effects.update(world.lander, world.lander.position, world.thrusting, *world.terrain, frame_time);
+
+            capture.begin_frame();
+            draw_frame(scene, world);
+            capture.end_frame();
+            frames++;
+        }
+
+        if (world.tick >= log.get_end_tick()) break;
+        tick_world(world);
+    }
+
+    capture.finish();
+    GlState::get().begin_frame();
+    double render_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    capture.shutdown();
+    double total_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FrameCaptureStats stats = capture.get_stats();
+    bool match = hash_world(world) == log.get_final_hash();
+
+    printf("%s: seed %u, %u ticks, final state %s\n", log_path, log.get_seed(), world.tick,
+        match ? "matches the recording" : "DOES NOT MATCH the recording");
+    printf("renderer:       %s\n", context.get_renderer());
+    printf("frames:         %d written, %d failed, %d x %d at %.0f fps (%s)\n", stats.written, stats.failed,
+        FRAME_WIDTH, FRAME_HEIGHT, 1.0 / (every * FIXED_TIMESTEP), format == CAPTURE_PNG ? "png" : "raw rgba");
+    printf("rendering:      %.3f s, %.1f frames/second\n", render_seconds, frames / render_seconds);
+    printf("readback:       %.3f ms mean, %.3f ms max per frame, %d of %d maps stalled\n",
+        stats.readback_ms / stats.captured, stats.max_readback_ms, stats.readback_stalls, stats.captured);
+    printf("writer:         %.3f ms per frame, %.1f MB; the renderer waited on it %d times (%.1f ms)\n",
+        stats.write_ms / stats.captured, stats.bytes_written / (1024.0 * 1024.0), stats.writer_waits, stats.writer_wait_ms);
+    printf("total:          %.3f s including the last writes\n", total_seconds);
+
+    const GlStateStats& gl = GlState::get().get_stats();
+    printf("gl state:       %d calls issued and %d elided for %d draws in the last frame\n", gl.get_issued(),
+        gl.get_elided(), gl.draw_calls);
+
+    shut_down_scene(scene);
+    context.shutdown();
+    return match && stats.failed == 0 ? 0 : 1;
+}
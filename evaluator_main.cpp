@@ -0,0 +1,147 @@
+/**
+* Monte Carlo landing evaluator.
+*
+* Flies millions of episodes on every core, each over a random pad from a
+* random start, with a chosen controller and set of tuning constants, and
+* reports how often they land, crash-land, hit rock, time out and run out
+* of fuel. The numbers only depend on the seed, never on the thread count.
+* With --scaling the same evaluation is repeated on 1, 2, 4 ... N threads
+* to show how throughput scales and to check that every run agrees.
+* --step-ticks 6 flies 0.1 s physics steps instead of 60 Hz ticks (see
+* step_world), about four times as fast; the controller then decides once a
+* step. swept_collision_bench measures how far that moves the results.
+* --decision-ticks N holds each decision for N ticks whatever the step.
+*
+*   evaluator [--episodes N] [--controller autopilot|random|idle] [--seed N]
+*             [--threads N] [--max-ticks N] [--decision-ticks N]
+*             [--step-ticks N] [--scaling]
+*             [--lateral-cost F] [--thrust-cost F] [--lateral-accel F]
+*             [--thrust-accel F] [--fuel F]
+*
+* Builds from Simulation.cpp, Terrain.cpp, Evaluator.cpp and JobSystem.cpp
+* (no SDL or OpenGL); link with -pthread.
+**/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Evaluator.h"
+#include "JobSystem.h"
+
+static void print_result(const EvaluationResult& result)
+{
+    double episodes = (double)result.episodes;
+    printf("episodes:       %lld\n", result.episodes);
+    printf("landed:         %6.2f%%\n", 100.0 * result.landed / episodes);
+    printf("crash-landed:   %6.2f%%\n", 100.0 * result.crash_landed / episodes);
+    printf("hit rock:       %6.2f%%\n", 100.0 * result.hit / episodes);
+    printf("timed out:      %6.2f%%\n", 100.0 * result.timed_out / episodes);
+    printf("fuel ran out:   %6.2f%%\n", 100.0 * result.fuel_out / episodes);
+    printf("mean ticks:     %.1f\n", result.ticks / episodes);
+    printf("mean fuel left: %.3f\n", result.fuel_left / episodes);
+
+    double touched_down = episodes - result.timed_out;
+    if (touched_down > 0.0)
+    {
+        printf("mean impact:    %.4f m/s after %.4f s\n", result.impact_speed / touched_down,
+            result.contact_time / touched_down);
+    }
+}
+
+static bool same_outcomes(const EvaluationResult& a, const EvaluationResult& b)
+{
+    return a.landed == b.landed && a.crash_landed == b.crash_landed && a.hit == b.hit &&
+        a.timed_out == b.timed_out && a.fuel_out == b.fuel_out && a.ticks == b.ticks &&
+        memcmp(&a.fuel_left, &b.fuel_left, sizeof(double)) == 0 &&
+        memcmp(&a.impact_speed, &b.impact_speed, sizeof(double)) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    EvaluationConfig config;
+    config.seed = 1;
+    config.episode_count = 1000000;
+    config.max_ticks = 60 * 60;         // a minute of flight
+    config.decision_ticks = 1;
+    config.step_ticks = 1;
+    config.tuning = DEFAULT_TUNING;
+    config.controller = find_controller("autopilot");
+
+    int thread_count = get_core_count();
+    bool scaling = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* option = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(option, "--scaling") == 0) { scaling = true; continue; }
+        if (!value) { printf("%s needs a value\n", option); return 1; }
+        i++;
+
+        if (strcmp(option, "--episodes") == 0) config.episode_count = atoll(value);
+        else if (strcmp(option, "--seed") == 0) config.seed = strtoull(value, NULL, 10);
+        else if (strcmp(option, "--threads") == 0) thread_count = atoi(value);
+        else if (strcmp(option, "--max-ticks") == 0) config.max_ticks = atoi(value);
+        else if (strcmp(option, "--decision-ticks") == 0) config.decision_ticks = atoi(value);
+        else if (strcmp(option, "--step-ticks") == 0) config.step_ticks = atoi(value);
+        else if (strcmp(option, "--lateral-cost") == 0) config.tuning.lateral_fuel_cost = (float)atof(value);
+        else if (strcmp(option, "--thrust-cost") == 0) config.tuning.thrust_fuel_cost = (float)atof(value);
+        else if (strcmp(option, "--lateral-accel") == 0) config.tuning.lateral_acceleration = (float)atof(value);
+        else if (strcmp(option, "--thrust-accel") == 0) config.tuning.thrust_acceleration = (float)atof(value);
+        else if (strcmp(option, "--fuel") == 0) config.tuning.starting_fuel = (float)atof(value);
+        else if (strcmp(option, "--controller") == 0)
+        {
+            config.controller = find_controller(value);
+            if (!config.controller) { printf("unknown controller %s\n", value); return 1; }
+        }
+        else { printf("unknown option %s\n", option); return 1; }
+    }
+
+    if (config.step_ticks < 1) config.step_ticks = 1;
+    if (config.decision_ticks < config.step_ticks) config.decision_ticks = config.step_ticks;
+
+    printf("controller %s every %d ticks in %d-tick steps, seed %llu, lateral %.3f/%.4f, thrust %.3f/%.4f (accel/fuel per tick), fuel %.1f\n",
+        config.controller->name, config.decision_ticks, config.step_ticks, (unsigned long long)config.seed,
+        config.tuning.lateral_acceleration, config.tuning.lateral_fuel_cost,
+        config.tuning.thrust_acceleration, config.tuning.thrust_fuel_cost, config.tuning.starting_fuel);
+
+    if (!scaling)
+    {
+        EvaluationResult result = evaluate(config, thread_count);
+        print_result(result);
+        printf("%d threads:     %.0f ms, %.2fM episodes/s, %d steals\n", result.thread_count, result.run_ms,
+            result.episodes / result.run_ms / 1000.0, result.steals);
+        return 0;
+    }
+
+    // ----- SCALING ----- //
+    EvaluationResult first = {};
+    double single_ms = 0.0;
+    bool identical = true;
+
+    printf("%8s %10s %14s %10s %10s %8s\n", "threads", "ms", "episodes/s", "speed-up", "efficiency", "steals");
+
+    for (int threads = 1; ; threads *= 2)
+    {
+        if (threads > thread_count) threads = thread_count;
+
+        EvaluationResult result = evaluate(config, threads);
+        if (threads == 1)
+        {
+            first = result;
+            single_ms = result.run_ms;
+        }
+        else if (!same_outcomes(first, result)) identical = false;
+
+        double speed_up = single_ms / result.run_ms;
+        printf("%8d %10.0f %14.0f %9.2fx %9.0f%% %8d%s\n", threads, result.run_ms,
+            result.episodes / result.run_ms * 1000.0, speed_up, 100.0 * speed_up / threads, result.steals,
+            threads > 1 && !same_outcomes(first, result) ? "  RESULTS DIFFER" : "");
+
+        if (threads == thread_count) break;
+    }
+
+    print_result(first);
+    printf("results %s across thread counts\n", identical ? "identical" : "DIFFER");
+    return identical ? 0 : 1;
+}
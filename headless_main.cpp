@@ -0,0 +1,127 @@
+/**
+* Headless lander simulation.
+*
+* Builds from Simulation.cpp, Terrain.cpp and InputLog.cpp alone (no SDL,
+* SDL_mixer or OpenGL) and steps
+* the fixed-timestep world as fast as the CPU allows instead of waiting on
+* SDL_GetTicks. A simple autopilot flies the lander; whenever a flight ends
+* a new one starts over a random pad. With step_ticks above 1 it flies
+* physics steps that many ticks long (see step_world), deciding once a
+* step: 6 flies 0.1 s steps.
+*
+* With --replay it instead flies input logs recorded by the game, printing
+* the state hash after every tick (or only the final one with --summary)
+* and checking the final hash against the one the game recorded.
+*
+*   headless [tick_count] [seed] [step_ticks]
+*   headless --replay [--summary] <log>...
+**/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Simulation.h"
+#include "InputLog.h"
+
+// Keep the descent under the landing limit and drift towards the pad
+TickInput autopilot(const World& world)
+{
+    const Lander& lander = world.lander;
+    float pad_x = world.terrain->get_pad_center_x(0);
+
+    TickInput input;
+    input.left = lander.position.x > pad_x + 0.1f && lander.velocity.x > -0.5f;
+    input.right = lander.position.x < pad_x - 0.1f && lander.velocity.x < 0.5f;
+    input.up = lander.velocity.y < LANDING_SPEED_LIMIT * 0.5f;
+    return input;
+}
+
+int replay(int argc, char* argv[])
+{
+    bool summary = false;
+    int first_log = 0;
+    if (first_log < argc && strcmp(argv[first_log], "--summary") == 0)
+    {
+        summary = true;
+        first_log++;
+    }
+
+    Terrain terrain;
+    World world;
+    InputLog log;
+
+    int mismatches = 0, failures = 0;
+    long long total_ticks = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = first_log; i < argc; i++)
+    {
+        if (!log.load(argv[i]))
+        {
+            printf("%s: could not read input log\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        uint64_t hash = replay_input_log(log, terrain, world, summary ? NULL : stdout);
+        bool match = hash == log.get_final_hash();
+        if (!match) mismatches++;
+        total_ticks += world.tick;
+
+        printf("%s: seed %u, %u ticks, %u inputs, final %016llx %s\n", argv[i], log.get_seed(), world.tick,
+            log.get_record_count(), (unsigned long long)hash, match ? "matches" : "DOES NOT MATCH the recording");
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("replayed %d logs, %lld ticks in %.3f s; %d mismatched, %d unreadable\n",
+        argc - first_log, total_ticks, seconds, mismatches, failures);
+
+    return mismatches || failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--replay") == 0) return replay(argc - 2, argv + 2);
+
+    long long tick_count = argc > 1 ? atoll(argv[1]) : 10000000;
+    unsigned seed = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : 1;
+    int step_ticks = argc > 3 ? atoi(argv[3]) : 1;
+    if (step_ticks < 1) step_ticks = 1;
+
+    srand(seed);
+
+    Terrain terrain;
+    build_classic_terrain(terrain, rand() % 20 + 1);
+
+    World world;
+    reset_world(world, &terrain);
+
+    long long flights = 0, landed = 0, crash_landed = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (long long tick = 0; tick < tick_count; tick += step_ticks)
+    {
+        step_world(world, autopilot(world), step_ticks);
+
+        if (world.lander.is_winner || world.lander.is_loser)
+        {
+            flights++;
+            if (world.lander.is_winner) landed++;
+            if (world.lander.crash_land) crash_landed++;
+            build_classic_terrain(terrain, rand() % 20 + 1);
+            reset_world(world, &terrain);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("ticks:          %lld in %d-tick steps\n", tick_count, step_ticks);
+    printf("seconds:        %.3f\n", seconds);
+    printf("ticks/second:   %.0f\n", seconds > 0.0 ? tick_count / seconds : 0.0);
+    printf("sim speed-up:   %.0fx real time\n", seconds > 0.0 ? tick_count * FIXED_TIMESTEP / seconds : 0.0);
+    printf("flights:        %lld (landed %lld, crash-landed %lld)\n", flights, landed, crash_landed);
+
+    return 0;
+}
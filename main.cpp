@@ -11,8 +11,6 @@
 #define STB_IMAGE_IMPLEMENTATION
 #define LOG(argument) std::cout << argument << '\n'
 #define GL_GLEXT_PROTOTYPES 1
-#define FIXED_TIMESTEP 0.0166666f
-#define PLATFORM_COUNT 21
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
@@ -29,15 +27,47 @@
 #include <ctime>
 #include <vector>
 #include <cstdlib>
+#include <cstring>
 #include "Entity.h"
+#include "EntityPool.h"
+#include "GlState.h"
+#include "ParticleSystem.h"
+#include "BakedLevel.h"
+#include "Simulation.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "HudText.h"
+#include "InputLog.h"
+#include "Profiler.h"
+#include "SimThread.h"
+#include "AssetLoader.h"
+#include "AssetPack.h"
+#include "GameAssets.h"
+#include "JobSystem.h"
+#include "FrameCapture.h"
+#include "FlightScene.h"
+#include "Camera.h"
+#include "SpatialGrid.h"
 #include <string>
 
 //  STRUCTS AND ENUMS  //
 struct GameState
 {
-    Entity* player;
-    Entity* platforms;
-    Entity* flame;
+    // Simulation: a copy of world is a complete snapshot (see Snapshot.h).
+    // world.terrain points at the level's baked terrain.
+    BakedLevel level;
+    World world;
+
+    // Drawing only, synced from world every frame
+    Entity player;
+
+    // Exhaust, dust and debris, spawned from what the frame's snapshot shows
+    FlightEffects effects;
+
+    // The level's static blocks, the source of its bake; their storage
+    // lives in level_arena
+    Arena level_arena;
+    EntityPool blocks;
     bool game_is_running;
 };
 
@@ -45,37 +75,36 @@ struct GameState
 constexpr int WINDOW_WIDTH = 800,        //640 x 480
 WINDOW_HEIGHT = 600;
 
-constexpr float BG_RED = 0.0f,
-BG_GREEN = 0.0f,
-BG_BLUE = 0.5f,   //0.549f
-BG_OPACITY = 1.0f;
-
 constexpr int VIEWPORT_X = 0,
 VIEWPORT_Y = 0,
 VIEWPORT_WIDTH = WINDOW_WIDTH,
 VIEWPORT_HEIGHT = WINDOW_HEIGHT;
 
-constexpr char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
-
 constexpr float MILLISECONDS_IN_SECOND = 1000.0;
-constexpr char SPRITESHEET_FILEPATH[] = "assets/lunarLander.png";
-constexpr char BLOCK_FILEPATH[] = "assets/block.png";
-constexpr char PLATFORM_FILEPATH[] = "assets/platform.png";
-constexpr char FONTSHEET_FILEPATH[] = "assets/font1.png";
-constexpr char FLAME_FILEPATH[] = "assets/flame.png";
+constexpr char ATLAS_CACHE_FILEPATH[] = "assets/atlas.cache";
+constexpr char LEVEL_BAKE_FILEPATH[] = "assets/level_%02d.bake",    // by level number
+WIDE_LEVEL_BAKE_FILEPATH[] = "assets/level_%02d_x%d.bake";          // and screen count
 
-constexpr int NUMBER_OF_TEXTURES = 1;
-constexpr GLint LEVEL_OF_DETAIL = 0;
-constexpr GLint TEXTURE_BORDER = 0;
+// Replay with: headless --replay last_flight.input
+constexpr char INPUT_LOG_FILEPATH[] = "last_flight.input";
+
+#ifdef LUNAR_PROFILE
+constexpr char PROFILE_CSV_FILEPATH[] = "profile.csv",
+PROFILE_TRACE_FILEPATH[] = "profile_trace.json";
+#endif
+
+// Drawn in place of the atlas while it loads
+constexpr unsigned PLACEHOLDER_COLOUR = 0x808080FF;
+// GL-thread time per frame for finishing loaded assets
+constexpr double ASSET_UPLOAD_BUDGET_MS = 2.0;
+
+// Seconds; longer frames (a stall, a drag) step the particles this far only
+constexpr float MAX_PARTICLE_STEP = 0.1f;
 
 constexpr int CD_QUAL_FREQ = 44100,
 AUDIO_CHAN_AMT = 2,     // stereo
 AUDIO_BUFF_SIZE = 4096;
 
-constexpr char BGM_FILEPATH[] = "assets/crypto.mp3",
-SFX_FILEPATH[] = "assets/bounce.wav";
-
 constexpr int PLAY_ONCE = 0,    // play once, loop never
 NEXT_CHNL = -1,   // next available channel
 ALL_SFX_CHNL = -1;
@@ -93,113 +122,286 @@ bool g_game_is_running = true;
 ShaderProgram g_program;
 glm::mat4 g_view_matrix, g_projection_matrix;
 
-float g_previous_ticks = 0.0f;
-float g_accumulator = 0.0f;
+SpriteBatch g_sprite_batch;
+TextureAtlas g_atlas;
+InputLog g_input_log;
 
-constexpr int FONTBANK_SIZE = 16;
+// With --screens, the world is that many screens wide
+int g_screen_count = 1;
+Camera g_camera;
+SpatialGrid g_block_grid;       // over g_state.blocks, for drawing them before the bake
+int g_blocks_drawn = 0;
 
-GLuint g_font_texture_id;
+// Laid out once the atlas, which holds the font, is in
+FlightHud g_hud;
 
-bool thrusting = false;
+// The fixed-step simulation runs on its own thread; a frame draws the newest snapshot it published
+SimThread g_sim_thread;
+RenderSnapshot g_snapshot;
+
+// SDL stamps events in milliseconds since SDL_Init; this is that moment on sim_clock_ns()
+uint64_t g_sdl_epoch_ns = 0;
+
+// Main-thread utilisation: time since the loop started vs. time spent blocked in the swap
+Uint64 g_loop_start = 0,
+g_swap_wait = 0;
+
+GLuint g_font_texture_id;
+UvRect g_font_rect;
+
+// Assets load on worker threads while the first frames draw placeholders;
+// the GL thread finishes whatever is ready between frames
+AssetLoader g_assets;
+AssetPack g_asset_pack;
+const char* g_atlas_origin = "decoded and packed";
+GLuint g_placeholder_texture_id;
+int g_atlas_source_indices[ATLAS_SPRITE_COUNT];     // decode task contexts
+int g_atlas_decodes_left = 0;
+bool g_atlas_cached = false,
+g_assets_ready = false,
+g_startup_reported = false;
+
+int g_level_number;
+
+uint64_t g_last_particle_ns = 0;
+
+// With --capture, frames are drawn into g_capture's framebuffer, copied
+// onto the window and streamed to disk (see FrameCapture.h)
+FrameCapture g_capture;
+bool g_capturing = false;
+
+// Startup timing, from just after SDL_Init
+Uint64 g_startup_counter = 0;
+float g_first_frame_ms = -1.0f,
+g_loaded_ms = -1.0f;
 
 //  GENERAL FUNCTIONS  //
-GLuint load_texture(const char* filepath)
+void draw_text(ShaderProgram* shader_program, GLuint font_texture_id, std::string text,
+    float font_size, float spacing, glm::vec3 position, const UvRect& font_rect = FULL_TEXTURE)
 {
-    int width, height, number_of_components;
-    unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+    // The quads are laid out on the CPU (see HudText.cpp), then drawn straight from client memory
+    std::vector<float> vertices;
+    std::vector<float> texture_coordinates;
+    build_text_vertices(vertices, texture_coordinates, text, font_size, spacing, font_rect);
+
+    // And render all of them using the pairs
+    glm::mat4 model_matrix = glm::mat4(1.0f);
+    model_matrix = glm::translate(model_matrix, position);
+
+    GlState& gl = GlState::get();
+    gl.set_model_matrix(shader_program, model_matrix);
+    gl.bind_array_buffer(0);
 
-    if (image == NULL)
+    glVertexAttribPointer(shader_program->get_position_attribute(), 2, GL_FLOAT, false, 0,
+        vertices.data());
+    glVertexAttribPointer(shader_program->get_tex_coordinate_attribute(), 2, GL_FLOAT,
+        false, 0, texture_coordinates.data());
+    gl.enable_sprite_attribs(shader_program);
+
+    gl.bind_texture(font_texture_id);
+    gl.draw_arrays(GL_TRIANGLES, 0, (int)(text.size() * 6));
+}
+
+#ifdef LUNAR_PROFILE
+// One line per timed scope, min / avg / p99 in milliseconds over the last few seconds
+void draw_profiler_overlay()
+{
+    Profiler& profiler = Profiler::get();
+    profiler.collect();
+
+    char line[96];
+    const ParticleStats& particles = g_state.effects.get_stats();
+    snprintf(line, sizeof(line), "particles %6d live %6.3f update %6.3f build", particles.live, particles.update_ms, particles.build_ms);
+    draw_text(&g_program, g_font_texture_id, line, 0.15f, 0.0f, glm::vec3(-4.8f, -0.6f, 0.0f), g_font_rect);
+
+    snprintf(line, sizeof(line), "level %d of %d blocks drawn, camera at %.1f", g_blocks_drawn,
+        g_state.blocks.get_count(), g_camera.get_x());
+    draw_text(&g_program, g_font_texture_id, line, 0.15f, 0.0f, glm::vec3(-4.8f, -0.4f, 0.0f), g_font_rect);
+
+    const GlStateStats& gl = GlState::get().get_stats();
+    snprintf(line, sizeof(line), "gl %4d issued %4d elided %3d draws%s", gl.get_issued(), gl.get_elided(), gl.draw_calls,
+        GlState::get().is_caching() ? "" : " (cache off)");
+    draw_text(&g_program, g_font_texture_id, line, 0.15f, 0.0f, glm::vec3(-4.8f, -0.2f, 0.0f), g_font_rect);
+
+    draw_text(&g_program, g_font_texture_id, "scope           min    avg    p99", 0.15f, 0.0f,
+        glm::vec3(-4.8f, -0.8f, 0.0f), g_font_rect);
+
+    for (int i = 0; i < profiler.get_scope_count(); i++)
     {
-        LOG("Unable to load image. Make sure the path is correct.");
-        assert(false);
+        ProfileSummary summary;
+        profiler.get_summary(i, summary);
+
+        snprintf(line, sizeof(line), "%-13s %6.3f %6.3f %6.3f", summary.name, summary.min_ms, summary.avg_ms, summary.p99_ms);
+        draw_text(&g_program, g_font_texture_id, line, 0.15f, 0.0f,
+            glm::vec3(-4.8f, -1.0f - 0.2f * i, 0.0f), g_font_rect);
     }
+}
+#endif
+
+float milliseconds_since(Uint64 counter)
+{
+    return (float)(SDL_GetPerformanceCounter() - counter) * MILLISECONDS_IN_SECOND / SDL_GetPerformanceFrequency();
+}
 
-    GLuint textureID;
-    glGenTextures(NUMBER_OF_TEXTURES, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
+//  ASSET LOADING  //
+// Fills the blocks pool for the current level. Until the atlas is in, each
+// sprite shows the whole placeholder texture.
+void fill_level_blocks(GLuint texture_id, bool atlas_loaded)
+{
+    g_state.level_arena.rewind();
+    create_level_blocks(g_state.blocks, g_state.level_arena, g_screen_count, g_level_number, texture_id,
+        atlas_loaded ? &g_atlas : nullptr);
+    g_block_grid.build(g_state.blocks, BakedLevel::CELL_WIDTH);
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+// The blocks' vertex buffer and terrain are baked once per level and kept
+// next to the assets; the key changes whenever the atlas is repacked
+void load_level(GLuint atlas_texture_id)
+{
+    Uint64 level_start = SDL_GetPerformanceCounter();
 
+    const UvRect level_rects[2] = { g_atlas.get_rect(ATLAS_BLOCK), g_atlas.get_rect(ATLAS_PLATFORM) };
+    uint64_t level_key = BakedLevel::make_key(g_level_number, g_screen_count, level_rects, 2);
+    char level_path[64];
+    if (g_screen_count == 1) {
+        snprintf(level_path, sizeof(level_path), LEVEL_BAKE_FILEPATH, g_level_number);
+    }
+    else {
+        snprintf(level_path, sizeof(level_path), WIDE_LEVEL_BAKE_FILEPATH, g_level_number, g_screen_count);
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    bool level_cached = g_state.level.load(level_path, level_key);
+    if (!level_cached)
+    {
+        Terrain terrain;
+        build_wide_terrain(terrain, g_screen_count, g_level_number);
+        g_state.level.bake(g_state.blocks, terrain);
+        g_state.level.save(level_path, level_key);
+    }
+    g_state.level.upload(atlas_texture_id);
 
-    stbi_image_free(image);
+    LOG("Level " << g_level_number << ": " << g_state.level.get_vertex_count() << " static vertices in "
+        << milliseconds_since(level_start) << " ms (" << (level_cached ? "from " : "baked, saved to ") << level_path << ")");
+}
 
-    return textureID;
+// Worker threads: file reads, decoding and packing, no GL
+bool load_atlas_pack(void* context)
+{
+    return g_asset_pack.open(ASSET_PACK_FILEPATH) &&
+        g_atlas.load_pack(g_asset_pack, ATLAS_PACK_NAME, ATLAS_SOURCES, ATLAS_SPRITE_COUNT);
 }
 
-void draw_text(ShaderProgram* shader_program, GLuint font_texture_id, std::string text,
-    float font_size, float spacing, glm::vec3 position)
+bool load_atlas_cache(void* context)
+{
+    return g_atlas.load_cache(ATLAS_CACHE_FILEPATH, ATLAS_SOURCES, ATLAS_SPRITE_COUNT);
+}
+
+bool decode_atlas_source(void* context)
 {
-    // Scale the size of the fontbank in the UV-plane
-    // We will use this for spacing and positioning
-    float width = 1.0f / FONTBANK_SIZE;
-    float height = 1.0f / FONTBANK_SIZE;
+    return g_atlas.decode(*(const int*)context);
+}
 
-    // Instead of having a single pair of arrays, we'll have a series of pairsone for
-    // each character. Don't forget to include <vector>!
-    std::vector<float> vertices;
-    std::vector<float> texture_coordinates;
+bool pack_atlas(void* context)
+{
+    if (!g_atlas.pack()) return false;
 
-    // For every character...
-    for (int i = 0; i < text.size(); i++) {
-        // 1. Get their index in the spritesheet, as well as their offset (i.e. their
-        //    position relative to the whole sentence)
-        int spritesheet_index = (int)text[i];  // ascii value of character
-        float offset = (font_size + spacing) * i;
-
-        // 2. Using the spritesheet index, we can calculate our U- and V-coordinates
-        float u_coordinate = (float)(spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
-        float v_coordinate = (float)(spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
-
-        // 3. Inset the current pair in both vectors
-        vertices.insert(vertices.end(), {
-            offset + (-0.5f * font_size), 0.5f * font_size,
-            offset + (-0.5f * font_size), -0.5f * font_size,
-            offset + (0.5f * font_size), 0.5f * font_size,
-            offset + (0.5f * font_size), -0.5f * font_size,
-            offset + (0.5f * font_size), 0.5f * font_size,
-            offset + (-0.5f * font_size), -0.5f * font_size,
-            });
-
-        texture_coordinates.insert(texture_coordinates.end(), {
-            u_coordinate, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate + width, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            });
+    g_atlas.save_cache(ATLAS_CACHE_FILEPATH);
+    return true;
+}
+
+// GL thread: everything that needs the atlas's texture or its UVs
+void on_atlas_ready(bool ok, void* context)
+{
+    if (!ok)
+    {
+        LOG("Unable to load image. Make sure the path is correct.");
+        assert(false);
+        g_game_is_running = false;
+        return;
     }
 
-    // 4. And render all of them using the pairs
-    glm::mat4 model_matrix = glm::mat4(1.0f);
-    model_matrix = glm::translate(model_matrix, position);
+    // The atlas binds its texture itself (the asset packer shares the code
+    // and has no GL state to track)
+    GLuint atlas_texture_id = g_atlas.upload();
+    GlState::get().invalidate();
+    LOG("Textures: " << g_atlas.get_width() << "x" << g_atlas.get_height() << " atlas (" << g_atlas_origin << ")");
 
-    shader_program->set_model_matrix(model_matrix);
-    glUseProgram(shader_program->get_program_id());
+    fill_level_blocks(atlas_texture_id, true);
+    load_level(atlas_texture_id);
 
-    glVertexAttribPointer(shader_program->get_position_attribute(), 2, GL_FLOAT, false, 0,
-        vertices.data());
-    glEnableVertexAttribArray(shader_program->get_position_attribute());
+    // ----- FONT ----- //
+    g_font_texture_id = atlas_texture_id;
+    g_font_rect = g_atlas.get_rect(ATLAS_FONT);
 
-    glVertexAttribPointer(shader_program->get_tex_coordinate_attribute(), 2, GL_FLOAT,
-        false, 0, texture_coordinates.data());
-    glEnableVertexAttribArray(shader_program->get_tex_coordinate_attribute());
+    g_hud.initialise(g_font_texture_id, g_font_rect);
+
+    g_state.player.set_texture_id(atlas_texture_id);
+    g_state.player.set_uv_rect(g_atlas.get_rect(ATLAS_LANDER));
+
+    g_state.effects.set_sprites(atlas_texture_id, g_atlas);
+
+    // The flight starts here, from the state the placeholder frames showed
+    reset_world(g_state.world, &g_state.level.get_terrain(), g_screen_count);
+    g_sim_thread.start(&g_state.world, &g_input_log);
+    g_snapshot = g_sim_thread.read_latest();
+
+    g_assets_ready = true;
+    g_loaded_ms = milliseconds_since(g_startup_counter);
+}
+
+void on_atlas_source_decoded(bool ok, void* context)
+{
+    // A failed decode makes the pack fail, which reports it
+    if (--g_atlas_decodes_left == 0) g_assets.submit(pack_atlas, on_atlas_ready, NULL);
+}
+
+void on_atlas_cache_loaded(bool ok, void* context)
+{
+    g_atlas_cached = ok;
+    if (ok)
+    {
+        g_atlas_origin = "from cache";
+        on_atlas_ready(true, NULL);
+        return;
+    }
+
+    // Missing or stale: every image decodes on its own worker, then one packs them
+    g_atlas.begin_build(ATLAS_SOURCES, ATLAS_SPRITE_COUNT);
+    g_atlas_decodes_left = ATLAS_SPRITE_COUNT;
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+    {
+        g_assets.submit(decode_atlas_source, on_atlas_source_decoded, &g_atlas_source_indices[i]);
+    }
+}
 
-    glBindTexture(GL_TEXTURE_2D, font_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, (int)(text.size() * 6));
+void on_atlas_pack_loaded(bool ok, void* context)
+{
+    if (ok)
+    {
+        g_atlas_cached = true;
+        g_atlas_origin = "from the asset pack";
+        on_atlas_ready(true, NULL);
+        return;
+    }
+
+    // No pack (or one built from other images): the loose files
+    g_assets.submit(load_atlas_cache, on_atlas_cache_loaded, NULL);
+}
 
-    glDisableVertexAttribArray(shader_program->get_position_attribute());
-    glDisableVertexAttribArray(shader_program->get_tex_coordinate_attribute());
+void report_startup()
+{
+    AssetLoaderStats stats = g_assets.get_stats();
+    LOG("Startup (" << (g_atlas_cached ? "warm" : "cold") << ", atlas " << g_atlas_origin << "): first frame after " << g_first_frame_ms
+        << " ms, fully loaded after " << g_loaded_ms << " ms; " << stats.work_ms << " ms of loading on "
+        << stats.thread_count << " workers, " << stats.ready_ms << " ms finishing it on the GL thread (longest step "
+        << stats.longest_ready_ms << " ms)");
 }
 
-void initialise()
+void initialise(const char* capture_directory, FrameCaptureFormat capture_format)
 {
     SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
+    g_startup_counter = SDL_GetPerformanceCounter();
+    g_sdl_epoch_ns = sim_clock_ns() - (uint64_t)SDL_GetTicks() * 1000000;
     g_display_window = SDL_CreateWindow("Hello, Physics (again)!",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
         WINDOW_WIDTH, WINDOW_HEIGHT,
@@ -218,63 +420,65 @@ void initialise()
     g_program.load(V_SHADER_PATH, F_SHADER_PATH);
 
     g_view_matrix = glm::mat4(1.0f);
-    g_projection_matrix = glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
+    g_projection_matrix = glm::ortho(-VIEW_HALF_WIDTH, VIEW_HALF_WIDTH, -VIEW_HALF_HEIGHT, VIEW_HALF_HEIGHT, -1.0f, 1.0f);
 
-    g_program.set_projection_matrix(g_projection_matrix);
-    g_program.set_view_matrix(g_view_matrix);
+    set_up_camera(g_camera, g_screen_count);
 
-    glUseProgram(g_program.get_program_id());
+    GlState& gl = GlState::get();
+    gl.use_program(&g_program);
+    gl.set_projection_matrix(&g_program, g_projection_matrix);
+    gl.set_view_matrix(&g_program, g_view_matrix);
 
     glClearColor(BG_RED, BG_GREEN, BG_BLUE, BG_OPACITY);
 
-    //  PLATFORMS  //
-    GLuint block_texture_id = load_texture(BLOCK_FILEPATH);
-    GLuint platform_texture_id = load_texture(PLATFORM_FILEPATH);
+    if (capture_directory != NULL) {
+        g_capturing = g_capture.initialise(WINDOW_WIDTH, WINDOW_HEIGHT, capture_directory, capture_format);
+        if (g_capturing) LOG("Capturing every frame to " << capture_directory);
+        else LOG("Unable to capture to " << capture_directory << ". Make sure the directory exists.");
+    }
 
-    g_state.platforms = new Entity[PLATFORM_COUNT];
+    // The lander, plus the platforms until the level is baked
+    g_sprite_batch.initialise(PLATFORM_COUNT + 1);
 
-    // Seed the random number generator with the current time
-    srand(static_cast<unsigned>(time(0)));
+    g_state.effects.initialise();
 
-    // Generate a random number between 1 and 21
-    int random_number = rand() % 20 + 1;
-    // Set the type of every platform entity to PLATFORM
-    for (int i = 0; i < PLATFORM_COUNT; i++)
-    {
-        if (i == random_number) {
-            g_state.platforms[i].setPlatform();
-            g_state.platforms[i].set_texture_id(platform_texture_id);
-            g_state.platforms[i].set_position(glm::vec3((i - PLATFORM_COUNT / 2.0) * 0.5, -3.5f, 0.0f));
-            g_state.platforms[i].set_width(0.5f);
-            g_state.platforms[i].set_height(0.5f);
-            g_state.platforms[i].set_entity_type(PLATFORM);
-            g_state.platforms[i].update(0.0f, NULL, NULL, 0);
-            g_state.platforms[i].set_width(g_state.platforms[i].get_width() * 0.5f);
-            g_state.platforms[i].set_height(g_state.platforms[i].get_height() * 0.67f);
-        }
-        else {
-            g_state.platforms[i].set_texture_id(block_texture_id);
-            g_state.platforms[i].set_position(glm::vec3((i - PLATFORM_COUNT / 2.0) * 0.5, -3.5f, 0.0f));
-            g_state.platforms[i].set_width(0.5f);
-            g_state.platforms[i].set_height(0.5f);
-            g_state.platforms[i].set_entity_type(PLATFORM);
-            g_state.platforms[i].update(0.0f, NULL, NULL, 0);
-            g_state.platforms[i].set_width(g_state.platforms[i].get_width() * 0.5f);
-            g_state.platforms[i].set_height(g_state.platforms[i].get_height() * 0.5f);
-        }
+    // ----- TEXTURES ----- //
+    // The atlas loads on worker threads: from the asset pack if there is one,
+    // else from its cache while that is still valid, else by decoding and
+    // packing the PNGs. on_atlas_ready() finishes the setup here. Until then frames draw a flat placeholder
+    // and the simulation waits.
+    g_placeholder_texture_id = create_placeholder_texture(PLACEHOLDER_COLOUR);
 
-    }
-    // ----- FONT ----- //
-    g_font_texture_id = load_texture(FONTSHEET_FILEPATH);
+    int core_count = get_core_count();
+    g_assets.initialise(core_count > 1 ? core_count - 1 : 1);
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++) g_atlas_source_indices[i] = i;
+    g_assets.submit(load_atlas_pack, on_atlas_pack_loaded, NULL);
 
-    //  PLAYER (GEORGE)  //
-    GLuint player_texture_id = load_texture(SPRITESHEET_FILEPATH);
+    //  PLATFORMS  //
+    // Seed the random number generator with the current time, and keep the seed so the flight can be replayed
+    unsigned seed = static_cast<unsigned>(time(0));
+    srand(seed);
+    g_input_log.begin(seed, g_screen_count);
 
+    // Generate a random number between 1 and 21
+    g_level_number = rand() % 20 + 1;
+    // One body and sprite per block. Everything the level allocates comes
+    // out of level_arena, so a new level starts with a single rewind.
+    g_state.level_arena.initialise(EntityPool::get_arena_bytes(PLATFORM_COUNT * g_screen_count));
+    fill_level_blocks(g_placeholder_texture_id, false);
+
+    // The lander waits at its start position until the simulation begins
+    reset_world(g_state.world, NULL, g_screen_count);
+    g_snapshot = RenderSnapshot();
+    g_snapshot.lander = g_state.world.lander;
+    g_snapshot.previous_position = g_state.world.previous_position;
+
+    //  PLAYER (GEORGE)  //
     glm::vec3 acceleration = glm::vec3(0.0f, -9.8f, 0.0f);
 
 
-    g_state.player = new Entity(
-        player_texture_id,         // texture
+    g_state.player = Entity(
+        g_placeholder_texture_id,  // texture
         5.0f,                      // speed
         acceleration,
         0.75f,                      // width
@@ -282,13 +486,7 @@ void initialise()
         PLAYER
     );
 
-    g_state.player->set_position(glm::vec3(0.0f, 3.0f, 0.0f));
-
-    g_state.flame = new Entity();
-    GLuint flame_texture_id = load_texture(FLAME_FILEPATH);
-    g_state.flame->set_texture_id(flame_texture_id);
-    g_state.flame->set_width(0.25f);  // Adjust size as needed
-    g_state.flame->set_height(0.25f);
+    g_state.player.set_position(glm::vec3(0.0f, 3.0f, 0.0f));
 
 
     //  GENERAL  //
@@ -298,9 +496,32 @@ void initialise()
     GLuint g_font_texture_id;
 }
 
+// Hands a press or release of a flight key to the simulation thread, stamped
+// with when SDL saw it, so it lands on the tick it happened in
+void queue_key_event(const SDL_KeyboardEvent& key, bool pressed)
+{
+    // Keys do nothing until the flight starts
+    if (key.repeat || !g_assets_ready) return;
+
+    KeyEvent event;
+    switch (key.keysym.scancode) {
+    case SDL_SCANCODE_LEFT:  event.key = KEY_LEFT;  break;
+    case SDL_SCANCODE_RIGHT: event.key = KEY_RIGHT; break;
+    case SDL_SCANCODE_UP:    event.key = KEY_UP;    break;
+    default:
+        return;
+    }
+    event.time_ns = g_sdl_epoch_ns + (uint64_t)key.timestamp * 1000000;
+    event.pressed = pressed;
+
+    g_sim_thread.push_event(event);
+}
+
 void process_input()
 {
-    g_state.player->set_movement(glm::vec3(0.0f));
+    PROFILE_SCOPE("process_input");
+
+    g_state.player.set_movement(glm::vec3(0.0f));
 
     SDL_Event event;
     while (SDL_PollEvent(&event))
@@ -312,7 +533,13 @@ void process_input()
             g_game_is_running = false;
             break;
 
+        case SDL_KEYUP:
+            queue_key_event(event.key, false);
+            break;
+
         case SDL_KEYDOWN:
+            queue_key_event(event.key, true);
+
             switch (event.key.keysym.sym) {
             case SDLK_q:
                 // Quit the game with a keystroke
@@ -321,9 +548,9 @@ void process_input()
 
             //case SDLK_SPACE:
             //    // Jump
-            //    if (g_state.player->get_collided_bottom())
+            //    if (g_state.player.get_collided_bottom())
             //    {
-            //        g_state.player->jump();
+            //        g_state.player.jump();
             //        Mix_PlayChannel(NEXT_CHNL, g_jump_sfx, 0);
             //    }
             //    break;
@@ -333,6 +560,11 @@ void process_input()
                 Mix_HaltMusic();
                 break;
 
+            case SDLK_g:
+                // Toggle the GL state cache, to see what it saves on the overlay
+                GlState::get().set_caching(!GlState::get().is_caching());
+                break;
+
             case SDLK_p:
                 Mix_PlayMusic(g_music, -1);
 
@@ -345,139 +577,190 @@ void process_input()
         }
     }
 
-    const Uint8* key_state = SDL_GetKeyboardState(NULL);
-
-    if (!g_state.player->get_depleted()) {
-        if (key_state[SDL_SCANCODE_LEFT])
-        {
-            g_state.player->set_fuel(g_state.player->get_fuel() - 0.0008f);
-            g_state.player->move_left();
-        }
-        else if (key_state[SDL_SCANCODE_RIGHT])
-        {
-            g_state.player->set_fuel(g_state.player->get_fuel() - 0.0008f);
-            g_state.player->move_right();
-        }
-        if (key_state[SDL_SCANCODE_UP])
-        {
-            g_state.player->set_fuel(g_state.player->get_fuel() - 0.008f);
-            g_state.player->move_up();
-            thrusting = true;
-        }
-        else {
-            thrusting = false;
-        }
-    }
-
-    if (glm::length(g_state.player->get_movement()) > 1.0f)
+    if (glm::length(g_state.player.get_movement()) > 1.0f)
     {
-        g_state.player->normalise_movement();
+        g_state.player.normalise_movement();
     }
 }
 
-void update()
+void update_particles(float delta_time)
 {
-    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
-    float delta_time = ticks - g_previous_ticks;
-    g_previous_ticks = ticks;
+    PROFILE_SCOPE("particles");
 
-    delta_time += g_accumulator;
-
-    if (delta_time < FIXED_TIMESTEP)
-    {
-        g_accumulator = delta_time;
-        return;
-    }
+    glm::vec3 position = get_render_position(g_snapshot, sim_clock_ns());
+    g_state.effects.update(g_snapshot.lander, position, g_snapshot.thrusting, g_state.level.get_terrain(), delta_time);
+}
 
-    while (delta_time >= FIXED_TIMESTEP)
-    {
-        if (g_state.player->get_fuel() <= 0.0f) {
-            g_state.player->set_fuel(0.0f);
-            g_state.player->set_depleted();
-        }
-        // for player moving off screen to the right
-        if (g_state.player->get_position().x > 5.5f) {
-            g_state.player->set_position(glm::vec3(-g_state.player->get_position().x + 0.5f, g_state.player->get_position().y, 0.0f));
-        }
-        // for player moving off screen to the left
-        if (g_state.player->get_position().x < -5.5f) {
-            g_state.player->set_position(glm::vec3(-g_state.player->get_position().x - 0.5f, g_state.player->get_position().y, 0.0f));
-        }
-        g_state.player->update(FIXED_TIMESTEP, NULL, g_state.platforms, PLATFORM_COUNT);
-        if (thrusting && !g_state.player->get_depleted()) {
-            g_state.flame->set_position(g_state.player->get_position() + glm::vec3(0.04f, -0.45f, 0.0f));
-            g_state.flame->set_velocity(glm::vec3(0.0f));  // Reset velocity
-            g_state.flame->set_acceleration(glm::vec3(0.0f));
-            g_state.flame->update(FIXED_TIMESTEP, NULL, NULL, 0);
-        }
-        delta_time -= FIXED_TIMESTEP;
+void update()
+{
+    PROFILE_SCOPE("update");
 
+    if (!g_assets_ready) {
+        g_assets.pump(ASSET_UPLOAD_BUDGET_MS);
+        if (!g_assets_ready) return;
     }
 
-    g_accumulator = delta_time;
+    // Physics, collisions and win/lose rules all live in Simulation.cpp and
+    // run on the simulation thread; the frame only picks up the latest state
+    g_snapshot = g_sim_thread.read_latest();
+
+    uint64_t now_ns = sim_clock_ns();
+    float frame_time = g_last_particle_ns != 0 ? (now_ns - g_last_particle_ns) / 1e9f : 0.0f;
+    g_last_particle_ns = now_ns;
+    update_particles(frame_time < MAX_PARTICLE_STEP ? frame_time : MAX_PARTICLE_STEP);
 }
 
 void render()
 {
+    PROFILE_SCOPE("render");
+
+    GlState& gl = GlState::get();
+    gl.begin_frame();
+
+    if (g_capturing) g_capture.begin_frame();
+
     glClear(GL_COLOR_BUFFER_BIT);
 
-    g_state.player->render(&g_program);
+    const Lander& lander = g_snapshot.lander;
 
-    if (thrusting && !g_state.player->get_depleted()) {
-        g_state.flame->render(&g_program);
-    }
+    // The entities only draw; copy the simulated position over and rebuild their model matrices.
+    // The position is blended between the last two ticks so motion stays even at any refresh rate.
+    glm::vec3 position = get_render_position(g_snapshot, sim_clock_ns());
+    g_state.player.set_position(position);
+    g_state.player.update(0.0f, NULL, NULL, 0);
 
-    for (int i = 0; i < PLATFORM_COUNT; i++) g_state.platforms[i].render(&g_program);
+    g_camera.follow(position);
+    gl.set_view_matrix(&g_program, g_camera.get_view_matrix());
+    float view_min_x = g_camera.get_min_x(),
+        view_max_x = g_camera.get_max_x();
 
-    // If no winner / loser, keep displaying stats
-    if (!g_state.player->get_is_winner() && !g_state.player->get_is_loser()) {
-        std::string fuel = std::to_string(g_state.player->get_fuel());
-        draw_text(&g_program, g_font_texture_id, "Fuel: " + fuel.substr(0, 4), 0.2f, 0.001f,
-            glm::vec3(-4.5f, 2.25f, 0.0f));
+    // One draw for the level's blocks in view, one for every particle, then
+    // one per texture for the sprites; text is drawn on top afterwards, in
+    // screen space. While the atlas loads, the unbaked blocks in view go
+    // through the batch with the placeholder and there is no text.
+    if (g_assets_ready) g_blocks_drawn = g_state.level.draw(&g_program, view_min_x, view_max_x);
 
-        std::string velocity = std::to_string(g_state.player->get_velocity().y);
-        draw_text(&g_program, g_font_texture_id, "Velocity: " + velocity.substr(0, 4), 0.2f, 0.001f,
-            glm::vec3(-4.5f, 2.5f, 0.0f));
-    }
+    g_state.effects.draw(&g_program);
 
+    g_sprite_batch.begin(&g_program);
 
-    // Check win/loss conditions
-    if (g_state.player->get_is_winner())
-    {
-        draw_text(&g_program, g_font_texture_id, "MISSION SUCCESS", 0.5f, 0.05f,
-            glm::vec3(-3.75f, 2.5f, 0.0f));
-        //g_game_is_running = false;  // Or handle win condition differently
+    if (!g_assets_ready) {
+        GridSpan span = g_block_grid.query(view_min_x, view_max_x);
+        g_state.blocks.render(&g_sprite_batch, g_block_grid.get_items() + span.first, span.count);
+        g_blocks_drawn = span.count;
     }
-    else if (g_state.player->get_is_loser())
-    {
-        draw_text(&g_program, g_font_texture_id, "MISSION FAIL", 0.5f, 0.05f,
-            glm::vec3(-3.0f, 2.5f, 0.0f));
 
-        if (g_state.player->get_crash_land()) {
-            draw_text(&g_program, g_font_texture_id, "LANDED TOO HARD", 0.4f, 0.05f,
-                glm::vec3(-3.15, 1.75, 0.0f));
-        }
-        //g_game_is_running = false;  // Or handle loss condition differently
+    g_state.player.render(&g_sprite_batch);
+
+    g_sprite_batch.end();
+
+    gl.set_view_matrix(&g_program, g_view_matrix);
+
+    if (g_assets_ready) g_hud.draw(&g_program, lander);
+
+#ifdef LUNAR_PROFILE
+    draw_profiler_overlay();
+#endif
+
+    if (g_capturing) {
+        g_capture.end_frame();
+        g_capture.blit_to_window();
     }
 
+    Uint64 swap_start = SDL_GetPerformanceCounter();
     SDL_GL_SwapWindow(g_display_window);
+    g_swap_wait += SDL_GetPerformanceCounter() - swap_start;
+
+    if (g_first_frame_ms < 0.0f) g_first_frame_ms = milliseconds_since(g_startup_counter);
+    if (g_assets_ready && !g_startup_reported) {
+        report_startup();
+        g_startup_reported = true;
+    }
 }
 
 void shutdown()
 {
-    SDL_Quit();
+    g_assets.shutdown();
+    g_asset_pack.close();
+
+    if (g_capturing) {
+        g_capture.finish();
+        g_capture.shutdown();
+
+        // Quitting before a frame was read back leaves nothing to average
+        FrameCaptureStats capture_stats = g_capture.get_stats();
+        if (capture_stats.captured > 0) {
+            LOG("Capture: " << capture_stats.written << " frames written, " << capture_stats.failed << " failed; readback "
+                << capture_stats.readback_ms / capture_stats.captured << " ms per frame on this thread ("
+                << capture_stats.readback_stalls << " stalled maps), waited " << capture_stats.writer_wait_ms
+                << " ms on the writer");
+        }
+    }
+    g_sprite_batch.shutdown();
+    g_hud.shutdown();
+    g_state.effects.shutdown();
+    g_state.level.shutdown();
+    g_state.level_arena.shutdown();
+
+    // The world belongs to this thread again from here on
+    g_sim_thread.stop();
+
+    SimThreadStats sim_stats = g_sim_thread.get_stats();
+    double loop_time = (double)(SDL_GetPerformanceCounter() - g_loop_start);
+    LOG("Main thread: " << 100.0 * (1.0 - g_swap_wait / loop_time) << "% busy, the rest waiting on the swap");
+    LOG("Simulation thread: " << 100.0 * sim_stats.busy_fraction << "% busy, " << sim_stats.ticks << " ticks, "
+        << sim_stats.snapshots << " snapshots, " << sim_stats.events_dropped << " key events dropped");
+
+    ParticleStats particle_stats = g_state.effects.get_stats();
+    if (particle_stats.frames > 0) {
+        LOG("Particles (" << ParticleSystem::get_kernel_name() << "): peak " << particle_stats.peak_live << " of "
+            << PARTICLE_CAPACITY << " live, update mean " << particle_stats.total_update_ms / particle_stats.frames
+            << " ms, max " << particle_stats.max_update_ms << " ms");
+    }
+    LOG("Input latency over " << sim_stats.key_events << " key events: mean " << sim_stats.mean_latency_ms
+        << " ms, p99 " << sim_stats.p99_latency_ms << " ms, max " << sim_stats.max_latency_ms << " ms, "
+        << sim_stats.late_events << " arrived after their tick");
+
+    g_input_log.finish(g_state.world.tick, hash_world(g_state.world));
+    if (g_input_log.save(INPUT_LOG_FILEPATH)) {
+        LOG("Input log: " << g_input_log.get_record_count() << " inputs over " << g_state.world.tick
+            << " ticks written to " << INPUT_LOG_FILEPATH);
+    }
+    if (g_state.world.dropped_time > 0.0f) {
+        LOG("Dropped " << g_state.world.dropped_time << " s of frame time after stalls");
+    }
 
-    delete[] g_state.platforms;
-    delete g_state.player;
+#ifdef LUNAR_PROFILE
+    Profiler::get().collect();
+    Profiler::get().write_csv(PROFILE_CSV_FILEPATH);
+    Profiler::get().write_trace(PROFILE_TRACE_FILEPATH);
+    LOG("Profile: " << PROFILE_CSV_FILEPATH << ", " << PROFILE_TRACE_FILEPATH
+        << " (" << Profiler::get().get_dropped() << " events dropped)");
+#endif
+    SDL_Quit();
 }
 
 //  GAME LOOP  //
+// lunar_lander [--screens <count>] [--capture <directory> [--png]]
 int main(int argc, char* argv[])
 {
-    initialise();
+    const char* capture_directory = NULL;
+    FrameCaptureFormat capture_format = CAPTURE_RAW;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) capture_directory = argv[++i];
+        else if (strcmp(argv[i], "--png") == 0) capture_format = CAPTURE_PNG;
+        else if (strcmp(argv[i], "--screens") == 0 && i + 1 < argc) g_screen_count = atoi(argv[++i]);
+    }
+    if (g_screen_count < 1) g_screen_count = 1;
+    if (g_screen_count > MAX_SCREEN_COUNT) g_screen_count = MAX_SCREEN_COUNT;
+
+    initialise(capture_directory, capture_format);
+    g_loop_start = SDL_GetPerformanceCounter();
 
     while (g_game_is_running)
     {
+        PROFILE_SCOPE("frame");
         process_input();
         update();
         render();